@@ -6,8 +6,23 @@
 
 library;
 
-export 'src/onnxruntime.dart' show OnnxRuntime;
-export 'src/ort_session.dart' show OrtSession, OrtSessionOptions, OrtRunOptions;
+export 'src/onnxruntime.dart'
+    show
+        OnnxRuntime,
+        OrtModelCacheStats,
+        OrtMemoryStats,
+        OrtMemoryUsage,
+        OrtSessionMemoryStats,
+        OrtMemoryWarning,
+        OrtTuningObjective,
+        OrtTuningMeasurement,
+        OrtTuningResult;
+export 'src/ort_session.dart'
+    show OrtSession, OrtSessionOptions, OrtRunOptions, OrtGenerationConfig, OrtResultCacheStats;
 export 'src/ort_model_metadata.dart' show OrtModelMetadata;
-export 'src/ort_value.dart' show OrtValue, OrtDataType;
+export 'src/ort_pipeline.dart' show OrtPipeline, OrtPipelineEdge, OrtGlueOp, OrtPipelineStream, OrtPipelineResult;
+export 'src/ort_value.dart' show OrtValue, OrtDataType, OrtTensorData;
+export 'src/ort_scope.dart' show OrtScope;
+export 'src/ort_lora_adapter.dart' show OrtLoraAdapter;
+export 'src/ort_batch.dart' show OrtBatch, OrtBatchRef, OrtBatchResults;
 export 'src/ort_provider.dart' show OrtProvider;
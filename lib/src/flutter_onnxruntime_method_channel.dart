@@ -4,6 +4,8 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:async';
+
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
@@ -16,6 +18,13 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
   @visibleForTesting
   final methodChannel = const MethodChannel('flutter_onnxruntime');
 
+  /// The event channel native jobs push their results into.
+  @visibleForTesting
+  final eventChannel = const EventChannel('flutter_onnxruntime/events');
+
+  Stream<Map<String, dynamic>>? _events;
+  int _nextGenerationId = 0;
+
   @override
   Future<String?> getPlatformVersion() async {
     return await methodChannel.invokeMethod<String>('getPlatformVersion');
@@ -40,6 +49,30 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<List<Map<String, dynamic>>> preloadSessions(List<Map<String, dynamic>> models) async {
+    final result = await methodChannel.invokeMethod<List<Object?>>('preloadSessions', {'models': models});
+    return (result ?? []).map((session) => _convertMapToStringDynamic(session as Map<Object?, Object?>)).toList();
+  }
+
+  @override
+  Future<Map<String, dynamic>> autotuneSession(
+    String modelPath,
+    Map<String, OrtValue> inputs, {
+    required int budgetMs,
+    String objective = 'latency',
+    Map<String, dynamic>? sessionOptions,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('autotuneSession', {
+      'modelPath': modelPath,
+      'inputs': {for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id}},
+      'budgetMs': budgetMs,
+      'objective': objective,
+      'sessionOptions': sessionOptions ?? {},
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
   /// Get the available providers
   @override
   Future<List<String>> getAvailableProviders() async {
@@ -52,11 +85,30 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
   /// [sessionId] is the ID of the session to run inference on
   /// [inputs] is a map of input names to OrtValue objects
   /// [runOptions] is an optional map of run options
+  @override
+  Future<void> configureModelCache(int budgetBytes) async {
+    await methodChannel.invokeMethod<void>('configureModelCache', {'budgetBytes': budgetBytes});
+  }
+
+  @override
+  Future<Map<String, dynamic>> getModelCacheStats() async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getModelCacheStats');
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getMemoryStats');
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
   @override
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) async {
     // Convert OrtValue objects to valueId maps for platform channel
     final processedInputs = <String, dynamic>{};
@@ -70,10 +122,46 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
       'sessionId': sessionId,
       'inputs': processedInputs,
       'runOptions': runOptions ?? {},
+      if (outputNames != null) 'outputNames': outputNames,
+      if (scopeId != null) 'scopeId': scopeId,
     });
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<List<Map<String, dynamic>>> runMany(
+    List<String> sessionIds,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+    String? scopeId,
+  }) async {
+    final result = await methodChannel.invokeMethod<List<Object?>>('runMany', {
+      'sessionIds': sessionIds,
+      'inputs': {for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id}},
+      'runOptions': runOptions ?? {},
+      if (scopeId != null) 'scopeId': scopeId,
+    });
+    return (result ?? []).map((outputs) => _convertMapToStringDynamic(outputs as Map<Object?, Object?>)).toList();
+  }
+
+  @override
+  Future<Map<String, Map<String, dynamic>>> runWithData(
+    String sessionId,
+    Map<String, Map<String, dynamic>> inputs, {
+    List<String>? outputNames,
+    Map<String, dynamic>? runOptions,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runWithData', {
+      'sessionId': sessionId,
+      'inputs': inputs,
+      'outputNames': outputNames,
+      'runOptions': runOptions ?? {},
+    });
+    return (result ?? {}).map(
+      (key, value) => MapEntry(key.toString(), _convertMapToStringDynamic(value as Map<Object?, Object?>)),
+    );
+  }
+
   @override
   Future<void> closeSession(String sessionId) async {
     await methodChannel.invokeMethod<void>('closeSession', {'sessionId': sessionId});
@@ -97,23 +185,222 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     return result?.map((item) => _convertMapToStringDynamic(item as Map<Object?, Object?>)).toList() ?? [];
   }
 
+  @override
+  Future<void> setStateBindings(String sessionId, Map<String, String> bindings) async {
+    await methodChannel.invokeMethod<void>('setStateBindings', {'sessionId': sessionId, 'bindings': bindings});
+  }
+
+  @override
+  Future<void> resetState(String sessionId) async {
+    await methodChannel.invokeMethod<void>('resetState', {'sessionId': sessionId});
+  }
+
+  @override
+  Future<void> setConstantInput(String sessionId, String name, String? valueId) async {
+    await methodChannel.invokeMethod<void>('setConstantInput', {
+      'sessionId': sessionId,
+      'name': name,
+      'valueId': valueId,
+    });
+  }
+
+  @override
+  Future<void> configureResultCache(String sessionId, int maxEntries, int maxBytes) async {
+    await methodChannel.invokeMethod<void>('configureResultCache', {
+      'sessionId': sessionId,
+      'maxEntries': maxEntries,
+      'maxBytes': maxBytes,
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> reloadSession(
+    String sessionId,
+    String modelPath, {
+    Map<String, dynamic>? sessionOptions,
+    bool warmUp = true,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('reloadSession', {
+      'sessionId': sessionId,
+      'modelPath': modelPath,
+      'sessionOptions': sessionOptions ?? {},
+      'warmUp': warmUp,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> configureBucketing(String sessionId, String dimension, List<int> buckets, {String? maskInput}) async {
+    await methodChannel.invokeMethod<void>('configureBucketing', {
+      'sessionId': sessionId,
+      'dimension': dimension,
+      'buckets': buckets,
+      if (maskInput != null) 'maskInput': maskInput,
+    });
+  }
+
+  @override
+  Future<void> setInputCasting(String sessionId, bool enabled) async {
+    await methodChannel.invokeMethod<void>('setInputCasting', {'sessionId': sessionId, 'enabled': enabled});
+  }
+
+  @override
+  Future<Map<String, dynamic>> loadLoraAdapter({String? path, Uint8List? bytes}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('loadLoraAdapter', {
+      if (path != null) 'path': path,
+      if (bytes != null) 'bytes': bytes,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> releaseLoraAdapter(String adapterId) async {
+    await methodChannel.invokeMethod<void>('releaseLoraAdapter', {'adapterId': adapterId});
+  }
+
+  @override
+  Future<Map<String, dynamic>> getResultCacheStats(String sessionId) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getResultCacheStats', {
+      'sessionId': sessionId,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  /// Native events pushed by long-running jobs, shared by all listeners
+  @override
+  Stream<Map<String, dynamic>> get events {
+    return _events ??= eventChannel.receiveBroadcastStream().map(
+      (event) => _convertMapToStringDynamic(event as Map<Object?, Object?>),
+    );
+  }
+
+  @override
+  Stream<int> generate(String sessionId, List<int> promptIds, {Map<String, dynamic>? config}) {
+    final generationId = 'generation_${_nextGenerationId++}';
+    StreamSubscription<Map<String, dynamic>>? tokenSubscription;
+    late final StreamController<int> controller;
+    var emitted = 0;
+    var running = false;
+
+    controller = StreamController<int>(
+      onListen: () async {
+        running = true;
+        tokenSubscription = events
+            .where((event) => event['event'] == 'generatedToken' && event['generationId'] == generationId)
+            .listen((event) {
+              // Tokens arrive in order; skip any already emitted
+              if (event['index'] == emitted) {
+                controller.add(event['token'] as int);
+                emitted++;
+              }
+            });
+        try {
+          final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('generate', {
+            'sessionId': sessionId,
+            'generationId': generationId,
+            'promptIds': promptIds,
+            'config': config ?? {},
+          });
+          // The final response carries every token, so nothing is lost if a streamed token is still in flight
+          final tokens = (result?['tokens'] as List<Object?>?)?.cast<int>() ?? const <int>[];
+          for (var i = emitted; i < tokens.length; i++) {
+            controller.add(tokens[i]);
+          }
+          emitted = tokens.length;
+        } catch (e, stackTrace) {
+          controller.addError(e, stackTrace);
+        } finally {
+          running = false;
+          await tokenSubscription?.cancel();
+          await controller.close();
+        }
+      },
+      onCancel: () async {
+        if (running) {
+          running = false;
+          await tokenSubscription?.cancel();
+          await methodChannel.invokeMethod<void>('cancelGeneration', {'generationId': generationId});
+        }
+      },
+    );
+    return controller.stream;
+  }
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(
+    List<Map<String, dynamic>> stages,
+    List<Map<String, dynamic>> edges,
+  ) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createPipeline', {
+      'stages': stages,
+      'edges': edges,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(String pipelineId, Map<String, OrtValue> inputs, {String? scopeId}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runPipeline', {
+      'pipelineId': pipelineId,
+      'inputs': {for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id}},
+      if (scopeId != null) 'scopeId': scopeId,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> closePipeline(String pipelineId) async {
+    await methodChannel.invokeMethod<void>('closePipeline', {'pipelineId': pipelineId});
+  }
+
+  @override
+  Future<Map<String, dynamic>> startPipelineStream(String pipelineId, {int queueCapacity = 2}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('startPipelineStream', {
+      'pipelineId': pipelineId,
+      'queueCapacity': queueCapacity,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<bool> pushPipelineFrame(String streamId, int frameId, Map<String, OrtValue> inputs) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('pushPipelineFrame', {
+      'streamId': streamId,
+      'frameId': frameId,
+      'inputs': {for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id}},
+    });
+    return result?['accepted'] as bool? ?? false;
+  }
+
+  @override
+  Future<void> stopPipelineStream(String streamId) async {
+    await methodChannel.invokeMethod<void>('stopPipelineStream', {'streamId': streamId});
+  }
+
   // OrtValue operations
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) async {
+  Future<Map<String, dynamic>> createOrtValue(
+    String sourceType,
+    dynamic data,
+    List<int> shape, {
+    String? scopeId,
+  }) async {
     final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createOrtValue', {
       'sourceType': sourceType,
       'data': data,
       'shape': shape,
+      if (scopeId != null) 'scopeId': scopeId,
     });
     return _convertMapToStringDynamic(result ?? {});
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) async {
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) async {
     final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('convertOrtValue', {
       'valueId': valueId,
       'targetType': targetType,
+      if (scopeId != null) 'scopeId': scopeId,
     });
     return _convertMapToStringDynamic(result ?? {});
   }
@@ -129,6 +416,42 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     await methodChannel.invokeMethod<void>('releaseOrtValue', {'valueId': valueId});
   }
 
+  @override
+  Future<void> pinOrtValue(String valueId, bool pinned) async {
+    await methodChannel.invokeMethod<void>('pinOrtValue', {'valueId': valueId, 'pinned': pinned});
+  }
+
+  @override
+  Future<Map<String, dynamic>> beginScope({String? parentId}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('beginScope', {
+      if (parentId != null) 'parentId': parentId,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> releaseScope(String scopeId, {List<String> keep = const []}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('releaseScope', {
+      'scopeId': scopeId,
+      'keep': keep,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> configureTensorBudget(int budgetBytes, int softLimitBytes) async {
+    await methodChannel.invokeMethod<void>('configureTensorBudget', {
+      'budgetBytes': budgetBytes,
+      'softLimitBytes': softLimitBytes,
+    });
+  }
+
+  @override
+  Future<List<dynamic>> executeBatch(List<Map<String, dynamic>> operations) async {
+    final result = await methodChannel.invokeMethod<List<Object?>>('executeBatch', {'operations': operations});
+    return result ?? [];
+  }
+
   Map<String, dynamic> _convertMapToStringDynamic(Map<Object?, Object?> map) {
     return map.map((key, value) => MapEntry(key.toString(), value));
   }
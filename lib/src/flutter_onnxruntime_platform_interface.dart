@@ -4,6 +4,8 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:typed_data';
+
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_method_channel.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
@@ -39,24 +41,112 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
     throw UnimplementedError('createSession() has not been implemented.');
   }
 
+  /// Create sessions for several models in parallel on background threads
+  ///
+  /// [models] lists maps with a 'modelPath' and optional 'sessionOptions'
+  ///
+  /// Returns one map per model in the createSession format, in order. Fails as a whole if any model fails to load.
+  Future<List<Map<String, dynamic>>> preloadSessions(List<Map<String, dynamic>> models) {
+    throw UnimplementedError('preloadSessions() has not been implemented.');
+  }
+
+  /// Benchmark thread settings for a model and remember the best one for this CPU
+  ///
+  /// [modelPath] is the path to the model file
+  /// [inputs] are the sample inputs every candidate runs on
+  /// [budgetMs] is the total benchmark time, split evenly between the candidates
+  /// [objective] is 'latency' or 'throughput'
+  /// [sessionOptions] are applied to every candidate before its thread settings
+  ///
+  /// Returns the best candidate's settings and figures, and every candidate under 'candidates'
+  Future<Map<String, dynamic>> autotuneSession(
+    String modelPath,
+    Map<String, OrtValue> inputs, {
+    required int budgetMs,
+    String objective = 'latency',
+    Map<String, dynamic>? sessionOptions,
+  }) {
+    throw UnimplementedError('autotuneSession() has not been implemented.');
+  }
+
   /// Get the available providers
   Future<List<String>> getAvailableProviders() {
     throw UnimplementedError('getAvailableProviders() has not been implemented.');
   }
 
+  /// Set the memory budget for keeping loaded models after their last session closes
+  ///
+  /// [budgetBytes] is the total model size kept loaded, 0 releases models as soon as they are unused
+  Future<void> configureModelCache(int budgetBytes) {
+    throw UnimplementedError('configureModelCache() has not been implemented.');
+  }
+
+  /// Get the model cache counters
+  ///
+  /// Returns a map with 'models', 'idleModels', 'bytes', 'budgetBytes' and 'sharedLoads'
+  Future<Map<String, dynamic>> getModelCacheStats() {
+    throw UnimplementedError('getModelCacheStats() has not been implemented.');
+  }
+
+  /// Get the memory held natively by tensors and sessions
+  ///
+  /// Returns a map with 'tensors' (counts and bytes in total, at peak, per data type and per origin)
+  /// and 'sessions' (model, state, result cache and allocator figures keyed by session ID)
+  Future<Map<String, dynamic>> getMemoryStats() {
+    throw UnimplementedError('getMemoryStats() has not been implemented.');
+  }
+
   /// Run inference on a session
   ///
   /// [sessionId] is the ID of the session to run inference on
   /// [inputs] is a map of input names to OrtValue objects
   /// [runOptions] is an optional map of run options
+  /// [outputNames] are the outputs to fetch, all of them when null
+  /// [scopeId] is the tensor scope the outputs join, none when null
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     throw UnimplementedError('runInference() has not been implemented.');
   }
 
+  /// Run several sessions on the same inputs concurrently
+  ///
+  /// [sessionIds] are the IDs of the sessions to run
+  /// [inputs] is a map of input names to OrtValue objects; each session receives the inputs it declares
+  /// [runOptions] is an optional map of run options applied to every run
+  /// [scopeId] is the tensor scope the outputs join, none when null
+  ///
+  /// Returns one output map per session, in the order of [sessionIds], each in the runInference format
+  Future<List<Map<String, dynamic>>> runMany(
+    List<String> sessionIds,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+    String? scopeId,
+  }) {
+    throw UnimplementedError('runMany() has not been implemented.');
+  }
+
+  /// Run inference on data sent from Dart and return output data, without any OrtValue
+  ///
+  /// [sessionId] is the ID of the session to run
+  /// [inputs] maps input names to {'dataType': type, 'shape': shape, 'data': flat list}
+  /// [outputNames] are the outputs to return, all of them when null
+  /// [runOptions] is an optional map of run options
+  ///
+  /// Returns a map of output names to maps in the same format as [inputs]
+  Future<Map<String, Map<String, dynamic>>> runWithData(
+    String sessionId,
+    Map<String, Map<String, dynamic>> inputs, {
+    List<String>? outputNames,
+    Map<String, dynamic>? runOptions,
+  }) {
+    throw UnimplementedError('runWithData() has not been implemented.');
+  }
+
   /// Close a session
   ///
   /// [sessionId] is the ID of the session to close
@@ -92,6 +182,169 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
     throw UnimplementedError('getOutputInfo() has not been implemented.');
   }
 
+  /// Declare which outputs are fed back as inputs on the next run
+  ///
+  /// [sessionId] is the ID of the session to make stateful
+  /// [bindings] maps each output name to the input name it feeds on the next run.
+  /// An empty map turns stateful mode off.
+  Future<void> setStateBindings(String sessionId, Map<String, String> bindings) {
+    throw UnimplementedError('setStateBindings() has not been implemented.');
+  }
+
+  /// Drop the state tensors held natively for a session, keeping its bindings
+  ///
+  /// [sessionId] is the ID of the session to reset
+  Future<void> resetState(String sessionId) {
+    throw UnimplementedError('resetState() has not been implemented.');
+  }
+
+  /// Feed a tensor into an input on every run of a session that leaves the input out
+  ///
+  /// [sessionId] is the ID of the session
+  /// [name] is the name of the input
+  /// [valueId] is the ID of the tensor, copied once natively; null removes the constant input
+  Future<void> setConstantInput(String sessionId, String name, String? valueId) {
+    throw UnimplementedError('setConstantInput() has not been implemented.');
+  }
+
+  /// Configure the result cache of a session
+  ///
+  /// [sessionId] is the ID of the session
+  /// [maxEntries] is the number of results kept, 0 turns the cache off
+  /// [maxBytes] limits the output data kept, 0 for no limit
+  Future<void> configureResultCache(String sessionId, int maxEntries, int maxBytes) {
+    throw UnimplementedError('configureResultCache() has not been implemented.');
+  }
+
+  /// Swap the model behind a session while it keeps serving
+  ///
+  /// [warmUp] runs the new model once on zero-filled inputs before the swap
+  ///
+  /// Returns a map in the createSession format describing the new model
+  Future<Map<String, dynamic>> reloadSession(
+    String sessionId,
+    String modelPath, {
+    Map<String, dynamic>? sessionOptions,
+    bool warmUp = true,
+  }) {
+    throw UnimplementedError('reloadSession() has not been implemented.');
+  }
+
+  /// Configure bucketing of a variable input dimension
+  ///
+  /// [sessionId] is the ID of the session
+  /// [dimension] is the symbolic name of the padded dimension, e.g. 'seq_len'
+  /// [buckets] are the sizes to pad to, an empty list turns bucketing off
+  /// [maskInput] is filled with the matching attention mask unless a run passes it
+  Future<void> configureBucketing(String sessionId, String dimension, List<int> buckets, {String? maskInput}) {
+    throw UnimplementedError('configureBucketing() has not been implemented.');
+  }
+
+  /// Turn conversion of inputs to the element types the model declares on or off
+  ///
+  /// [sessionId] is the ID of the session
+  /// [enabled] makes every run cast numeric inputs of another type, e.g. float32 data for a float16 input
+  Future<void> setInputCasting(String sessionId, bool enabled) {
+    throw UnimplementedError('setInputCasting() has not been implemented.');
+  }
+
+  /// Load a LoRA adapter
+  ///
+  /// [path] is the path of an adapter file, or [bytes] the content of one; exactly one must be given
+  ///
+  /// Returns a map with the 'adapterId'
+  Future<Map<String, dynamic>> loadLoraAdapter({String? path, Uint8List? bytes}) {
+    throw UnimplementedError('loadLoraAdapter() has not been implemented.');
+  }
+
+  /// Release a LoRA adapter
+  ///
+  /// [adapterId] is the ID returned by loadLoraAdapter
+  Future<void> releaseLoraAdapter(String adapterId) {
+    throw UnimplementedError('releaseLoraAdapter() has not been implemented.');
+  }
+
+  /// Get the result cache counters of a session
+  ///
+  /// Returns a map with 'hits', 'misses', 'evictions', 'entries', 'bytes', 'maxEntries' and 'maxBytes'
+  Future<Map<String, dynamic>> getResultCacheStats(String sessionId) {
+    throw UnimplementedError('getResultCacheStats() has not been implemented.');
+  }
+
+  /// Results pushed by native long-running jobs as they complete
+  ///
+  /// Every event is a map whose 'event' entry names its kind, e.g. 'generatedToken'.
+  Stream<Map<String, dynamic>> get events {
+    throw UnimplementedError('events has not been implemented.');
+  }
+
+  /// Run an autoregressive decode loop natively, streaming each generated token
+  ///
+  /// [sessionId] is the ID of a decoder session
+  /// [promptIds] are the prompt token IDs
+  /// [config] is an optional map of generation settings (see OrtGenerationConfig)
+  ///
+  /// Cancelling the stream subscription stops the loop after the current step.
+  Stream<int> generate(String sessionId, List<int> promptIds, {Map<String, dynamic>? config}) {
+    throw UnimplementedError('generate() has not been implemented.');
+  }
+
+  /// Create a pipeline chaining sessions natively
+  ///
+  /// [stages] lists the stages in execution order, each a map with 'name' and 'sessionId'
+  /// [edges] lists maps with 'from' and 'to' endpoints written 'stage.tensor' and optional glue 'ops'
+  ///
+  /// Returns a map containing the 'pipelineId'
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, List<Map<String, dynamic>> edges) {
+    throw UnimplementedError('createPipeline() has not been implemented.');
+  }
+
+  /// Run a pipeline
+  ///
+  /// [pipelineId] is the ID of the pipeline to run
+  /// [inputs] is a map of 'stage.input' endpoints to OrtValue objects
+  /// [scopeId] is the tensor scope the outputs join, none when null
+  ///
+  /// Returns the outputs not consumed by an edge, keyed 'stage.output', in the runInference format
+  Future<Map<String, dynamic>> runPipeline(String pipelineId, Map<String, OrtValue> inputs, {String? scopeId}) {
+    throw UnimplementedError('runPipeline() has not been implemented.');
+  }
+
+  /// Close a pipeline; its sessions stay open
+  ///
+  /// [pipelineId] is the ID of the pipeline to close
+  Future<void> closePipeline(String pipelineId) {
+    throw UnimplementedError('closePipeline() has not been implemented.');
+  }
+
+  /// Start streaming frames through a pipeline, one native thread per stage
+  ///
+  /// [pipelineId] is the ID of the pipeline to stream through
+  /// [queueCapacity] is the number of frames that may wait in front of each stage
+  ///
+  /// Returns a map containing the 'streamId'. Results arrive on [events] as 'pipelineResult' events.
+  Future<Map<String, dynamic>> startPipelineStream(String pipelineId, {int queueCapacity = 2}) {
+    throw UnimplementedError('startPipelineStream() has not been implemented.');
+  }
+
+  /// Queue a frame on a pipeline stream without waiting for it to be processed
+  ///
+  /// [streamId] is the ID of the stream
+  /// [frameId] is echoed back in the frame's 'pipelineResult' event
+  /// [inputs] is a map of 'stage.input' endpoints to OrtValue objects
+  ///
+  /// Returns false if the first stage is saturated and the frame was dropped
+  Future<bool> pushPipelineFrame(String streamId, int frameId, Map<String, OrtValue> inputs) {
+    throw UnimplementedError('pushPipelineFrame() has not been implemented.');
+  }
+
+  /// Stop a pipeline stream; frames already queued still finish, then a 'pipelineStreamClosed' event follows
+  ///
+  /// [streamId] is the ID of the stream to stop
+  Future<void> stopPipelineStream(String streamId) {
+    throw UnimplementedError('stopPipelineStream() has not been implemented.');
+  }
+
   // OrtValue operations
 
   /// Creates an OrtValue from data
@@ -99,7 +352,8 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
   /// [sourceType] is the source data type (e.g., 'float32', 'int32')
   /// [data] is the data to create the tensor from
   /// [shape] is the shape of the tensor
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) {
+  /// [scopeId] is the tensor scope the new OrtValue joins, none when null
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) {
     throw UnimplementedError('createOrtValue() has not been implemented.');
   }
 
@@ -107,7 +361,8 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
   ///
   /// [valueId] is the ID of the OrtValue to convert
   /// [targetType] is the target data type (e.g., 'float32', 'float16')
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) {
+  /// [scopeId] is the tensor scope the new OrtValue joins, none when null
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) {
     throw UnimplementedError('convertOrtValue() has not been implemented.');
   }
 
@@ -124,4 +379,50 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
   Future<void> releaseOrtValue(String valueId) {
     throw UnimplementedError('releaseOrtValue() has not been implemented.');
   }
+
+  /// Exempt an OrtValue from eviction by the tensor budget, or make it evictable again
+  ///
+  /// [valueId] is the ID of the OrtValue
+  /// [pinned] is whether the budget must keep it
+  Future<void> pinOrtValue(String valueId, bool pinned) {
+    throw UnimplementedError('pinOrtValue() has not been implemented.');
+  }
+
+  /// Open a tensor scope
+  ///
+  /// [parentId] is the scope that receives the values kept when this one is released, none when null
+  ///
+  /// Returns a map with the 'scopeId'
+  Future<Map<String, dynamic>> beginScope({String? parentId}) {
+    throw UnimplementedError('beginScope() has not been implemented.');
+  }
+
+  /// Release every OrtValue of a scope and close it
+  ///
+  /// [scopeId] is the ID returned by beginScope
+  /// [keep] lists value IDs that survive and move to the parent scope
+  ///
+  /// Returns a map with the number of values 'released'
+  Future<Map<String, dynamic>> releaseScope(String scopeId, {List<String> keep = const []}) {
+    throw UnimplementedError('releaseScope() has not been implemented.');
+  }
+
+  /// Limit the bytes held by native tensors
+  ///
+  /// [budgetBytes] is the hard limit past which unpinned run outputs are evicted, 0 for no limit
+  /// [softLimitBytes] is the limit past which a 'memoryWarning' event is raised, 0 for none
+  Future<void> configureTensorBudget(int budgetBytes, int softLimitBytes) {
+    throw UnimplementedError('configureTensorBudget() has not been implemented.');
+  }
+
+  /// Run several plugin methods in one platform-channel round trip
+  ///
+  /// [operations] is an ordered list of {'method': name, 'args': map}. Inside args, a map
+  /// {'\$ref': i, 'path': [...]} stands for the result of operation i, or the part of it reached by
+  /// following the map keys and list indices in 'path'.
+  ///
+  /// Returns the result of every operation in order
+  Future<List<dynamic>> executeBatch(List<Map<String, dynamic>> operations) {
+    throw UnimplementedError('executeBatch() has not been implemented.');
+  }
 }
@@ -14,6 +14,7 @@ import 'package:path_provider/path_provider.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
 import 'package:flutter_onnxruntime/src/ort_provider.dart';
 import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
 
 class OnnxRuntime {
   Future<String?> getPlatformVersion() {
@@ -29,6 +30,48 @@ class OnnxRuntime {
     return OrtSession.fromMap(result);
   }
 
+  /// Create sessions for several models at once, e.g. at startup
+  ///
+  /// The models load in parallel on background threads, one per model up to the device's hardware
+  /// threads, so this takes about as long as the slowest model rather than the sum of all of them.
+  /// With more models than hardware threads, the rest wait for a free thread. Sessions are returned
+  /// in the order of [modelPaths].
+  /// If any model fails to load, none of the sessions are kept and the error is thrown.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<List<OrtSession>> preloadSessions(List<String> modelPaths, {OrtSessionOptions? options}) async {
+    final results = await FlutterOnnxruntimePlatform.instance.preloadSessions(
+      modelPaths.map((modelPath) => {'modelPath': modelPath, 'sessionOptions': options?.toMap() ?? {}}).toList(),
+    );
+    return results.map((result) => OrtSession.fromMap(result)).toList();
+  }
+
+  /// Find the fastest thread settings for a model on this device
+  ///
+  /// Opens the model with several intra-op thread counts and with parallel execution, runs each on
+  /// [sampleInputs] for an equal share of [budget] (model loading comes on top) and keeps the best for
+  /// [objective]. The result is stored per model content and CPU in the user's cache directory, so
+  /// later sessions created with [OrtSessionOptions.useTunedOptions] pick it up without tuning again.
+  /// [options] (e.g. providers) apply to every candidate.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<OrtTuningResult> autotuneSession(
+    String modelPath,
+    Map<String, OrtValue> sampleInputs, {
+    Duration budget = const Duration(seconds: 10),
+    OrtTuningObjective objective = OrtTuningObjective.latency,
+    OrtSessionOptions? options,
+  }) async {
+    final result = await FlutterOnnxruntimePlatform.instance.autotuneSession(
+      modelPath,
+      sampleInputs,
+      budgetMs: budget.inMilliseconds,
+      objective: objective.name,
+      sessionOptions: options?.toMap() ?? {},
+    );
+    return OrtTuningResult.fromMap(result);
+  }
+
   /// Create an ONNX Runtime session from an asset model file
   ///
   /// This will extract the asset to a temporary file and use that path
@@ -60,6 +103,55 @@ class OnnxRuntime {
     }
   }
 
+  /// Keep models loaded after their last session closes, up to [budgetBytes] of model files in total
+  ///
+  /// Sessions created from the same model file with the same options always share one loaded model.
+  /// With a budget, a closed model also stays loaded so that creating it again is instant; the least
+  /// recently used idle model is released first. A budget of 0 (the default) releases models at once.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> configureModelCache({required int budgetBytes}) {
+    return FlutterOnnxruntimePlatform.instance.configureModelCache(budgetBytes);
+  }
+
+  /// Get the number and size of loaded models and how many sessions shared one
+  Future<OrtModelCacheStats> getModelCacheStats() async {
+    final result = await FlutterOnnxruntimePlatform.instance.getModelCacheStats();
+    return OrtModelCacheStats.fromMap(result);
+  }
+
+  /// Get the memory held natively, to attribute leaks and peaks
+  ///
+  /// Reports the live tensors by data type and by origin, and per session the model size, held state,
+  /// cached results and, when the plugin is built against ONNX Runtime 1.23 or later, the counters
+  /// of its memory arena.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<OrtMemoryStats> getMemoryStats() async {
+    final result = await FlutterOnnxruntimePlatform.instance.getMemoryStats();
+    return OrtMemoryStats.fromMap(result);
+  }
+
+  /// Limit the memory held by native tensors, so outputs that are never disposed cannot exhaust it
+  ///
+  /// Once live tensors exceed [budgetBytes], run outputs that are not pinned (see [OrtValue.pin]) are
+  /// evicted, least recently used first; using an evicted OrtValue throws a PlatformException with code
+  /// 'EVICTED_VALUE'. Tensors created from Dart data are never evicted. Crossing [softLimitBytes], or
+  /// staying over [budgetBytes] with nothing left to evict, emits an [OrtMemoryWarning] on
+  /// [memoryWarnings]. 0 turns either limit off.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> configureTensorBudget({required int budgetBytes, int softLimitBytes = 0}) {
+    return FlutterOnnxruntimePlatform.instance.configureTensorBudget(budgetBytes, softLimitBytes);
+  }
+
+  /// Warnings raised when native tensors cross the limits set with [configureTensorBudget]
+  Stream<OrtMemoryWarning> get memoryWarnings {
+    return FlutterOnnxruntimePlatform.instance.events
+        .where((event) => event['event'] == 'memoryWarning')
+        .map((event) => OrtMemoryWarning.fromMap(event));
+  }
+
   /// Get the available providers
   ///
   /// Returns a list of the available providers
@@ -74,3 +166,210 @@ class OnnxRuntime {
     }).toList();
   }
 }
+
+/// Counters of the native model cache
+class OrtModelCacheStats {
+  // loaded models, and those without an open session
+  final int models;
+  final int idleModels;
+  // total size of the loaded model files
+  final int bytes;
+  final int budgetBytes;
+  // sessions that reused an already loaded model
+  final int sharedLoads;
+
+  OrtModelCacheStats({
+    required this.models,
+    required this.idleModels,
+    required this.bytes,
+    required this.budgetBytes,
+    required this.sharedLoads,
+  });
+
+  factory OrtModelCacheStats.fromMap(Map<String, dynamic> map) {
+    return OrtModelCacheStats(
+      models: map['models'] as int? ?? 0,
+      idleModels: map['idleModels'] as int? ?? 0,
+      bytes: map['bytes'] as int? ?? 0,
+      budgetBytes: map['budgetBytes'] as int? ?? 0,
+      sharedLoads: map['sharedLoads'] as int? ?? 0,
+    );
+  }
+}
+
+/// Number and total data size of a group of native tensors
+class OrtMemoryUsage {
+  final int count;
+  final int bytes;
+
+  OrtMemoryUsage({required this.count, required this.bytes});
+
+  factory OrtMemoryUsage.fromMap(Map<Object?, Object?> map) {
+    return OrtMemoryUsage(count: map['count'] as int? ?? 0, bytes: map['bytes'] as int? ?? 0);
+  }
+}
+
+/// Memory held natively on behalf of one session
+class OrtSessionMemoryStats {
+  // size of the model file; sessions sharing a model each report it
+  final int modelBytes;
+  // state tensors carried between runs
+  final int stateBytes;
+  // outputs held by the result cache
+  final int resultCacheBytes;
+  // arena counters reported by ONNX Runtime, e.g. 'InUse' and 'MaxInUse'; null when unsupported, i.e. the
+  // plugin is built against ONNX Runtime older than 1.23 (the default) or the session has no CPU arena
+  final Map<String, int>? allocator;
+
+  OrtSessionMemoryStats({
+    required this.modelBytes,
+    required this.stateBytes,
+    required this.resultCacheBytes,
+    this.allocator,
+  });
+
+  factory OrtSessionMemoryStats.fromMap(Map<Object?, Object?> map) {
+    final allocator = map['allocator'] as Map<Object?, Object?>?;
+    return OrtSessionMemoryStats(
+      modelBytes: map['modelBytes'] as int? ?? 0,
+      stateBytes: map['stateBytes'] as int? ?? 0,
+      resultCacheBytes: map['resultCacheBytes'] as int? ?? 0,
+      allocator: allocator?.map((key, value) => MapEntry(key.toString(), value as int)),
+    );
+  }
+}
+
+/// Memory held natively by the plugin
+class OrtMemoryStats {
+  // live tensors (OrtValues and run outputs not yet released)
+  final OrtMemoryUsage tensors;
+  // highest tensor count and highest tensor bytes reached so far
+  final OrtMemoryUsage peakTensors;
+  // live tensors keyed by data type, e.g. 'float32'
+  final Map<String, OrtMemoryUsage> tensorsByType;
+  // live tensors keyed by origin: 'user' (created from Dart data) or 'output' (returned by a run)
+  final Map<String, OrtMemoryUsage> tensorsByOrigin;
+  // limits set with configureTensorBudget, 0 when off
+  final int tensorBudgetBytes;
+  final int tensorSoftLimitBytes;
+  // run outputs evicted to stay within the budget
+  final int evictions;
+  final Map<String, OrtSessionMemoryStats> sessions;
+
+  OrtMemoryStats({
+    required this.tensors,
+    required this.peakTensors,
+    required this.tensorsByType,
+    required this.tensorsByOrigin,
+    required this.tensorBudgetBytes,
+    required this.tensorSoftLimitBytes,
+    required this.evictions,
+    required this.sessions,
+  });
+
+  factory OrtMemoryStats.fromMap(Map<String, dynamic> map) {
+    final tensors = map['tensors'] as Map<Object?, Object?>? ?? {};
+    final sessions = map['sessions'] as Map<Object?, Object?>? ?? {};
+
+    Map<String, OrtMemoryUsage> usageMap(Object? value) {
+      final usages = value as Map<Object?, Object?>? ?? {};
+      return usages.map(
+        (key, usage) => MapEntry(key.toString(), OrtMemoryUsage.fromMap(usage as Map<Object?, Object?>)),
+      );
+    }
+
+    return OrtMemoryStats(
+      tensors: OrtMemoryUsage.fromMap(tensors),
+      peakTensors: OrtMemoryUsage(count: tensors['peakCount'] as int? ?? 0, bytes: tensors['peakBytes'] as int? ?? 0),
+      tensorsByType: usageMap(tensors['byType']),
+      tensorsByOrigin: usageMap(tensors['byOrigin']),
+      tensorBudgetBytes: tensors['budgetBytes'] as int? ?? 0,
+      tensorSoftLimitBytes: tensors['softLimitBytes'] as int? ?? 0,
+      evictions: tensors['evictions'] as int? ?? 0,
+      sessions: sessions.map(
+        (key, stats) => MapEntry(key.toString(), OrtSessionMemoryStats.fromMap(stats as Map<Object?, Object?>)),
+      ),
+    );
+  }
+}
+
+/// Raised when native tensors cross a limit set with [OnnxRuntime.configureTensorBudget]
+class OrtMemoryWarning {
+  // 'soft' past the soft limit, 'hard' when over the budget with nothing left to evict
+  final String level;
+  final int bytes;
+  final int limitBytes;
+
+  OrtMemoryWarning({required this.level, required this.bytes, required this.limitBytes});
+
+  factory OrtMemoryWarning.fromMap(Map<String, dynamic> map) {
+    return OrtMemoryWarning(
+      level: map['level'] as String,
+      bytes: map['bytes'] as int? ?? 0,
+      limitBytes: map['limitBytes'] as int? ?? 0,
+    );
+  }
+}
+
+/// What [OnnxRuntime.autotuneSession] optimizes for
+enum OrtTuningObjective {
+  // lowest median time of a single run
+  latency,
+  // most runs per second with concurrent callers
+  throughput,
+}
+
+/// Benchmark of one set of session thread settings
+class OrtTuningMeasurement {
+  final int intraOpNumThreads;
+  final int interOpNumThreads;
+  // parallel instead of sequential execution of independent graph branches
+  final bool parallelExecution;
+  // median time of one run
+  final double latencyMs;
+  final double runsPerSecond;
+  // callers running the session at once during the benchmark
+  final int concurrency;
+  final int runs;
+
+  OrtTuningMeasurement({
+    required this.intraOpNumThreads,
+    required this.interOpNumThreads,
+    required this.parallelExecution,
+    required this.latencyMs,
+    required this.runsPerSecond,
+    required this.concurrency,
+    required this.runs,
+  });
+
+  factory OrtTuningMeasurement.fromMap(Map<Object?, Object?> map) {
+    return OrtTuningMeasurement(
+      intraOpNumThreads: map['intraOpNumThreads'] as int? ?? 1,
+      interOpNumThreads: map['interOpNumThreads'] as int? ?? 1,
+      parallelExecution: map['parallelExecution'] as bool? ?? false,
+      latencyMs: (map['latencyMs'] as num? ?? 0).toDouble(),
+      runsPerSecond: (map['runsPerSecond'] as num? ?? 0).toDouble(),
+      concurrency: map['concurrency'] as int? ?? 1,
+      runs: map['runs'] as int? ?? 0,
+    );
+  }
+}
+
+/// Outcome of [OnnxRuntime.autotuneSession]
+class OrtTuningResult {
+  // the settings now stored for the model
+  final OrtTuningMeasurement best;
+  final List<OrtTuningMeasurement> candidates;
+
+  OrtTuningResult({required this.best, required this.candidates});
+
+  factory OrtTuningResult.fromMap(Map<String, dynamic> map) {
+    final candidates = map['candidates'] as List<Object?>? ?? [];
+    return OrtTuningResult(
+      best: OrtTuningMeasurement.fromMap(map),
+      candidates: candidates
+          .map((candidate) => OrtTuningMeasurement.fromMap(candidate as Map<Object?, Object?>))
+          .toList(),
+    );
+  }
+}
@@ -0,0 +1,137 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:typed_data';
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_scope.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// Stands for the result of an earlier operation of an [OrtBatch], or for a part of it
+class OrtBatchRef {
+  final int index;
+  // map keys and list indices leading into the result
+  final List<Object> path;
+
+  const OrtBatchRef._(this.index, this.path);
+
+  /// Refer to an entry of a map result or an element of a list result
+  OrtBatchRef operator [](Object key) => OrtBatchRef._(index, [...path, key]);
+
+  Map<String, dynamic> toMap() {
+    return {'\$ref': index, 'path': path};
+  }
+}
+
+/// Results of an executed [OrtBatch]
+class OrtBatchResults {
+  // result of every operation in the order they were added
+  final List<dynamic> results;
+
+  OrtBatchResults(this.results);
+
+  /// Look up the value a reference stands for
+  dynamic operator [](OrtBatchRef ref) {
+    dynamic value = results[ref.index];
+    for (final step in ref.path) {
+      value = value is List ? value[step as int] : (value as Map)[step];
+    }
+    return value;
+  }
+}
+
+/// Several plugin calls sent to the native side in one platform-channel message
+///
+/// Operations run in the order they were added, and later ones can use the results of earlier ones
+/// through [OrtBatchRef]s, so a whole frame (create inputs, run, read outputs, release) costs a
+/// single round trip. The batch stops at the first failing operation and throws a PlatformException
+/// with code 'BATCH_FAILED'; its details hold the failing 'index', its 'code' and the 'results' so far.
+///
+/// Note: currently only supported on Linux.
+class OrtBatch {
+  final List<Map<String, dynamic>> _operations = [];
+
+  /// Number of operations added so far
+  int get length => _operations.length;
+
+  /// Add a call of any synchronous plugin method
+  ///
+  /// [OrtBatchRef]s anywhere inside [args] are replaced by what they stand for before the call.
+  OrtBatchRef add(String method, [Map<String, dynamic> args = const {}]) {
+    _operations.add({'method': method, 'args': _encode(args)});
+    return OrtBatchRef._(_operations.length - 1, const []);
+  }
+
+  /// Create a tensor as [OrtValue.fromList] does; the reference stands for its value ID
+  OrtBatchRef createOrtValue(dynamic data, List<int> shape, {OrtScope? scope}) {
+    return add('createOrtValue', {
+      ...createOrtValueArgs(data, shape),
+      if (scope != null) 'scopeId': scope.id,
+    })['valueId'];
+  }
+
+  /// Run [session] on [inputs], given as [OrtValue]s or references to value IDs
+  ///
+  /// Returns references to the value ID of every fetched output: [outputNames], or all outputs of the
+  /// session when null. The outputs join [scope], if given.
+  Map<String, OrtBatchRef> run(
+    OrtSession session,
+    Map<String, Object> inputs, {
+    Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    OrtScope? scope,
+  }) {
+    final outputs = add('runInference', {
+      'sessionId': session.id,
+      'inputs': {for (final entry in inputs.entries) entry.key: {'valueId': _valueId(entry.value)}},
+      'runOptions': runOptions ?? {},
+      if (outputNames != null) 'outputNames': outputNames,
+      if (scope != null) 'scopeId': scope.id,
+    });
+    return {for (final name in outputNames ?? session.outputNames) name: outputs[name][0]};
+  }
+
+  /// Read the data of a tensor; the reference stands for a map with 'data' and 'shape'
+  OrtBatchRef getData(Object value) {
+    return add('getOrtValueData', {'valueId': _valueId(value)});
+  }
+
+  /// Release a tensor
+  void release(Object value) {
+    add('releaseOrtValue', {'valueId': _valueId(value)});
+  }
+
+  /// Send every operation added so far in one call
+  Future<OrtBatchResults> execute() async {
+    final results = await FlutterOnnxruntimePlatform.instance.executeBatch(_operations);
+    return OrtBatchResults(results);
+  }
+
+  static Object _valueId(Object value) {
+    if (value is OrtValue) {
+      return value.id;
+    }
+    if (value is OrtBatchRef) {
+      return value;
+    }
+    throw ArgumentError('Expected an OrtValue or an OrtBatchRef, got ${value.runtimeType}');
+  }
+
+  static dynamic _encode(dynamic value) {
+    if (value is OrtBatchRef) {
+      return value.toMap();
+    }
+    if (value is Map) {
+      return value.map((key, item) => MapEntry(key, _encode(item)));
+    }
+    // Typed data goes over the channel as is
+    if (value is List && value is! TypedData) {
+      return value.map(_encode).toList();
+    }
+    return value;
+  }
+}
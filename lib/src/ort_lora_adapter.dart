@@ -0,0 +1,47 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:typed_data';
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+
+/// LoRA weights of a fine-tuned variant, applied on top of a base model per run
+///
+/// Several variants of one model can then share a single session: load the base model once and
+/// pass the adapter of the wanted variant in `OrtRunOptions.loraAdapters`. Each adapter costs only
+/// its low-rank weights in memory. Runs without adapters use the base model's own weights.
+///
+/// Adapters are `.onnx_adapter` files, e.g. converted with ONNX Runtime's `onnxruntime.AdapterFormat`.
+///
+/// Note: currently only supported on Linux.
+class OrtLoraAdapter {
+  final String id;
+
+  OrtLoraAdapter._(this.id);
+
+  /// Load an adapter file
+  ///
+  /// Example:
+  /// ```dart
+  /// final legal = await OrtLoraAdapter.fromFile('adapters/legal.onnx_adapter');
+  /// final outputs = await session.run(inputs, options: OrtRunOptions(loraAdapters: [legal]));
+  /// ```
+  static Future<OrtLoraAdapter> fromFile(String path) async {
+    final result = await FlutterOnnxruntimePlatform.instance.loadLoraAdapter(path: path);
+    return OrtLoraAdapter._(result['adapterId'] as String);
+  }
+
+  /// Load an adapter from the content of an adapter file, e.g. read from an asset
+  static Future<OrtLoraAdapter> fromBytes(Uint8List bytes) async {
+    final result = await FlutterOnnxruntimePlatform.instance.loadLoraAdapter(bytes: bytes);
+    return OrtLoraAdapter._(result['adapterId'] as String);
+  }
+
+  /// Free the adapter's weights; runs already using it finish first
+  Future<void> release() async {
+    await FlutterOnnxruntimePlatform.instance.releaseLoraAdapter(id);
+  }
+}
@@ -0,0 +1,204 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_scope.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// A native operation applied to a tensor while it travels along a pipeline edge
+class OrtGlueOp {
+  final String op;
+  final Map<String, dynamic> params;
+
+  const OrtGlueOp._(this.op, this.params);
+
+  /// Slice the tensor to [starts[i], ends[i]) along each leading axis i.
+  /// Negative indices count from the end of the axis.
+  factory OrtGlueOp.crop({required List<int> starts, required List<int> ends}) {
+    return OrtGlueOp._('crop', {'starts': starts, 'ends': ends});
+  }
+
+  /// Bilinearly resize the last two axes of a float32 or uint8 tensor (e.g. H and W of NCHW)
+  factory OrtGlueOp.resize({required int height, required int width}) {
+    return OrtGlueOp._('resize', {'height': height, 'width': width});
+  }
+
+  /// Convert the tensor to another numeric data type
+  factory OrtGlueOp.cast(OrtDataType to) {
+    return OrtGlueOp._('cast', {'to': to.toString().split('.').last});
+  }
+
+  Map<String, dynamic> toMap() {
+    return {'op': op, ...params};
+  }
+}
+
+/// Feeds the output of one stage into an input of a later stage
+class OrtPipelineEdge {
+  // endpoints written 'stage.tensor', e.g. 'detector.boxes'
+  final String from;
+  final String to;
+  // applied in order before the tensor reaches the input
+  final List<OrtGlueOp> ops;
+
+  OrtPipelineEdge({required this.from, required this.to, this.ops = const []});
+
+  Map<String, dynamic> toMap() {
+    return {'from': from, 'to': to, 'ops': ops.map((op) => op.toMap()).toList()};
+  }
+}
+
+/// Several sessions chained natively: intermediate tensors never come back to Dart
+///
+/// Note: currently only supported on Linux.
+class OrtPipeline {
+  final String id;
+
+  OrtPipeline._(this.id);
+
+  /// Create a pipeline running [stages] in insertion order
+  ///
+  /// Stage names must not contain '.'. Every edge must go from an earlier stage to a later one.
+  ///
+  /// Example:
+  /// ```dart
+  /// final pipeline = await OrtPipeline.create(
+  ///   stages: {'detector': detector, 'classifier': classifier},
+  ///   edges: [
+  ///     OrtPipelineEdge(
+  ///       from: 'detector.crops',
+  ///       to: 'classifier.images',
+  ///       ops: [OrtGlueOp.resize(height: 224, width: 224)],
+  ///     ),
+  ///   ],
+  /// );
+  /// final outputs = await pipeline.run({'detector.images': frame});
+  /// final scores = outputs['classifier.scores'];
+  /// ```
+  static Future<OrtPipeline> create({
+    required Map<String, OrtSession> stages,
+    List<OrtPipelineEdge> edges = const [],
+  }) async {
+    final result = await FlutterOnnxruntimePlatform.instance.createPipeline(
+      stages.entries.map((entry) => {'name': entry.key, 'sessionId': entry.value.id}).toList(),
+      edges.map((edge) => edge.toMap()).toList(),
+    );
+    return OrtPipeline._(result['pipelineId'] as String);
+  }
+
+  /// Run the pipeline in one call
+  ///
+  /// [inputs] maps 'stage.input' endpoints to tensors for inputs not fed by an edge.
+  ///
+  /// Returns every output not consumed by an edge, keyed 'stage.output'. The outputs join [scope], if given.
+  Future<Map<String, OrtValue>> run(Map<String, OrtValue> inputs, {OrtScope? scope}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.runPipeline(id, inputs, scopeId: scope?.id);
+    return _toOrtValues(result);
+  }
+
+  /// Start streaming frames through the pipeline
+  ///
+  /// Every stage runs on its own native thread, so frame N+1 can be preprocessed while frame N is
+  /// still in inference. Up to [queueCapacity] frames wait in front of each stage; the default of 2
+  /// double-buffers every stage. Frames pushed while the first stage is full are dropped.
+  ///
+  /// Example:
+  /// ```dart
+  /// final stream = await pipeline.startStream();
+  /// stream.results.listen((result) => draw(result.outputs['classifier.scores']));
+  /// for (final frame in frames) {
+  ///   await stream.push({'detector.images': frame});
+  /// }
+  /// await stream.stop();
+  /// ```
+  Future<OrtPipelineStream> startStream({int queueCapacity = 2}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.startPipelineStream(id, queueCapacity: queueCapacity);
+    return OrtPipelineStream._(result['streamId'] as String);
+  }
+
+  /// Release the pipeline; its sessions stay open
+  Future<void> close() async {
+    await FlutterOnnxruntimePlatform.instance.closePipeline(id);
+  }
+}
+
+/// The outcome of one frame pushed into an [OrtPipelineStream]
+class OrtPipelineResult {
+  final int frameId;
+  // outputs not consumed by an edge, keyed 'stage.output'; empty if a stage failed
+  final Map<String, OrtValue> outputs;
+  // message of the stage that failed, null on success
+  final String? error;
+
+  OrtPipelineResult({required this.frameId, required this.outputs, this.error});
+}
+
+/// Frames flowing through an [OrtPipeline] with all stages running concurrently
+///
+/// Note: currently only supported on Linux.
+class OrtPipelineStream {
+  final String id;
+  final StreamController<OrtPipelineResult> _results = StreamController<OrtPipelineResult>();
+  late final StreamSubscription<Map<String, dynamic>> _subscription;
+  int _nextFrameId = 0;
+
+  OrtPipelineStream._(this.id) {
+    _subscription = FlutterOnnxruntimePlatform.instance.events
+        .where((event) => event['streamId'] == id)
+        .listen(_onEvent);
+  }
+
+  /// Results in the order the frames were pushed; closes once the stream has stopped and drained
+  Stream<OrtPipelineResult> get results => _results.stream;
+
+  /// Queue a frame without waiting for it to be processed
+  ///
+  /// [inputs] maps 'stage.input' endpoints to tensors. [frameId] is reported back in the result and
+  /// defaults to a running counter.
+  ///
+  /// Returns false if the pipeline is saturated and the frame was dropped.
+  Future<bool> push(Map<String, OrtValue> inputs, {int? frameId}) {
+    return FlutterOnnxruntimePlatform.instance.pushPipelineFrame(id, frameId ?? _nextFrameId++, inputs);
+  }
+
+  /// Stop accepting frames; frames already queued are still delivered before [results] closes
+  Future<void> stop() async {
+    await FlutterOnnxruntimePlatform.instance.stopPipelineStream(id);
+  }
+
+  void _onEvent(Map<String, dynamic> event) {
+    switch (event['event']) {
+      case 'pipelineResult':
+        final outputs = event['outputs'] as Map<Object?, Object?>?;
+        _results.add(
+          OrtPipelineResult(
+            frameId: event['frameId'] as int,
+            outputs: outputs == null ? {} : _toOrtValues(outputs),
+            error: event['error'] as String?,
+          ),
+        );
+        break;
+      case 'pipelineStreamClosed':
+        _subscription.cancel();
+        _results.close();
+        break;
+    }
+  }
+}
+
+// Convert a native map of name -> [valueId, type, shape] to OrtValues
+Map<String, OrtValue> _toOrtValues(Map<Object?, Object?> result) {
+  final outputs = <String, OrtValue>{};
+  for (final entry in result.entries) {
+    final info = entry.value as List<Object?>;
+    final tensorMap = {'valueId': info[0], 'dataType': info[1], 'shape': info[2]};
+    outputs[entry.key.toString()] = OrtValue.fromMap(tensorMap);
+  }
+  return outputs;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_pipeline.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// A group of OrtValues released together in one call
+///
+/// An OrtValue belongs to a scope when the call creating it names the scope: [OrtValue.fromList],
+/// [OrtValue.to], [OrtSession.run], [OrtSession.runMany] and [OrtPipeline.run] take a `scope`
+/// argument. Values from calls that name no scope, e.g. other code running while the scope is open or
+/// frames of a pipeline stream, are never released with it. Releasing the scope disposes all of its
+/// values at once, and the data of values created from Dart lists is freed in one step instead of
+/// value by value.
+///
+/// Note: currently only supported on Linux.
+class OrtScope {
+  final String id;
+
+  OrtScope._(this.id);
+
+  /// Open a scope
+  ///
+  /// Values kept when this scope is released move to [parent], if given.
+  ///
+  /// Example:
+  /// ```dart
+  /// final scope = await OrtScope.begin();
+  /// final input = await OrtValue.fromList(pixels, [1, 3, 224, 224], scope: scope);
+  /// final outputs = await session.run({'images': input}, scope: scope);
+  /// final scores = await outputs['scores']!.asList();
+  /// await scope.release();
+  /// ```
+  static Future<OrtScope> begin({OrtScope? parent}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.beginScope(parentId: parent?.id);
+    return OrtScope._(result['scopeId'] as String);
+  }
+
+  /// Run [body] with a new scope and release the scope afterwards, even if [body] throws
+  static Future<T> use<T>(Future<T> Function(OrtScope scope) body, {OrtScope? parent}) async {
+    final scope = await begin(parent: parent);
+    try {
+      return await body(scope);
+    } finally {
+      await scope.release();
+    }
+  }
+
+  /// Dispose every value of this scope except those in [keep] and close it
+  ///
+  /// Kept values move to the parent scope, if any. Returns the number of values released.
+  Future<int> release({List<OrtValue> keep = const []}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.releaseScope(
+      id,
+      keep: keep.map((value) => value.id).toList(),
+    );
+    return result['released'] as int? ?? 0;
+  }
+}
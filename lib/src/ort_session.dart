@@ -5,31 +5,66 @@
 // LICENSE file in the root directory of this source tree.
 
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_lora_adapter.dart';
 import 'package:flutter_onnxruntime/src/ort_model_metadata.dart';
 import 'package:flutter_onnxruntime/src/ort_provider.dart';
+import 'package:flutter_onnxruntime/src/ort_scope.dart';
 import 'package:flutter_onnxruntime/src/ort_value.dart';
 
 class OrtSession {
   final String id;
-  final List<String> inputNames;
-  final List<String> outputNames;
+
+  // Names and introspection of the current model; reload replaces them
+  List<String> _inputNames;
+  List<String> _outputNames;
+
+  // Introspection sent along when the session was opened or reloaded (Linux); null where it has to be queried
+  List<Map<String, dynamic>>? _inputInfo;
+  List<Map<String, dynamic>>? _outputInfo;
+  OrtModelMetadata? _metadata;
 
   // Private constructor
-  OrtSession._({required this.id, required this.inputNames, required this.outputNames});
+  OrtSession._({
+    required this.id,
+    required List<String> inputNames,
+    required List<String> outputNames,
+    List<Map<String, dynamic>>? inputInfo,
+    List<Map<String, dynamic>>? outputInfo,
+    OrtModelMetadata? metadata,
+  }) : _inputNames = inputNames,
+       _outputNames = outputNames,
+       _inputInfo = inputInfo,
+       _outputInfo = outputInfo,
+       _metadata = metadata;
 
   // Public factory constructor to create from map
   factory OrtSession.fromMap(Map<String, dynamic> map) {
+    final metadata = map['metadata'] as Map?;
     return OrtSession._(
       id: map['sessionId'] as String,
       inputNames: List<String>.from(map['inputNames'] ?? []),
       outputNames: List<String>.from(map['outputNames'] ?? []),
+      inputInfo: _tensorInfoFromList(map['inputInfo'] as List?),
+      outputInfo: _tensorInfoFromList(map['outputInfo'] as List?),
+      metadata: metadata == null ? null : OrtModelMetadata.fromMap(Map<String, dynamic>.from(metadata)),
     );
   }
 
+  List<String> get inputNames => _inputNames;
+  List<String> get outputNames => _outputNames;
+
+  static List<Map<String, dynamic>>? _tensorInfoFromList(List? infoList) {
+    return infoList?.map((info) => Map<String, dynamic>.from(info as Map)).toList();
+  }
+
   /// Run inference on the session
   ///
   /// [inputs] is a map of input names to OrtValue objects
   /// [options] is an optional map of run options
+  /// [outputNames] limits the run to these outputs, e.g. one head of a multi-head model. On Linux and
+  /// web the other outputs are neither computed (where no requested output depends on them) nor
+  /// allocated; other platforms still return every output.
+  /// [scope] is the [OrtScope] the outputs join, if any (Linux)
   ///
   /// Returns a map of output names to OrtValue objects if successful, otherwise throws an exception
   ///
@@ -44,11 +79,18 @@ class OrtSession {
   /// };
   /// final outputs = await session.run(inputs);
   /// ```
-  Future<Map<String, OrtValue>> run(Map<String, OrtValue> inputs, {OrtRunOptions? options}) async {
+  Future<Map<String, OrtValue>> run(
+    Map<String, OrtValue> inputs, {
+    OrtRunOptions? options,
+    List<String>? outputNames,
+    OrtScope? scope,
+  }) async {
     final result = await FlutterOnnxruntimePlatform.instance.runInference(
       id,
       inputs,
       runOptions: options?.toMap() ?? {},
+      outputNames: outputNames,
+      scopeId: scope?.id,
     );
     final outputs = <String, OrtValue>{};
     for (final entry in result.entries) {
@@ -58,6 +100,210 @@ class OrtSession {
     return outputs;
   }
 
+  /// Run inference on Dart data in a single call, without creating or disposing any OrtValue
+  ///
+  /// The inputs are created natively, the model runs, and the outputs in [outputNames] (all of them
+  /// when null) are copied back and freed before the call returns. Typed lists (e.g. Float32List) are
+  /// read natively in place, so this suits simple stateless models fed fresh data on every run.
+  ///
+  /// Example:
+  /// ```dart
+  /// final outputs = await session.runWithData(
+  ///   {'images': OrtTensorData(pixels, [1, 3, 224, 224])},
+  ///   outputNames: ['scores'],
+  /// );
+  /// final scores = outputs['scores']!.data as Float32List;
+  /// ```
+  ///
+  /// Note: currently only supported on Linux.
+  Future<Map<String, OrtTensorData>> runWithData(
+    Map<String, OrtTensorData> inputs, {
+    List<String>? outputNames,
+    OrtRunOptions? options,
+  }) async {
+    final result = await FlutterOnnxruntimePlatform.instance.runWithData(
+      id,
+      inputs.map((name, input) => MapEntry(name, input.toMap())),
+      outputNames: outputNames,
+      runOptions: options?.toMap() ?? {},
+    );
+    return result.map((name, output) => MapEntry(name, OrtTensorData.fromMap(output)));
+  }
+
+  /// Run several sessions on the same inputs at once, e.g. an ensemble of models on one face crop
+  ///
+  /// The sessions run concurrently natively and share the input tensors without copying them; string
+  /// tensors are copied for each session. Each session receives the inputs its model declares, so one
+  /// map can serve models with different inputs.
+  ///
+  /// Returns one output map per session, in the order of [sessions]. Throws if any run fails. The
+  /// outputs join [scope], if given.
+  ///
+  /// Example:
+  /// ```dart
+  /// final results = await OrtSession.runMany([ageModel, emotionModel, landmarkModel], {'image': face});
+  /// final age = results[0]['age'];
+  /// ```
+  ///
+  /// Note: currently only supported on Linux.
+  static Future<List<Map<String, OrtValue>>> runMany(
+    List<OrtSession> sessions,
+    Map<String, OrtValue> inputs, {
+    OrtRunOptions? options,
+    OrtScope? scope,
+  }) async {
+    final results = await FlutterOnnxruntimePlatform.instance.runMany(
+      sessions.map((session) => session.id).toList(),
+      inputs,
+      runOptions: options?.toMap() ?? {},
+      scopeId: scope?.id,
+    );
+    return results.map((result) {
+      final outputs = <String, OrtValue>{};
+      for (final entry in result.entries) {
+        final tensorMap = {'valueId': entry.value[0], 'dataType': entry.value[1], 'shape': entry.value[2]};
+        outputs[entry.key] = OrtValue.fromMap(tensorMap);
+      }
+      return outputs;
+    }).toList();
+  }
+
+  /// Make the session stateful by feeding outputs back as inputs on the next run
+  ///
+  /// [bindings] maps each output name to the input name it feeds on the next run, e.g.
+  /// `{'present.0.key': 'past_key_values.0.key'}` for a transformer KV cache or
+  /// `{'hidden_out': 'hidden_in'}` for an RNN.
+  ///
+  /// The state tensors never leave native memory: bound outputs are not returned by [run], and
+  /// bound inputs are filled from the previous run unless passed explicitly. Pass the initial state
+  /// as regular inputs on the first run. An empty map turns stateful mode off.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> setStateBindings(Map<String, String> bindings) async {
+    await FlutterOnnxruntimePlatform.instance.setStateBindings(id, bindings);
+  }
+
+  /// Drop the state carried between runs so the next run starts a new sequence
+  ///
+  /// The bindings set with [setStateBindings] are kept. Throws a `BUSY` error while [generate] is
+  /// running on this session.
+  Future<void> resetState() async {
+    await FlutterOnnxruntimePlatform.instance.resetState(id);
+  }
+
+  /// Supply [value] for the input [name] on every run that does not pass it explicitly
+  ///
+  /// Meant for inputs that never change between runs, such as fixed attention masks, config
+  /// scalars or speaker embeddings: the tensor is copied natively once and then fed to every run
+  /// without being sent, looked up or copied again. [value] may be disposed afterwards. Passing
+  /// null removes the constant input.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> setConstantInput(String name, OrtValue? value) async {
+    await FlutterOnnxruntimePlatform.instance.setConstantInput(id, name, value?.id);
+  }
+
+  /// Cache results so that running identical inputs again skips the model
+  ///
+  /// Inputs are keyed by name, data type, shape and content. Up to [maxEntries] results are kept,
+  /// holding at most [maxBytes] of output data and the inputs kept to verify hits, and the least
+  /// recently used result is evicted first.
+  /// Stateful runs and string tensors bypass the cache. Calling this again drops the cached results.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> enableResultCache({int maxEntries = 16, int maxBytes = 64 * 1024 * 1024}) async {
+    await FlutterOnnxruntimePlatform.instance.configureResultCache(id, maxEntries, maxBytes);
+  }
+
+  /// Turn the result cache off and release the cached results
+  Future<void> disableResultCache() async {
+    await FlutterOnnxruntimePlatform.instance.configureResultCache(id, 0, 0);
+  }
+
+  /// Pad variable-length inputs to a few fixed sizes so ONNX Runtime sees few distinct shapes
+  ///
+  /// Every input dimension named [dimension] (e.g. 'seq_len') is padded with zeros to the smallest of
+  /// [buckets] that fits, and outputs having that dimension are cropped back, so memory patterns are
+  /// reused and the arena stops growing with every new length. [maskInput] (e.g. 'attention_mask') is
+  /// filled with 1 for real and 0 for padded positions unless a run passes it; a passed mask is padded
+  /// with zeros. Inputs longer than the largest bucket and stateful runs are not padded. Constant inputs
+  /// are never padded either, so enabling fails if one has [dimension], and so does setting such a
+  /// constant input while bucketing is on.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> enableBucketing({required String dimension, required List<int> buckets, String? maskInput}) async {
+    await FlutterOnnxruntimePlatform.instance.configureBucketing(id, dimension, buckets, maskInput: maskInput);
+  }
+
+  /// Run inputs at their own size again
+  Future<void> disableBucketing() async {
+    await FlutterOnnxruntimePlatform.instance.configureBucketing(id, '', []);
+  }
+
+  /// Let [run] take inputs whose numeric type differs from the one the model declares
+  ///
+  /// With [enabled], an int32 tensor for an int64 input or a float32 tensor for a float16 input is
+  /// converted natively as part of the run, instead of through [OrtValue.to], which registers a new
+  /// tensor and costs an extra call. The converted copy is never registered and its buffer is reused
+  /// by later runs. Off by default, so mismatched types are reported as errors. Inputs of a type the
+  /// conversion does not handle (bfloat16, complex, string), or fed to such an input, are passed on
+  /// unchanged.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> setInputCasting(bool enabled) async {
+    await FlutterOnnxruntimePlatform.instance.setInputCasting(id, enabled);
+  }
+
+  /// Get the hit and miss counters and the size of the result cache
+  Future<OrtResultCacheStats> getResultCacheStats() async {
+    final result = await FlutterOnnxruntimePlatform.instance.getResultCacheStats(id);
+    return OrtResultCacheStats.fromMap(result);
+  }
+
+  /// Replace the model behind this session without interrupting it, e.g. after an over-the-air update
+  ///
+  /// The new model is loaded in the background and, with [warmUp], run once on zero-filled inputs
+  /// before it takes over. Runs already in flight finish on the old model, which is released after
+  /// the last of them. Held state and cached results are dropped; state bindings, constant inputs and
+  /// bucketing are kept and must still match the new model. If loading fails, the session keeps serving
+  /// the old model. Fails as busy while [generate] is running on this session.
+  ///
+  /// Returns this session, updated in place: [inputNames], [outputNames], [getInputInfo],
+  /// [getOutputInfo] and [getMetadata] describe the new model from then on. The session ID is unchanged.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<OrtSession> reload(String modelPath, {OrtSessionOptions? options, bool warmUp = true}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.reloadSession(
+      id,
+      modelPath,
+      sessionOptions: options?.toMap() ?? {},
+      warmUp: warmUp,
+    );
+    final reloaded = OrtSession.fromMap(result);
+    _inputNames = reloaded._inputNames;
+    _outputNames = reloaded._outputNames;
+    _inputInfo = reloaded._inputInfo;
+    _outputInfo = reloaded._outputInfo;
+    _metadata = reloaded._metadata;
+    return this;
+  }
+
+  /// Generate tokens from a decoder model, running the decode loop natively
+  ///
+  /// [promptIds] are the prompt token IDs. Each generated token is emitted as soon as it is
+  /// sampled, and the stream closes when a stop token or the maximum length is reached.
+  /// Cancelling the subscription stops generation.
+  ///
+  /// Unless [setStateBindings] was called, `present*` outputs are bound to the matching
+  /// `past_key_values*` inputs so the KV cache stays native between steps. Generation starts from
+  /// empty state and puts the session's bindings and held state back when it ends. Meanwhile other
+  /// runs, state changes and another [generate] on this session fail as busy.
+  ///
+  /// Note: currently only supported on Linux.
+  Stream<int> generate(List<int> promptIds, {OrtGenerationConfig? config}) {
+    return FlutterOnnxruntimePlatform.instance.generate(id, promptIds, config: config?.toMap());
+  }
+
   Future<void> close() async {
     await FlutterOnnxruntimePlatform.instance.closeSession(id);
   }
@@ -66,7 +312,12 @@ class OrtSession {
   ///
   /// Returns information about the model such as producer name, graph name,
   /// domain, description, version, and custom metadata.
+  /// On Linux the metadata comes with the opened or reloaded session, so no platform call is made.
   Future<OrtModelMetadata> getMetadata() async {
+    final metadata = _metadata;
+    if (metadata != null) {
+      return metadata;
+    }
     final metadataMap = await FlutterOnnxruntimePlatform.instance.getMetadata(id);
     return OrtModelMetadata.fromMap(metadataMap);
   }
@@ -74,7 +325,12 @@ class OrtSession {
   /// Get input info about the model
   ///
   /// Returns information about the model's inputs such as name, type, and shape.
+  /// On Linux the info comes with the opened or reloaded session, so no platform call is made.
   Future<List<Map<String, dynamic>>> getInputInfo() async {
+    final inputInfo = _inputInfo;
+    if (inputInfo != null) {
+      return inputInfo.map((info) => Map<String, dynamic>.from(info)).toList();
+    }
     final inputInfoMap = await FlutterOnnxruntimePlatform.instance.getInputInfo(id);
     return inputInfoMap.map((info) => Map<String, dynamic>.from(info)).toList();
   }
@@ -82,7 +338,12 @@ class OrtSession {
   /// Get output info about the model
   ///
   /// Returns information about the model's outputs such as name, type, and shape.
+  /// On Linux the info comes with the opened or reloaded session, so no platform call is made.
   Future<List<Map<String, dynamic>>> getOutputInfo() async {
+    final outputInfo = _outputInfo;
+    if (outputInfo != null) {
+      return outputInfo.map((info) => Map<String, dynamic>.from(info)).toList();
+    }
     final outputInfoMap = await FlutterOnnxruntimePlatform.instance.getOutputInfo(id);
     return outputInfoMap.map((info) => Map<String, dynamic>.from(info)).toList();
   }
@@ -100,8 +361,32 @@ class OrtSessionOptions {
   final bool? useArena;
   // set the device id for the session, default is 0
   final int? deviceId;
+  // fix symbolic dimensions to a size so the model is optimized for static shapes (Linux), by dimension name,
+  // e.g. {'batch': 1}, or by denotation, e.g. {'DATA_BATCH': 1}
+  final Map<String, int>? freeDimensionOverrides;
+  final Map<String, int>? freeDimensionOverridesByDenotation;
+  // extra copies of the model, each with these dimensions fixed by name, e.g. [{'seq_len': 128}, {'seq_len': 512}].
+  // A run whose inputs have exactly the dimensions of a variant runs on it (Linux, createSession only).
+  final List<Map<String, int>>? shapeVariants;
+  // apply the thread settings stored by OnnxRuntime.autotuneSession for this model and CPU, if any (Linux);
+  // intraOpNumThreads and interOpNumThreads still override them
+  final bool? useTunedOptions;
+  // options passed to each provider by name, e.g. {OrtProvider.XNNPACK: {'intra_op_num_threads': '4'}} (Linux).
+  // Values may also be numbers or booleans; see the provider's ONNX Runtime documentation for its option names.
+  final Map<OrtProvider, Map<String, Object>>? providerOptions;
 
-  OrtSessionOptions({this.intraOpNumThreads, this.interOpNumThreads, this.providers, this.useArena, this.deviceId});
+  OrtSessionOptions({
+    this.intraOpNumThreads,
+    this.interOpNumThreads,
+    this.providers,
+    this.useArena,
+    this.deviceId,
+    this.freeDimensionOverrides,
+    this.freeDimensionOverridesByDenotation,
+    this.shapeVariants,
+    this.useTunedOptions,
+    this.providerOptions,
+  });
 
   Map<String, dynamic> toMap() {
     return {
@@ -110,6 +395,13 @@ class OrtSessionOptions {
       if (providers != null && providers!.isNotEmpty) 'providers': providers!.map((p) => p.name).toList(),
       if (useArena != null) 'useArena': useArena,
       if (deviceId != null) 'deviceId': deviceId,
+      if (freeDimensionOverrides != null) 'freeDimensionOverrides': freeDimensionOverrides,
+      if (freeDimensionOverridesByDenotation != null)
+        'freeDimensionOverridesByDenotation': freeDimensionOverridesByDenotation,
+      if (shapeVariants != null) 'shapeVariants': shapeVariants,
+      if (useTunedOptions != null) 'useTunedOptions': useTunedOptions,
+      if (providerOptions != null)
+        'providerOptions': providerOptions!.map((provider, options) => MapEntry(provider.name, options)),
     };
   }
 }
@@ -125,14 +417,102 @@ class OrtRunOptions {
   final int? logVerbosityLevel;
   // terminate all incomplete inference using this instance as soon as possible
   final bool? terminate;
+  // LoRA adapters applied on top of the session's base model for this run only (Linux)
+  final List<OrtLoraAdapter>? loraAdapters;
 
-  OrtRunOptions({this.logSeverityLevel, this.logVerbosityLevel, this.terminate});
+  OrtRunOptions({this.logSeverityLevel, this.logVerbosityLevel, this.terminate, this.loraAdapters});
 
   Map<String, dynamic> toMap() {
     return {
       if (logSeverityLevel != null) 'logSeverityLevel': logSeverityLevel,
       if (logVerbosityLevel != null) 'logVerbosityLevel': logVerbosityLevel,
       if (terminate != null) 'terminate': terminate,
+      if (loraAdapters != null) 'loraAdapters': loraAdapters!.map((adapter) => adapter.id).toList(),
+    };
+  }
+}
+
+/// Counters of a session's result cache
+class OrtResultCacheStats {
+  final int hits;
+  final int misses;
+  final int evictions;
+  // results and bytes of output data currently cached
+  final int entries;
+  final int bytes;
+  final int maxEntries;
+  final int maxBytes;
+
+  OrtResultCacheStats({
+    required this.hits,
+    required this.misses,
+    required this.evictions,
+    required this.entries,
+    required this.bytes,
+    required this.maxEntries,
+    required this.maxBytes,
+  });
+
+  factory OrtResultCacheStats.fromMap(Map<String, dynamic> map) {
+    return OrtResultCacheStats(
+      hits: map['hits'] as int? ?? 0,
+      misses: map['misses'] as int? ?? 0,
+      evictions: map['evictions'] as int? ?? 0,
+      entries: map['entries'] as int? ?? 0,
+      bytes: map['bytes'] as int? ?? 0,
+      maxEntries: map['maxEntries'] as int? ?? 0,
+      maxBytes: map['maxBytes'] as int? ?? 0,
+    );
+  }
+
+  // share of lookups answered from the cache
+  double get hitRate => hits + misses == 0 ? 0 : hits / (hits + misses);
+}
+
+class OrtGenerationConfig {
+  // total sequence length (prompt plus generated tokens) at which generation stops
+  final int? maxLength;
+  // token IDs that end generation; the stop token itself is emitted
+  final List<int>? stopTokens;
+  // 0 = greedy decoding
+  final double? temperature;
+  // sample from the k most likely tokens only, 0 = disabled
+  final int? topK;
+  // sample from the smallest set of tokens whose probability mass reaches topP, 1 = disabled
+  final double? topP;
+  // seed of the sampling random number generator
+  final int? seed;
+  // model input and output names, default to the usual Hugging Face export names
+  final String? inputIdsName;
+  final String? attentionMaskName;
+  final String? positionIdsName;
+  final String? logitsName;
+
+  OrtGenerationConfig({
+    this.maxLength,
+    this.stopTokens,
+    this.temperature,
+    this.topK,
+    this.topP,
+    this.seed,
+    this.inputIdsName,
+    this.attentionMaskName,
+    this.positionIdsName,
+    this.logitsName,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      if (maxLength != null) 'maxLength': maxLength,
+      if (stopTokens != null) 'stopTokens': stopTokens,
+      if (temperature != null) 'temperature': temperature,
+      if (topK != null) 'topK': topK,
+      if (topP != null) 'topP': topP,
+      if (seed != null) 'seed': seed,
+      if (inputIdsName != null) 'inputIdsName': inputIdsName,
+      if (attentionMaskName != null) 'attentionMaskName': attentionMaskName,
+      if (positionIdsName != null) 'positionIdsName': positionIdsName,
+      if (logitsName != null) 'logitsName': logitsName,
     };
   }
 }
@@ -7,6 +7,7 @@
 import 'dart:typed_data';
 
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_scope.dart';
 
 /// Represents a data type in ONNX Runtime
 enum OrtDataType {
@@ -81,51 +82,28 @@ class OrtValue {
   ///
   /// [data] is the data to create the tensor from (any supported list type)
   /// [shape] is the shape of the tensor
-  static Future<OrtValue> fromList(dynamic data, List<int> shape) async {
-    // If data is a regular List, convert it to the appropriate TypedData
-    if (data is List &&
-        !(data is Float32List || data is Int32List || data is Int64List || data is Uint8List || data is List<String>)) {
-      data = _convertListToTypedData(data);
-    }
-
-    // Validate data length against shape
-    int expectedElements = _calculateExpectedElements(shape);
-    int actualElements = _getElementCount(data);
-
-    if (expectedElements != -1 && actualElements != expectedElements) {
-      throw ArgumentError(
-        'Shape/data size mismatch: data has $actualElements elements, '
-        'but shape $shape requires $expectedElements elements',
-      );
-    }
-
-    String sourceType;
-
-    if (data is Float32List) {
-      sourceType = 'float32';
-    } else if (data is Int32List) {
-      sourceType = 'int32';
-    } else if (data is Int64List) {
-      sourceType = 'int64';
-    } else if (data is Uint8List) {
-      sourceType = 'uint8';
-    } else if (data is List<bool>) {
-      sourceType = 'bool';
-    } else if (data is List<String>) {
-      sourceType = 'string';
-    } else {
-      throw ArgumentError('Unsupported data type: ${data.runtimeType}');
-    }
-
-    final result = await FlutterOnnxruntimePlatform.instance.createOrtValue(sourceType, data, shape);
+  /// [scope] is the [OrtScope] the value joins, if any
+  static Future<OrtValue> fromList(dynamic data, List<int> shape, {OrtScope? scope}) async {
+    final args = createOrtValueArgs(data, shape);
+    final result = await FlutterOnnxruntimePlatform.instance.createOrtValue(
+      args['sourceType'],
+      args['data'],
+      shape,
+      scopeId: scope?.id,
+    );
     return OrtValue.fromMap(result);
   }
 
   /// Convert this tensor to a different data type
   ///
   /// [targetType] is the target data type to convert to
-  Future<OrtValue> to(OrtDataType targetType) async {
-    final result = await FlutterOnnxruntimePlatform.instance.convertOrtValue(id, targetType.toString().split('.').last);
+  /// [scope] is the [OrtScope] the converted value joins, if any
+  Future<OrtValue> to(OrtDataType targetType, {OrtScope? scope}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.convertOrtValue(
+      id,
+      targetType.toString().split('.').last,
+      scopeId: scope?.id,
+    );
     return OrtValue.fromMap(result);
   }
 
@@ -163,6 +141,21 @@ class OrtValue {
     await FlutterOnnxruntimePlatform.instance.releaseOrtValue(id);
   }
 
+  /// Keep this run output even when the tensor memory budget is exceeded
+  ///
+  /// See [OnnxRuntime.configureTensorBudget]. Tensors created from Dart data are never evicted and
+  /// need no pinning.
+  ///
+  /// Note: currently only supported on Linux.
+  Future<void> pin() async {
+    await FlutterOnnxruntimePlatform.instance.pinOrtValue(id, true);
+  }
+
+  /// Let the tensor memory budget evict this run output again
+  Future<void> unpin() async {
+    await FlutterOnnxruntimePlatform.instance.pinOrtValue(id, false);
+  }
+
   /// Converts a regular List to appropriate TypedData based on content
   static dynamic _convertListToTypedData(List data) {
     if (data.isEmpty) {
@@ -293,3 +286,80 @@ class OrtValue {
     return result;
   }
 }
+
+/// Tensor data held in Dart, passed to and returned by [OrtSession.runWithData] instead of an [OrtValue]
+class OrtTensorData {
+  final OrtDataType dataType;
+  final List<int> shape;
+  // flat elements; a typed list (e.g. Float32List) for float32, int32, int64 and uint8 results
+  final List<dynamic> data;
+
+  OrtTensorData._(this.dataType, this.shape, this.data);
+
+  /// Wrap [data] with the given [shape]; the data type is detected as in [OrtValue.fromList]
+  factory OrtTensorData(dynamic data, List<int> shape) {
+    final args = createOrtValueArgs(data, shape);
+    return OrtTensorData._(
+      OrtDataType.values.firstWhere((dt) => dt.toString() == 'OrtDataType.${args['sourceType']}'),
+      shape,
+      args['data'] as List<dynamic>,
+    );
+  }
+
+  factory OrtTensorData.fromMap(Map<String, dynamic> map) {
+    return OrtTensorData._(
+      OrtDataType.values.firstWhere(
+        (dt) => dt.toString() == 'OrtDataType.${map['dataType']}',
+        orElse: () => throw ArgumentError('Invalid data type: ${map['dataType']}'),
+      ),
+      List<int>.from(map['shape'] ?? []),
+      map['data'] as List<dynamic>,
+    );
+  }
+
+  Map<String, dynamic> toMap() {
+    return {'dataType': dataType.toString().split('.').last, 'shape': shape, 'data': data};
+  }
+}
+
+/// Validate Dart data for a new tensor and return the 'createOrtValue' arguments for it
+///
+/// Shared by [OrtValue.fromList], [OrtTensorData] and batched creation; not exported from the package.
+Map<String, dynamic> createOrtValueArgs(dynamic data, List<int> shape) {
+  // If data is a regular List, convert it to the appropriate TypedData
+  if (data is List &&
+      !(data is Float32List || data is Int32List || data is Int64List || data is Uint8List || data is List<String>)) {
+    data = OrtValue._convertListToTypedData(data);
+  }
+
+  // Validate data length against shape
+  int expectedElements = OrtValue._calculateExpectedElements(shape);
+  int actualElements = OrtValue._getElementCount(data);
+
+  if (expectedElements != -1 && actualElements != expectedElements) {
+    throw ArgumentError(
+      'Shape/data size mismatch: data has $actualElements elements, '
+      'but shape $shape requires $expectedElements elements',
+    );
+  }
+
+  String sourceType;
+
+  if (data is Float32List) {
+    sourceType = 'float32';
+  } else if (data is Int32List) {
+    sourceType = 'int32';
+  } else if (data is Int64List) {
+    sourceType = 'int64';
+  } else if (data is Uint8List) {
+    sourceType = 'uint8';
+  } else if (data is List<bool>) {
+    sourceType = 'bool';
+  } else if (data is List<String>) {
+    sourceType = 'string';
+  } else {
+    throw ArgumentError('Unsupported data type: ${data.runtimeType}');
+  }
+
+  return {'sourceType': sourceType, 'data': data, 'shape': shape};
+}
@@ -242,6 +242,8 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) async {
     try {
       // Check if the session exists
@@ -289,20 +291,24 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
         }
       }
 
-      // Run inference
-      final runPromise =
-          jsRunOptions != null
-              ? callMethod(session, 'run', [jsInputs, jsRunOptions])
-              : callMethod(session, 'run', [jsInputs]);
+      // Run inference; requested output names are passed as the fetches argument
+      final runArgs = <dynamic>[jsInputs];
+      if (outputNames != null) {
+        runArgs.add(js_util.jsify(outputNames));
+      }
+      if (jsRunOptions != null) {
+        runArgs.add(jsRunOptions);
+      }
+      final runPromise = callMethod(session, 'run', runArgs);
 
       // Wait for the promise to resolve
       final jsOutputs = await promiseToFuture<JSObject>(runPromise);
 
       // Process outputs - create OrtValue objects for each output
       final outputMap = <String, dynamic>{};
-      final outputNames = getOutputNames(session);
+      final sessionOutputNames = getOutputNames(session);
 
-      for (final name in outputNames) {
+      for (final name in sessionOutputNames) {
         if (hasProperty(jsOutputs, name)) {
           final tensor = getProperty(jsOutputs, name);
 
@@ -631,7 +637,12 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
   final Map<String, JSObject> _ortValues = {};
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) async {
+  Future<Map<String, dynamic>> createOrtValue(
+    String sourceType,
+    dynamic data,
+    List<int> shape, {
+    String? scopeId,
+  }) async {
     try {
       // Get the Tensor constructor from onnxruntime-web
       final tensorClass = getProperty(_ort, 'Tensor');
@@ -875,7 +886,7 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) async {
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) async {
     try {
       // Check if the tensor exists
       if (!_ortValues.containsKey(valueId)) {
@@ -0,0 +1,129 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "event_stream.h"
+#include <iterator>
+
+EventStream::EventStream(FlBinaryMessenger *messenger, const char *name, size_t capacity)
+    : capacity_(capacity), listening_(false), closed_(false), drain_source_(0) {
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  channel_ = fl_event_channel_new(messenger, name, FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(channel_, onListen, onCancel, this, nullptr);
+}
+
+EventStream::~EventStream() {
+  close();
+
+  // Closed streams schedule no new drain, so the source read here is the last one
+  guint drain_source;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drain_source = drain_source_;
+    drain_source_ = 0;
+  }
+  if (drain_source != 0) {
+    g_source_remove(drain_source);
+  }
+  g_object_unref(channel_);
+}
+
+bool EventStream::push(FlValue *event, bool wait, DropCallback on_dropped) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (wait) {
+    not_full_.wait(lock, [this] { return closed_ || !listening_ || queue_.size() < capacity_; });
+  }
+  if (closed_ || !listening_ || queue_.size() >= capacity_) {
+    lock.unlock();
+    fl_value_unref(event);
+    if (on_dropped) {
+      on_dropped();
+    }
+    return false;
+  }
+
+  queue_.push_back({event, std::move(on_dropped)});
+  if (drain_source_ == 0) {
+    drain_source_ = g_idle_add_full(G_PRIORITY_DEFAULT, drain, this, nullptr);
+  }
+  return true;
+}
+
+bool EventStream::isListening() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return listening_ && !closed_;
+}
+
+void EventStream::close() {
+  std::vector<QueuedEvent> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    dropped = takeQueue();
+  }
+  dropEvents(dropped);
+}
+
+std::vector<EventStream::QueuedEvent> EventStream::takeQueue() {
+  std::vector<QueuedEvent> events(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.end()));
+  queue_.clear();
+  not_full_.notify_all();
+  return events;
+}
+
+void EventStream::dropEvents(std::vector<QueuedEvent> &events) {
+  for (auto &queued : events) {
+    fl_value_unref(queued.event);
+    if (queued.on_dropped) {
+      queued.on_dropped();
+    }
+  }
+  events.clear();
+}
+
+FlMethodErrorResponse *EventStream::onListen(FlEventChannel *channel, FlValue *args, gpointer user_data) {
+  EventStream *self = static_cast<EventStream *>(user_data);
+  std::lock_guard<std::mutex> lock(self->mutex_);
+  self->listening_ = true;
+  return nullptr;
+}
+
+FlMethodErrorResponse *EventStream::onCancel(FlEventChannel *channel, FlValue *args, gpointer user_data) {
+  EventStream *self = static_cast<EventStream *>(user_data);
+  std::vector<QueuedEvent> dropped;
+  {
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->listening_ = false;
+    dropped = self->takeQueue();
+  }
+  dropEvents(dropped);
+  return nullptr;
+}
+
+// Runs on the platform thread: send everything queued so far
+gboolean EventStream::drain(gpointer user_data) {
+  EventStream *self = static_cast<EventStream *>(user_data);
+
+  std::vector<QueuedEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    events = self->takeQueue();
+    self->drain_source_ = 0;
+  }
+
+  for (auto &queued : events) {
+    g_autoptr(GError) error = nullptr;
+    if (!fl_event_channel_send(self->channel_, queued.event, nullptr, &error)) {
+      g_warning("Failed to send event: %s", error->message);
+      if (queued.on_dropped) {
+        queued.on_dropped();
+      }
+    }
+    fl_value_unref(queued.event);
+  }
+
+  return G_SOURCE_REMOVE;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <condition_variable>
+#include <deque>
+#include <flutter_linux/flutter_linux.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Pushes results from native jobs to Dart over an FlEventChannel.
+//
+// Producers may run on any thread; events are queued and sent from the platform thread. The queue is
+// bounded: once `capacity` events are waiting, push() either blocks the producer until the platform
+// thread catches up or drops the event, so a fast job cannot flood the engine.
+//
+// The bound only reflects draining on the platform thread. Once sent, an event sits in the engine and the Dart
+// isolate without any limit, so a Dart listener slower than the platform thread does not throttle producers.
+class EventStream {
+public:
+  EventStream(FlBinaryMessenger *messenger, const char *name, size_t capacity);
+  ~EventStream();
+
+  // Called for an event that never reached the channel, on the thread that dropped it and without any lock
+  // held, so it may free what the event refers to
+  using DropCallback = std::function<void()>;
+
+  // Queue an event for Dart, taking ownership of it. With `wait` the call blocks while the queue is full,
+  // so it must not be made from the platform thread. Returns false if the event was dropped because
+  // nobody is listening, the queue is full (without `wait`) or the stream is closed. `on_dropped` runs
+  // then, and also if a queued event is dropped later by a cancel, close or failed send.
+  bool push(FlValue *event, bool wait = true, DropCallback on_dropped = nullptr);
+
+  // Whether Dart is currently listening
+  bool isListening();
+
+  // Stop accepting events and release blocked producers
+  void close();
+
+private:
+  static FlMethodErrorResponse *onListen(FlEventChannel *channel, FlValue *args, gpointer user_data);
+  static FlMethodErrorResponse *onCancel(FlEventChannel *channel, FlValue *args, gpointer user_data);
+  static gboolean drain(gpointer user_data);
+
+  struct QueuedEvent {
+    FlValue *event;
+    DropCallback on_dropped;
+  };
+
+  // Take the queued events out and wake blocked producers. Callers hold mutex_ and pass the result to
+  // dropEvents once it is released.
+  std::vector<QueuedEvent> takeQueue();
+
+  static void dropEvents(std::vector<QueuedEvent> &events);
+
+  FlEventChannel *channel_;
+  size_t capacity_;
+
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::deque<QueuedEvent> queue_;
+  bool listening_;
+  bool closed_;
+
+  // Idle source sending the queued events, 0 when none is scheduled. Guarded by mutex_.
+  guint drain_source_;
+};
+
+#endif // EVENT_STREAM_H
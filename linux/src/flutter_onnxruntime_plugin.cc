@@ -10,14 +10,23 @@
 #include <gtk/gtk.h>
 #include <sys/utsname.h>
 
+#include "event_stream.h"
+#include "generation.h"
+#include "lora_adapter_manager.h"
+#include "pipeline_manager.h"
+#include "result_cache.h"
 #include "session_manager.h"
+#include "session_tuner.h"
 #include "tensor_manager.h"
+#include "tensor_ops.h"
 #include "value_conversion.h"
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <onnxruntime_cxx_api.h>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -33,9 +42,24 @@ struct _FlutterOnnxruntimePlugin {
   // TensorManager for handling OrtValue objects
   TensorManager *tensor_manager;
 
+  // PipelineManager for chaining sessions natively
+  PipelineManager *pipeline_manager;
+
+  // SessionTuner picking and remembering thread settings per model
+  SessionTuner *session_tuner;
+
+  // LoraAdapterManager holding adapters that runs activate on top of a base model
+  LoraAdapterManager *lora_adapter_manager;
+
   // Maps to store value data
   std::map<std::string, void *> values;
 
+  // Cancellation flags of in-flight generate calls, keyed by generation ID (guarded by mutex)
+  std::map<std::string, std::shared_ptr<std::atomic<bool>>> generations;
+
+  // Event channel pushing results of long-running jobs (e.g. generated tokens) to Dart
+  EventStream *event_stream;
+
   // Mutex for thread safety
   std::mutex mutex;
 };
@@ -46,24 +70,63 @@ G_DEFINE_TYPE(FlutterOnnxruntimePlugin, flutter_onnxruntime_plugin, g_object_get
 static void flutter_onnxruntime_plugin_dispose(GObject *object);
 static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call);
 static void method_call_handler(FlMethodChannel *channel, FlMethodCall *method_call, gpointer user_data);
+static FlMethodResponse *dispatch_sync_method(FlutterOnnxruntimePlugin *self, const gchar *method, FlValue *args);
 
 // Helper function to get platform version
 static FlMethodResponse *get_platform_version();
 
 // Session management
 static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *preload_sessions(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args);
+static FlMethodResponse *reload_session(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args);
+static FlMethodResponse *autotune_session(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args);
 static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_model_cache(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_model_cache_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_memory_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_many(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_with_data(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_state_bindings(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *reset_state(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_constant_input(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_result_cache(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_result_cache_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_bucketing(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_input_casting(FlutterOnnxruntimePlugin *self, FlValue *args);
+
+// LoRA adapters
+static FlMethodResponse *load_lora_adapter(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *release_lora_adapter(FlutterOnnxruntimePlugin *self, FlValue *args);
+
+// Generation
+static FlMethodResponse *generate(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args);
+static FlMethodResponse *cancel_generation(FlutterOnnxruntimePlugin *self, FlValue *args);
+
+// Pipelines
+static FlMethodResponse *create_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *close_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *start_pipeline_stream(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *push_pipeline_frame(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *stop_pipeline_stream(FlutterOnnxruntimePlugin *self, FlValue *args);
 
 // OrtValue operations
 static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *release_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *pin_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_tensor_budget(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *begin_scope(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *release_scope(FlutterOnnxruntimePlugin *self, FlValue *args);
+
+// Batches
+static FlMethodResponse *execute_batch(FlutterOnnxruntimePlugin *self, FlValue *args);
 
 // Helper function to map C++ API provider names to OrtProvider enum names
 static std::string mapProviderNameToEnumName(const std::string &providerName) {
@@ -82,7 +145,9 @@ static std::string mapProviderNameToEnumName(const std::string &providerName) {
       {"DmlExecutionProvider", "DIRECT_ML"},
       {"ACLExecutionProvider", "ACL"},
       {"ArmNNExecutionProvider", "ARM_NN"},
-      {"XnnpackExecutionProvider", "XNNPACK"}};
+      {"XnnpackExecutionProvider", "XNNPACK"},
+      {"AzureExecutionProvider", "AZURE"},
+      {"WebGpuExecutionProvider", "WEB_GPU"}};
 
   auto it = providerNameMap.find(providerName);
   if (it != providerNameMap.end()) {
@@ -102,15 +167,32 @@ static void flutter_onnxruntime_plugin_class_init(FlutterOnnxruntimePluginClass
 static void flutter_onnxruntime_plugin_init(FlutterOnnxruntimePlugin *self) {
   self->session_manager = new SessionManager();
   self->tensor_manager = new TensorManager();
+  self->pipeline_manager = new PipelineManager(self->session_manager);
+
+  // Tuned options outlive the app, like other caches of the user
+  g_autofree gchar *tuning_store =
+      g_build_filename(g_get_user_cache_dir(), "flutter_onnxruntime", "tuned_options.tsv", nullptr);
+  self->session_tuner = new SessionTuner(self->session_manager, tuning_store);
+  self->lora_adapter_manager = new LoraAdapterManager();
 }
 
 static void flutter_onnxruntime_plugin_dispose(GObject *object) {
   FlutterOnnxruntimePlugin *self = FLUTTER_ONNXRUNTIME_PLUGIN(object);
 
-  // Clean up session manager, tensor manager and values
+  // Release stream workers blocked on a full event channel, so deleting the pipeline manager can join them
+  if (self->event_stream != nullptr) {
+    self->event_stream->close();
+  }
+
+  // Clean up pipeline manager, session tuner, session manager, adapters, tensor manager and values
+  delete self->pipeline_manager;
+  delete self->session_tuner;
   delete self->session_manager;
+  delete self->lora_adapter_manager;
   delete self->tensor_manager;
 
+  delete self->event_stream;
+
   std::lock_guard<std::mutex> lock(self->mutex);
   self->values.clear();
 
@@ -129,6 +211,22 @@ void flutter_onnxruntime_plugin_register_with_registrar(FlPluginRegistrar *regis
   // Setup method call handler
   fl_method_channel_set_method_call_handler(channel, method_call_handler, g_object_ref(plugin), g_object_unref);
 
+  // Bounded so a producer faster than the platform thread waits instead of queueing without limit
+  plugin->event_stream =
+      new EventStream(fl_plugin_registrar_get_messenger(registrar), "flutter_onnxruntime/events", 256);
+
+  // Report tensor memory crossing its limits; the tensor manager is locked here, so never wait for Dart
+  plugin->tensor_manager->setMemoryWarningCallback([plugin](const char *level, size_t bytes, size_t limit_bytes) {
+    g_warning("Native tensors hold %zu bytes, over the %s limit of %zu bytes", bytes, level, limit_bytes);
+
+    FlValue *event = fl_value_new_map();
+    fl_value_set_string_take(event, "event", fl_value_new_string("memoryWarning"));
+    fl_value_set_string_take(event, "level", fl_value_new_string(level));
+    fl_value_set_string_take(event, "bytes", fl_value_new_int(static_cast<int64_t>(bytes)));
+    fl_value_set_string_take(event, "limitBytes", fl_value_new_int(static_cast<int64_t>(limit_bytes)));
+    plugin->event_stream->push(event, false);
+  });
+
   g_object_unref(plugin);
 }
 
@@ -146,14 +244,72 @@ static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlug
 
   // Dispatch the call to the appropriate handler function.
   // Each handler function now directly returns an FlMethodResponse.
+  if (strcmp(method, "preloadSessions") == 0) {
+    response = preload_sessions(self, method_call, args);
+    // Models load on background threads and the call responds when all are ready
+    if (response == nullptr) {
+      return;
+    }
+  } else if (strcmp(method, "reloadSession") == 0) {
+    response = reload_session(self, method_call, args);
+    // The new model loads on a background thread while the old one keeps serving
+    if (response == nullptr) {
+      return;
+    }
+  } else if (strcmp(method, "autotuneSession") == 0) {
+    response = autotune_session(self, method_call, args);
+    // Candidates are benchmarked on a background thread for the whole budget
+    if (response == nullptr) {
+      return;
+    }
+  } else if (strcmp(method, "generate") == 0) {
+    response = generate(self, method_call, args);
+    // Generation runs on a worker thread and responds when it finishes
+    if (response == nullptr) {
+      return;
+    }
+  } else if (strcmp(method, "executeBatch") == 0) {
+    response = execute_batch(self, args);
+  } else {
+    response = dispatch_sync_method(self, method, args);
+    if (response == nullptr) {
+      response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    }
+  }
+
+  if (response != nullptr) {
+    fl_method_call_respond(method_call, response, nullptr);
+  } else {
+    // Fallback if no response was created (should ideally not happen)
+    response =
+        FL_METHOD_RESPONSE(fl_method_error_response_new("INTERNAL_ERROR", "Failed to process method call", nullptr));
+    fl_method_call_respond(method_call, response, nullptr);
+  }
+}
+
+// Dispatch a method that responds before returning. Returns nullptr for unknown methods, and for the
+// asynchronous ones, which are handled above.
+static FlMethodResponse *dispatch_sync_method(FlutterOnnxruntimePlugin *self, const gchar *method, FlValue *args) {
+  FlMethodResponse *response = nullptr;
+
   if (strcmp(method, "getPlatformVersion") == 0) {
     response = get_platform_version();
   } else if (strcmp(method, "createSession") == 0) {
     response = create_session(self, args);
   } else if (strcmp(method, "getAvailableProviders") == 0) {
     response = get_available_providers(self, args);
+  } else if (strcmp(method, "configureModelCache") == 0) {
+    response = configure_model_cache(self, args);
+  } else if (strcmp(method, "getModelCacheStats") == 0) {
+    response = get_model_cache_stats(self, args);
+  } else if (strcmp(method, "getMemoryStats") == 0) {
+    response = get_memory_stats(self, args);
   } else if (strcmp(method, "runInference") == 0) {
     response = run_inference(self, args);
+  } else if (strcmp(method, "runMany") == 0) {
+    response = run_many(self, args);
+  } else if (strcmp(method, "runWithData") == 0) {
+    response = run_with_data(self, args);
   } else if (strcmp(method, "closeSession") == 0) {
     response = close_session(self, args);
   } else if (strcmp(method, "getMetadata") == 0) {
@@ -162,6 +318,38 @@ static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlug
     response = get_input_info(self, args);
   } else if (strcmp(method, "getOutputInfo") == 0) {
     response = get_output_info(self, args);
+  } else if (strcmp(method, "setStateBindings") == 0) {
+    response = set_state_bindings(self, args);
+  } else if (strcmp(method, "resetState") == 0) {
+    response = reset_state(self, args);
+  } else if (strcmp(method, "setConstantInput") == 0) {
+    response = set_constant_input(self, args);
+  } else if (strcmp(method, "configureResultCache") == 0) {
+    response = configure_result_cache(self, args);
+  } else if (strcmp(method, "getResultCacheStats") == 0) {
+    response = get_result_cache_stats(self, args);
+  } else if (strcmp(method, "configureBucketing") == 0) {
+    response = configure_bucketing(self, args);
+  } else if (strcmp(method, "setInputCasting") == 0) {
+    response = set_input_casting(self, args);
+  } else if (strcmp(method, "loadLoraAdapter") == 0) {
+    response = load_lora_adapter(self, args);
+  } else if (strcmp(method, "releaseLoraAdapter") == 0) {
+    response = release_lora_adapter(self, args);
+  } else if (strcmp(method, "cancelGeneration") == 0) {
+    response = cancel_generation(self, args);
+  } else if (strcmp(method, "createPipeline") == 0) {
+    response = create_pipeline(self, args);
+  } else if (strcmp(method, "runPipeline") == 0) {
+    response = run_pipeline(self, args);
+  } else if (strcmp(method, "closePipeline") == 0) {
+    response = close_pipeline(self, args);
+  } else if (strcmp(method, "startPipelineStream") == 0) {
+    response = start_pipeline_stream(self, args);
+  } else if (strcmp(method, "pushPipelineFrame") == 0) {
+    response = push_pipeline_frame(self, args);
+  } else if (strcmp(method, "stopPipelineStream") == 0) {
+    response = stop_pipeline_stream(self, args);
   } else if (strcmp(method, "createOrtValue") == 0) {
     response = create_ort_value(self, args);
   } else if (strcmp(method, "convertOrtValue") == 0) {
@@ -170,18 +358,17 @@ static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlug
     response = get_ort_value_data(self, args);
   } else if (strcmp(method, "releaseOrtValue") == 0) {
     response = release_ort_value(self, args);
-  } else {
-    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  } else if (strcmp(method, "pinOrtValue") == 0) {
+    response = pin_ort_value(self, args);
+  } else if (strcmp(method, "configureTensorBudget") == 0) {
+    response = configure_tensor_budget(self, args);
+  } else if (strcmp(method, "beginScope") == 0) {
+    response = begin_scope(self, args);
+  } else if (strcmp(method, "releaseScope") == 0) {
+    response = release_scope(self, args);
   }
 
-  if (response != nullptr) {
-    fl_method_call_respond(method_call, response, nullptr);
-  } else {
-    // Fallback if no response was created (should ideally not happen)
-    response =
-        FL_METHOD_RESPONSE(fl_method_error_response_new("INTERNAL_ERROR", "Failed to process method call", nullptr));
-    fl_method_call_respond(method_call, response, nullptr);
-  }
+  return response;
 }
 
 // Implementation of method functions
@@ -191,19 +378,119 @@ static FlMethodResponse *get_platform_version() {
   return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string(uname_data.version)));
 }
 
-static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
-
-  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+// Read a map of dimension name -> size into `dims`. Null reads as empty. Returns false if the value is not
+// such a map or a size is not positive.
+static bool read_dimension_map(FlValue *value, std::map<std::string, int64_t> &dims) {
+  if (value == nullptr || fl_value_get_type(value) == FL_VALUE_TYPE_NULL) {
+    return true;
+  }
+  if (fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+    return false;
+  }
+  for (const auto &entry : fl_value_to_map(value)) {
+    if (fl_value_get_type(entry.second) != FL_VALUE_TYPE_INT || fl_value_get_int(entry.second) < 1) {
+      return false;
+    }
+    dims[entry.first] = fl_value_get_int(entry.second);
   }
+  return true;
+}
 
-  const char *model_path = fl_value_get_string(model_path_value);
+// Read a map of provider name -> {option name: value} into `options`. Null reads as empty. Values may be
+// strings, integers, floats or booleans and are passed to the provider as text. Returns false otherwise.
+static bool read_provider_options(FlValue *value, std::map<std::string, std::map<std::string, std::string>> &options) {
+  if (value == nullptr || fl_value_get_type(value) == FL_VALUE_TYPE_NULL) {
+    return true;
+  }
+  if (fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+    return false;
+  }
+  for (const auto &provider : fl_value_to_map(value)) {
+    if (fl_value_get_type(provider.second) != FL_VALUE_TYPE_MAP) {
+      return false;
+    }
+    for (const auto &option : fl_value_to_map(provider.second)) {
+      std::string text;
+      switch (fl_value_get_type(option.second)) {
+      case FL_VALUE_TYPE_STRING:
+        text = fl_value_get_string(option.second);
+        break;
+      case FL_VALUE_TYPE_INT:
+        text = std::to_string(fl_value_get_int(option.second));
+        break;
+      case FL_VALUE_TYPE_FLOAT:
+        text = std::to_string(fl_value_get_float(option.second));
+        break;
+      case FL_VALUE_TYPE_BOOL:
+        text = fl_value_get_bool(option.second) ? "1" : "0";
+        break;
+      default:
+        return false;
+      }
+      options[provider.first][option.first] = text;
+    }
+  }
+  return true;
+}
 
-  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+// Append the execution provider named by its OrtProvider enum name, configured with `options`. CUDA, TensorRT
+// and oneDNN take their options through the V2 structs; every other provider goes through ONNX Runtime's
+// generic AppendExecutionProvider by its registration name. Throws Ort::Exception if ONNX Runtime rejects it.
+static void append_execution_provider(Ort::SessionOptions &session_options, const std::string &provider,
+                                      const std::map<std::string, std::string> &options) {
+  std::vector<const char *> keys;
+  std::vector<const char *> values;
+  for (const auto &option : options) {
+    keys.push_back(option.first.c_str());
+    values.push_back(option.second.c_str());
+  }
 
-  Ort::SessionOptions session_options;
+  const OrtApi &api = Ort::GetApi();
+  if (provider == "CUDA") {
+    // Follow the example at
+    // https://onnxruntime.ai/docs/execution-providers/CUDA-ExecutionProvider.html#using-v2-provider-options-struct
+    OrtCUDAProviderOptionsV2 *cuda_options = nullptr;
+    Ort::ThrowOnError(api.CreateCUDAProviderOptions(&cuda_options));
+    struct CudaOptionsDeleter {
+      void operator()(OrtCUDAProviderOptionsV2 *p) { Ort::GetApi().ReleaseCUDAProviderOptions(p); }
+    };
+    std::unique_ptr<OrtCUDAProviderOptionsV2, CudaOptionsDeleter> cuda_options_ptr(cuda_options);
+    Ort::ThrowOnError(api.UpdateCUDAProviderOptions(cuda_options_ptr.get(), keys.data(), values.data(), keys.size()));
+    session_options.AppendExecutionProvider_CUDA_V2(*cuda_options_ptr);
+  } else if (provider == "TENSOR_RT") {
+    OrtTensorRTProviderOptionsV2 *tensorrt_options = nullptr;
+    Ort::ThrowOnError(api.CreateTensorRTProviderOptions(&tensorrt_options));
+    struct TensorRTOptionsDeleter {
+      void operator()(OrtTensorRTProviderOptionsV2 *p) { Ort::GetApi().ReleaseTensorRTProviderOptions(p); }
+    };
+    std::unique_ptr<OrtTensorRTProviderOptionsV2, TensorRTOptionsDeleter> tensorrt_options_ptr(tensorrt_options);
+    Ort::ThrowOnError(
+        api.UpdateTensorRTProviderOptions(tensorrt_options_ptr.get(), keys.data(), values.data(), keys.size()));
+    session_options.AppendExecutionProvider_TensorRT_V2(*tensorrt_options_ptr);
+  } else if (provider == "DNNL") {
+    OrtDnnlProviderOptions *dnnl_options = nullptr;
+    Ort::ThrowOnError(api.CreateDnnlProviderOptions(&dnnl_options));
+    struct DnnlOptionsDeleter {
+      void operator()(OrtDnnlProviderOptions *p) { Ort::GetApi().ReleaseDnnlProviderOptions(p); }
+    };
+    std::unique_ptr<OrtDnnlProviderOptions, DnnlOptionsDeleter> dnnl_options_ptr(dnnl_options);
+    Ort::ThrowOnError(api.UpdateDnnlProviderOptions(dnnl_options_ptr.get(), keys.data(), values.data(), keys.size()));
+    Ort::ThrowOnError(api.SessionOptionsAppendExecutionProvider_Dnnl(session_options, dnnl_options_ptr.get()));
+  } else {
+    // Names the generic entry point registers providers under; it rejects the others, which are then skipped
+    static const std::unordered_map<std::string, std::string> registrationNames = {
+        {"XNNPACK", "XNNPACK"}, {"OPEN_VINO", "OpenVINO"}, {"QNN", "QNN"},       {"DIRECT_ML", "DML"},
+        {"CORE_ML", "CoreML"},  {"AZURE", "AZURE"},        {"WEB_GPU", "WebGPU"}, {"WEB_NN", "WEBNN"}};
+    auto it = registrationNames.find(provider);
+    std::unordered_map<std::string, std::string> generic_options(options.begin(), options.end());
+    session_options.AppendExecutionProvider(it != registrationNames.end() ? it->second : provider, generic_options);
+  }
+}
 
+// Configure session options from the map sent by Dart. `fixed_dims` adds free dimension overrides by name on
+// top of those in the map. Returns nullptr on success, or the error response.
+static FlMethodResponse *build_session_options(FlValue *session_options_value, Ort::SessionOptions &session_options,
+                                               const std::map<std::string, int64_t> &fixed_dims = {}) {
   // Configure session options if provided
   if (session_options_value != nullptr && fl_value_get_type(session_options_value) == FL_VALUE_TYPE_MAP) {
     auto options_map = fl_value_to_map(session_options_value);
@@ -219,6 +506,33 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
       session_options.SetInterOpNumThreads(fl_value_get_int(inter_threads_val->second));
     }
 
+    // Fix free dimensions by symbolic name (e.g. "batch") or by denotation (e.g. "DATA_BATCH"), so ONNX Runtime
+    // can optimize and plan memory for static shapes
+    std::map<std::string, int64_t> dims_by_name;
+    std::map<std::string, int64_t> dims_by_denotation;
+    auto by_name_val = options_map.find("freeDimensionOverrides");
+    auto by_denotation_val = options_map.find("freeDimensionOverridesByDenotation");
+    bool dims_valid = by_name_val == options_map.end() || read_dimension_map(by_name_val->second, dims_by_name);
+    dims_valid = dims_valid && (by_denotation_val == options_map.end() ||
+                                read_dimension_map(by_denotation_val->second, dims_by_denotation));
+    if (!dims_valid) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ARG", "Free dimension overrides must map dimension names to positive sizes", nullptr));
+    }
+    for (const auto &dim : fixed_dims) {
+      dims_by_name[dim.first] = dim.second;
+    }
+    try {
+      for (const auto &dim : dims_by_name) {
+        session_options.AddFreeDimensionOverrideByName(dim.first.c_str(), dim.second);
+      }
+      for (const auto &dim : dims_by_denotation) {
+        session_options.AddFreeDimensionOverride(dim.first.c_str(), dim.second);
+      }
+    } catch (const Ort::Exception &e) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+    }
+
     // get the device id, if not provided, set to 0
     int device_id = 0;
     auto device_id_val = options_map.find("deviceId");
@@ -248,94 +562,219 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
       providers.push_back("CPU");
     }
 
-    // Set providers in session options
+    std::map<std::string, std::map<std::string, std::string>> provider_options;
+    auto provider_options_val = options_map.find("providerOptions");
+    if (provider_options_val != options_map.end() &&
+        !read_provider_options(provider_options_val->second, provider_options)) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ARG", "Provider options must map provider names to maps of option names to values", nullptr));
+    }
+
+    // Names must be OrtProvider values, so a misspelled provider fails instead of being skipped below
+    static const std::set<std::string> knownProviders = {
+        "ACL", "ARM_NN", "AZURE", "CORE_ML", "CPU", "CUDA", "DIRECT_ML", "DNNL", "NNAPI",
+        "OPEN_VINO", "QNN", "ROCM", "TENSOR_RT", "XNNPACK", "WEB_ASSEMBLY", "WEB_GL", "WEB_GPU", "WEB_NN"};
+    for (const auto &provider : providers) {
+      if (knownProviders.count(provider) == 0) {
+        std::string error_message = "Provider is not supported: " + provider;
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PROVIDER", error_message.c_str(), nullptr));
+      }
+    }
+
+    // Providers are probed first and appended in the requested order. One that is not built into the linked
+    // ONNX Runtime, or that ONNX Runtime rejects when it is appended (e.g. its provider library cannot be loaded),
+    // is skipped and the next one is tried; nodes no appended provider supports run on the CPU provider, which
+    // ONNX Runtime always adds last. Device or driver failures only surface when the session is created.
+    std::set<std::string> available;
+    for (const auto &name : Ort::GetAvailableProviders()) {
+      available.insert(mapProviderNameToEnumName(name));
+    }
+    bool usable = false;
+    std::vector<std::string> skipped;
     try {
       for (const auto &provider : providers) {
         if (provider == "CPU") {
-          // CPU is implicitly added if no others are, or can be explicitly added.
-          // No specific options needed here usually.
+          usable = true;
           continue;
-        } else if (provider == "CUDA") {
-          OrtCUDAProviderOptionsV2 *cuda_options = nullptr;
-          OrtStatus *status = Ort::GetApi().CreateCUDAProviderOptions(&cuda_options);
-          if (status != nullptr) {
-            std::string error_message = "Failed to create CUDA provider options: ";
-            error_message += Ort::GetApi().GetErrorMessage(status);
-            Ort::GetApi().ReleaseStatus(status);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
-          }
-          // Use g_autoptr for automatic release
-          struct CudaOptionsDeleter {
-            void operator()(OrtCUDAProviderOptionsV2 *p) { Ort::GetApi().ReleaseCUDAProviderOptions(p); }
-          };
-          std::unique_ptr<OrtCUDAProviderOptionsV2, CudaOptionsDeleter> cuda_options_ptr(cuda_options);
-
-          // Follow the example at
-          // https://onnxruntime.ai/docs/execution-providers/CUDA-ExecutionProvider.html#using-v2-provider-options-struct
-          std::vector<const char *> keys{"device_id"};
-          std::vector<const char *> values{device_id_str.c_str()};
-          status =
-              Ort::GetApi().UpdateCUDAProviderOptions(cuda_options_ptr.get(), keys.data(), values.data(), keys.size());
-          if (status != nullptr) {
-            std::string error_message = "Failed to update CUDA provider options: ";
-            error_message += Ort::GetApi().GetErrorMessage(status);
-            Ort::GetApi().ReleaseStatus(status);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
-          }
+        }
+        if (available.count(provider) == 0) {
+          skipped.push_back(provider + " (not available in this build)");
+          continue;
+        }
 
-          // Append CUDA execution provider to session options
-          session_options.AppendExecutionProvider_CUDA_V2(*cuda_options_ptr);
-
-        } else if (provider == "TENSOR_RT") {
-          OrtTensorRTProviderOptionsV2 *tensorrt_options = nullptr;
-          OrtStatus *status = Ort::GetApi().CreateTensorRTProviderOptions(&tensorrt_options);
-          if (status != nullptr) {
-            std::string error_message = "Failed to create TensorRT provider options: ";
-            error_message += Ort::GetApi().GetErrorMessage(status);
-            Ort::GetApi().ReleaseStatus(status);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
-          }
-          struct TensorRTOptionsDeleter {
-            void operator()(OrtTensorRTProviderOptionsV2 *p) { Ort::GetApi().ReleaseTensorRTProviderOptions(p); }
-          };
-          std::unique_ptr<OrtTensorRTProviderOptionsV2, TensorRTOptionsDeleter> tensorrt_options_ptr(tensorrt_options);
-
-          std::vector<const char *> keys{"device_id"};
-          std::vector<const char *> values{device_id_str.c_str()};
-          status = Ort::GetApi().UpdateTensorRTProviderOptions(tensorrt_options_ptr.get(), keys.data(), values.data(),
-                                                               keys.size());
-          if (status != nullptr) {
-            std::string error_message = "Failed to update TensorRT provider options: ";
-            error_message += Ort::GetApi().GetErrorMessage(status);
-            Ort::GetApi().ReleaseStatus(status);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
+        std::map<std::string, std::string> options;
+        if (provider == "CUDA" || provider == "TENSOR_RT") {
+          options["device_id"] = device_id_str;
+        }
+        auto options_it = provider_options.find(provider);
+        if (options_it != provider_options.end()) {
+          for (const auto &option : options_it->second) {
+            options[option.first] = option.second;
           }
+        }
 
-          session_options.AppendExecutionProvider_TensorRT_V2(*tensorrt_options_ptr);
-
-        } else {
-          std::string error_message = "Provider is not supported: " + provider;
-          return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PROVIDER", error_message.c_str(), nullptr));
+        try {
+          append_execution_provider(session_options, provider, options);
+          usable = true;
+        } catch (const Ort::Exception &e) {
+          skipped.push_back(provider + " (" + e.what() + ")");
         }
       }
-    } catch (const Ort::Exception &e) {
-      // Catch potential exceptions during provider setup (e.g., AppendExecutionProvider)
-      return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", e.what(), nullptr));
     } catch (const std::exception &e) {
       return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
     }
+
+    std::string skipped_list;
+    for (const auto &entry : skipped) {
+      skipped_list += (skipped_list.empty() ? "" : ", ") + entry;
+    }
+    if (!usable) {
+      std::string error_message = "None of the requested providers can be used: " + skipped_list;
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
+    }
+    if (!skipped.empty()) {
+      g_warning("Falling back past unusable execution providers: %s", skipped_list.c_str());
+    }
+  }
+
+  return nullptr;
+}
+
+static FlValue *metadata_to_fl_value(const ModelMetadata &metadata) {
+  FlValue *custom_metadata_map = fl_value_new_map();
+  for (const auto &entry : metadata.custom_metadata) {
+    fl_value_set_string_take(custom_metadata_map, entry.first.c_str(), fl_value_new_string(entry.second.c_str()));
+  }
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "producerName", fl_value_new_string(metadata.producer_name.c_str()));
+  fl_value_set_string_take(result, "graphName", fl_value_new_string(metadata.graph_name.c_str()));
+  fl_value_set_string_take(result, "domain", fl_value_new_string(metadata.domain.c_str()));
+  fl_value_set_string_take(result, "description", fl_value_new_string(metadata.description.c_str()));
+  fl_value_set_string_take(result, "version", fl_value_new_int(metadata.version));
+  fl_value_set_string_take(result, "customMetadataMap", custom_metadata_map);
+  return result;
+}
+
+static FlValue *tensor_info_to_fl_value(const std::vector<TensorInfo> &tensor_info) {
+  FlValue *result = fl_value_new_list();
+
+  for (const auto &info : tensor_info) {
+    FlValue *info_map = fl_value_new_map();
+    fl_value_set_string_take(info_map, "name", fl_value_new_string(info.name.c_str()));
+
+    // Add shape
+    FlValue *shape_list = fl_value_new_list();
+    for (const auto &dim : info.shape) {
+      fl_value_append_take(shape_list, fl_value_new_int(dim));
+    }
+    fl_value_set_string_take(info_map, "shape", shape_list);
+
+    // Add type
+    fl_value_set_string_take(info_map, "type", fl_value_new_string(info.type.c_str()));
+
+    fl_value_append_take(result, info_map);
+  }
+  return result;
+}
+
+// Everything Dart needs about an open session, so opening one costs a single call. The introspection
+// is cached with the loaded model, so this does not walk the model again.
+static FlValue *session_to_fl_value(FlutterOnnxruntimePlugin *self, const std::string &session_id) {
+  FlValue *session = fl_value_new_map();
+  fl_value_set_string_take(session, "sessionId", fl_value_new_string(session_id.c_str()));
+  fl_value_set_string_take(session, "inputNames", vector_to_fl_value(self->session_manager->getInputNames(session_id)));
+  fl_value_set_string_take(session, "outputNames",
+                           vector_to_fl_value(self->session_manager->getOutputNames(session_id)));
+  fl_value_set_string_take(session, "inputInfo",
+                           tensor_info_to_fl_value(self->session_manager->getInputInfo(session_id)));
+  fl_value_set_string_take(session, "outputInfo",
+                           tensor_info_to_fl_value(self->session_manager->getOutputInfo(session_id)));
+  fl_value_set_string_take(session, "metadata",
+                           metadata_to_fl_value(self->session_manager->getModelMetadata(session_id)));
+  return session;
+}
+
+static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
+
+  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+  }
+
+  const char *model_path = fl_value_get_string(model_path_value);
+
+  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+
+  // Options found by autotuneSession for this model and CPU come first, so explicit thread counts still win
+  TunedOptions tuned_options;
+  bool use_tuned = false;
+  if (session_options_value != nullptr && fl_value_get_type(session_options_value) == FL_VALUE_TYPE_MAP) {
+    FlValue *use_tuned_value = fl_value_lookup_string(session_options_value, "useTunedOptions");
+    use_tuned = use_tuned_value != nullptr && fl_value_get_type(use_tuned_value) == FL_VALUE_TYPE_BOOL &&
+                fl_value_get_bool(use_tuned_value) && self->session_tuner->lookup(model_path, tuned_options);
+  }
+
+  Ort::SessionOptions session_options;
+  if (use_tuned) {
+    tuned_options.apply(session_options);
+  }
+  FlMethodResponse *options_error = build_session_options(session_options_value, session_options);
+  if (options_error != nullptr) {
+    return options_error;
+  }
+
+  // Shape-specialized variants: the same model again with some free dimensions fixed
+  std::vector<std::map<std::string, int64_t>> shape_variants;
+  FlValue *variants_value = nullptr;
+  if (session_options_value != nullptr && fl_value_get_type(session_options_value) == FL_VALUE_TYPE_MAP) {
+    variants_value = fl_value_lookup_string(session_options_value, "shapeVariants");
+  }
+  if (variants_value != nullptr && fl_value_get_type(variants_value) != FL_VALUE_TYPE_NULL) {
+    bool valid = fl_value_get_type(variants_value) == FL_VALUE_TYPE_LIST;
+    for (size_t i = 0; valid && i < fl_value_get_length(variants_value); i++) {
+      std::map<std::string, int64_t> dims;
+      valid = read_dimension_map(fl_value_get_list_value(variants_value, i), dims) && !dims.empty();
+      shape_variants.push_back(std::move(dims));
+    }
+    if (!valid) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ARG", "Shape variants must be maps of dimension names to positive sizes", nullptr));
+    }
   }
 
   try {
-    std::string session_id = self->session_manager->createSession(model_path, session_options);
+    // Sessions of the same model with the same options share one loaded model
+    std::string options_key = fl_value_to_canonical_string(session_options_value);
+    if (use_tuned) {
+      // A later tuning may pick other settings, which must not reuse the model loaded with these
+      options_key += "|tuned=" + tuned_options.toString();
+    }
+    std::string session_id = self->session_manager->createSession(model_path, &session_options, options_key);
 
-    std::vector<std::string> input_names = self->session_manager->getInputNames(session_id);
-    std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+    try {
+      for (const auto &dims : shape_variants) {
+        Ort::SessionOptions variant_options;
+        if (use_tuned) {
+          tuned_options.apply(variant_options);
+        }
+        FlMethodResponse *variant_error = build_session_options(session_options_value, variant_options, dims);
+        if (variant_error != nullptr) {
+          self->session_manager->closeSession(session_id);
+          return variant_error;
+        }
+        std::string variant_key = options_key;
+        for (const auto &dim : dims) {
+          variant_key += "|" + dim.first + "=" + std::to_string(dim.second);
+        }
+        self->session_manager->addShapeVariant(session_id, model_path, &variant_options, variant_key, dims);
+      }
+    } catch (...) {
+      self->session_manager->closeSession(session_id);
+      throw;
+    }
 
-    g_autoptr(FlValue) result = fl_value_new_map();
-    fl_value_set_string_take(result, "sessionId", fl_value_new_string(session_id.c_str()));
-    fl_value_set_string_take(result, "inputNames", vector_to_fl_value(input_names));
-    fl_value_set_string_take(result, "outputNames", vector_to_fl_value(output_names));
+    g_autoptr(FlValue) result = session_to_fl_value(self, session_id);
     fl_value_set_string_take(result, "status", fl_value_new_string("success")); // Keep status for compatibility maybe?
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } catch (const Ort::Exception &e) {
@@ -344,21 +783,1250 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
     // Catch other potential errors during session creation or name retrieval
     return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
   }
-}
-
-static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  std::vector<std::string> providers = Ort::GetAvailableProviders();
+}
+
+// State of a preloadSessions call, owned by its GTask
+struct PreloadTask {
+  FlutterOnnxruntimePlugin *plugin;
+  FlMethodCall *method_call;
+  std::vector<std::string> model_paths;
+  std::vector<Ort::SessionOptions> options;
+  std::vector<std::string> options_keys;
+  std::vector<std::string> session_ids;
+  std::string error_message;
+};
+
+static void preload_task_free(gpointer data) {
+  PreloadTask *task_data = static_cast<PreloadTask *>(data);
+  g_object_unref(task_data->method_call);
+  g_object_unref(task_data->plugin);
+  delete task_data;
+}
+
+// Runs on a worker thread, which fans the loads out over the session manager's pool
+static void preload_thread(GTask *task, gpointer source_object, gpointer data, GCancellable *cancellable) {
+  PreloadTask *task_data = static_cast<PreloadTask *>(data);
+
+  try {
+    task_data->session_ids = task_data->plugin->session_manager->preloadSessions(
+        task_data->model_paths, task_data->options, task_data->options_keys);
+  } catch (const std::exception &e) {
+    task_data->error_message = e.what();
+  }
+
+  g_task_return_pointer(task, nullptr, nullptr);
+}
+
+// Runs on the platform thread once every model is loaded
+static void preload_done(GObject *source_object, GAsyncResult *result, gpointer user_data) {
+  PreloadTask *task_data = static_cast<PreloadTask *>(g_task_get_task_data(G_TASK(result)));
+  FlutterOnnxruntimePlugin *self = task_data->plugin;
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (!task_data->error_message.empty()) {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", task_data->error_message.c_str(), nullptr));
+  } else {
+    g_autoptr(FlValue) sessions = fl_value_new_list();
+    for (const auto &session_id : task_data->session_ids) {
+      fl_value_append_take(sessions, session_to_fl_value(self, session_id));
+    }
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(sessions));
+  }
+  fl_method_call_respond(task_data->method_call, response, nullptr);
+}
+
+static FlMethodResponse *preload_sessions(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args) {
+  FlValue *models_value = fl_value_lookup_string(args, "models");
+  if (models_value == nullptr || fl_value_get_type(models_value) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Models must be a non-null list", nullptr));
+  }
+
+  std::unique_ptr<PreloadTask> task_data = std::make_unique<PreloadTask>();
+  for (size_t i = 0; i < fl_value_get_length(models_value); i++) {
+    FlValue *model_value = fl_value_get_list_value(models_value, i);
+    FlValue *model_path_value = fl_value_get_type(model_value) == FL_VALUE_TYPE_MAP
+                                    ? fl_value_lookup_string(model_value, "modelPath")
+                                    : nullptr;
+    if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+    }
+
+    FlValue *session_options_value = fl_value_lookup_string(model_value, "sessionOptions");
+    Ort::SessionOptions session_options;
+    FlMethodResponse *options_error = build_session_options(session_options_value, session_options);
+    if (options_error != nullptr) {
+      return options_error;
+    }
+
+    task_data->model_paths.push_back(fl_value_get_string(model_path_value));
+    task_data->options.push_back(std::move(session_options));
+    task_data->options_keys.push_back(fl_value_to_canonical_string(session_options_value));
+  }
+
+  task_data->plugin = FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self));
+  task_data->method_call = FL_METHOD_CALL(g_object_ref(method_call));
+
+  g_autoptr(GTask) task = g_task_new(self, nullptr, preload_done, nullptr);
+  g_task_set_task_data(task, task_data.release(), preload_task_free);
+  g_task_run_in_thread(task, preload_thread);
+
+  return nullptr;
+}
+
+// State of a reloadSession call, owned by its GTask
+struct ReloadTask {
+  FlutterOnnxruntimePlugin *plugin;
+  FlMethodCall *method_call;
+  std::string session_id;
+  std::string model_path;
+  Ort::SessionOptions options;
+  std::string options_key;
+  bool warm_up;
+  std::string error_message;
+};
+
+static void reload_task_free(gpointer data) {
+  ReloadTask *task_data = static_cast<ReloadTask *>(data);
+  g_object_unref(task_data->method_call);
+  g_object_unref(task_data->plugin);
+  delete task_data;
+}
+
+static void reload_thread(GTask *task, gpointer source_object, gpointer data, GCancellable *cancellable) {
+  ReloadTask *task_data = static_cast<ReloadTask *>(data);
+
+  try {
+    task_data->plugin->session_manager->reloadSession(task_data->session_id, task_data->model_path.c_str(),
+                                                      &task_data->options, task_data->options_key,
+                                                      task_data->warm_up);
+  } catch (const std::exception &e) {
+    task_data->error_message = e.what();
+  }
+
+  g_task_return_pointer(task, nullptr, nullptr);
+}
+
+// Runs on the platform thread once the new model is serving
+static void reload_done(GObject *source_object, GAsyncResult *result, gpointer user_data) {
+  ReloadTask *task_data = static_cast<ReloadTask *>(g_task_get_task_data(G_TASK(result)));
+  FlutterOnnxruntimePlugin *self = task_data->plugin;
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (!task_data->error_message.empty()) {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", task_data->error_message.c_str(), nullptr));
+  } else {
+    g_autoptr(FlValue) session = session_to_fl_value(self, task_data->session_id);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(session));
+  }
+  fl_method_call_respond(task_data->method_call, response, nullptr);
+}
+
+static FlMethodResponse *reload_session(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
+  FlValue *warm_up_value = fl_value_lookup_string(args, "warmUp");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Session ID cannot be null", nullptr));
+  }
+  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+  }
+
+  std::string session_id = fl_value_get_string(session_id_value);
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  std::unique_ptr<ReloadTask> task_data = std::make_unique<ReloadTask>();
+  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+  FlMethodResponse *options_error = build_session_options(session_options_value, task_data->options);
+  if (options_error != nullptr) {
+    return options_error;
+  }
+
+  task_data->session_id = session_id;
+  task_data->model_path = fl_value_get_string(model_path_value);
+  task_data->options_key = fl_value_to_canonical_string(session_options_value);
+  task_data->warm_up = warm_up_value != nullptr && fl_value_get_type(warm_up_value) == FL_VALUE_TYPE_BOOL &&
+                       fl_value_get_bool(warm_up_value);
+  task_data->plugin = FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self));
+  task_data->method_call = FL_METHOD_CALL(g_object_ref(method_call));
+
+  g_autoptr(GTask) task = g_task_new(self, nullptr, reload_done, nullptr);
+  g_task_set_task_data(task, task_data.release(), reload_task_free);
+  g_task_run_in_thread(task, reload_thread);
+
+  return nullptr;
+}
+
+static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  std::vector<std::string> providers = Ort::GetAvailableProviders();
+
+  g_autoptr(FlValue) result = fl_value_new_list();
+  for (const auto &provider : providers) {
+    // Map the provider name to the standardized enum name
+    std::string mappedName = mapProviderNameToEnumName(provider);
+    fl_value_append_take(result, fl_value_new_string(mappedName.c_str()));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *configure_model_cache(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *budget_value = fl_value_lookup_string(args, "budgetBytes");
+  if (budget_value == nullptr || fl_value_get_type(budget_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(budget_value) < 0) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Budget must be a non-negative integer", nullptr));
+  }
+
+  self->session_manager->setModelCacheBudget(static_cast<size_t>(fl_value_get_int(budget_value)));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_model_cache_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  ModelCacheStats stats = self->session_manager->getModelCacheStats();
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "models", fl_value_new_int(static_cast<int64_t>(stats.models)));
+  fl_value_set_string_take(result, "idleModels", fl_value_new_int(static_cast<int64_t>(stats.idle_models)));
+  fl_value_set_string_take(result, "bytes", fl_value_new_int(static_cast<int64_t>(stats.bytes)));
+  fl_value_set_string_take(result, "budgetBytes", fl_value_new_int(static_cast<int64_t>(stats.budget_bytes)));
+  fl_value_set_string_take(result, "sharedLoads", fl_value_new_int(static_cast<int64_t>(stats.shared_loads)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlValue *tensor_usage_to_fl_value(const TensorUsage &usage) {
+  FlValue *value = fl_value_new_map();
+  fl_value_set_string_take(value, "count", fl_value_new_int(static_cast<int64_t>(usage.count)));
+  fl_value_set_string_take(value, "bytes", fl_value_new_int(static_cast<int64_t>(usage.bytes)));
+  return value;
+}
+
+static FlMethodResponse *get_memory_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorMemoryStats tensor_stats = self->tensor_manager->getMemoryStats();
+
+  FlValue *tensors = fl_value_new_map();
+  fl_value_set_string_take(tensors, "count", fl_value_new_int(static_cast<int64_t>(tensor_stats.total.count)));
+  fl_value_set_string_take(tensors, "bytes", fl_value_new_int(static_cast<int64_t>(tensor_stats.total.bytes)));
+  fl_value_set_string_take(tensors, "peakCount", fl_value_new_int(static_cast<int64_t>(tensor_stats.peak.count)));
+  fl_value_set_string_take(tensors, "peakBytes", fl_value_new_int(static_cast<int64_t>(tensor_stats.peak.bytes)));
+  FlValue *by_type = fl_value_new_map();
+  for (const auto &usage : tensor_stats.by_type) {
+    fl_value_set_string_take(by_type, usage.first.c_str(), tensor_usage_to_fl_value(usage.second));
+  }
+  fl_value_set_string_take(tensors, "byType", by_type);
+  FlValue *by_origin = fl_value_new_map();
+  for (const auto &usage : tensor_stats.by_origin) {
+    fl_value_set_string_take(by_origin, usage.first.c_str(), tensor_usage_to_fl_value(usage.second));
+  }
+  fl_value_set_string_take(tensors, "byOrigin", by_origin);
+  fl_value_set_string_take(tensors, "budgetBytes", fl_value_new_int(static_cast<int64_t>(tensor_stats.budget_bytes)));
+  fl_value_set_string_take(tensors, "softLimitBytes",
+                           fl_value_new_int(static_cast<int64_t>(tensor_stats.soft_limit_bytes)));
+  fl_value_set_string_take(tensors, "evictions", fl_value_new_int(static_cast<int64_t>(tensor_stats.evictions)));
+
+  FlValue *sessions = fl_value_new_map();
+  for (const auto &entry : self->session_manager->getMemoryStats()) {
+    const SessionMemoryStats &stats = entry.second;
+    FlValue *session = fl_value_new_map();
+    fl_value_set_string_take(session, "modelBytes", fl_value_new_int(static_cast<int64_t>(stats.model_bytes)));
+    fl_value_set_string_take(session, "stateBytes", fl_value_new_int(static_cast<int64_t>(stats.state_bytes)));
+    fl_value_set_string_take(session, "resultCacheBytes",
+                             fl_value_new_int(static_cast<int64_t>(stats.result_cache_bytes)));
+    // Null rather than an empty map when the counters are unknown, so Dart can tell the two apart
+    FlValue *allocator = fl_value_new_null();
+    if (stats.allocator_stats_available) {
+      fl_value_unref(allocator);
+      allocator = fl_value_new_map();
+      for (const auto &counter : stats.allocator_stats) {
+        fl_value_set_string_take(allocator, counter.first.c_str(), fl_value_new_int(counter.second));
+      }
+    }
+    fl_value_set_string_take(session, "allocator", allocator);
+    fl_value_set_string_take(sessions, entry.first.c_str(), session);
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "tensors", tensors);
+  fl_value_set_string_take(result, "sessions", sessions);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Error text for an OrtValue released by the tensor budget rather than by the app
+static std::string evicted_value_message(const std::string &value_id) {
+  return "OrtValue " + value_id +
+         " was evicted to stay within the tensor memory budget; pin it or dispose of outputs sooner";
+}
+
+// Clone the tensors referenced by a map of names to {valueId: ...}, skipping entries that cannot be resolved
+static NamedTensors collect_input_tensors(FlutterOnnxruntimePlugin *self, FlValue *inputs_value) {
+  NamedTensors inputs;
+
+  // Iterate through each input
+  size_t num_inputs = fl_value_get_length(inputs_value);
+  for (size_t i = 0; i < num_inputs; i++) {
+    FlValue *key = fl_value_get_map_key(inputs_value, i);
+    FlValue *value = fl_value_get_map_value(inputs_value, i);
+
+    if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+      continue;
+    }
+
+    FlValue *tensor_id_map = fl_value_lookup_string(value, "valueId");
+
+    if (tensor_id_map == nullptr || fl_value_get_type(tensor_id_map) != FL_VALUE_TYPE_STRING) {
+      continue;
+    }
+
+    std::string tensor_id = fl_value_get_string(tensor_id_map);
+
+    // Get the tensor value
+    Ort::Value *tensor_ptr = self->tensor_manager->getTensor(tensor_id);
+    if (tensor_ptr == nullptr && self->tensor_manager->wasEvicted(tensor_id)) {
+      throw Ort::Exception(evicted_value_message(tensor_id), ORT_INVALID_ARGUMENT);
+    }
+    if (tensor_ptr != nullptr) {
+      try {
+        // Use the tensor manager to clone the tensor
+        Ort::Value new_tensor = self->tensor_manager->cloneTensor(tensor_id);
+        inputs.emplace_back(fl_value_get_string(key), std::move(new_tensor));
+      } catch (const std::exception &e) {
+        g_warning("Failed to clone tensor %s: %s", tensor_id.c_str(), e.what());
+        // Continue with the next tensor
+      }
+    }
+  }
+
+  return inputs;
+}
+
+// The tensor scope named by a call's optional "scopeId" argument, empty when the call names none
+static std::string read_scope_id(FlValue *args) {
+  FlValue *scope_id_value = fl_value_lookup_string(args, "scopeId");
+  if (scope_id_value == nullptr || fl_value_get_type(scope_id_value) != FL_VALUE_TYPE_STRING) {
+    return "";
+  }
+  return fl_value_get_string(scope_id_value);
+}
+
+// Hand output tensors over to the TensorManager and describe them as a map of name -> [valueId, type, shape].
+// The tensors join `scope_id` when not empty.
+static FlValue *store_output_tensors(FlutterOnnxruntimePlugin *self, NamedTensors &outputs,
+                                     const std::string &scope_id) {
+  FlValue *outputs_map = fl_value_new_map();
+
+  // For each output tensor, directly store it using TensorManager's storeTensor
+  for (auto &output : outputs) {
+    // Create a tensor ID
+    std::string value_id = self->tensor_manager->generateTensorId();
+
+    // Store the tensor directly using storeTensor - this transfers ownership
+    self->tensor_manager->storeTensor(value_id, std::move(output.second), scope_id);
+
+    // get the tensor type and shape from tensor manager
+    // Note: only do this after storeTensor get the tensor registered in tensor manager
+    std::string tensor_type = self->tensor_manager->getTensorType(value_id);
+    std::vector<int64_t> shape = self->tensor_manager->getTensorShape(value_id);
+
+    // Add the value ID to the outputs map
+    FlValue *shape_list = fl_value_new_list();
+    for (const auto &dim : shape) {
+      fl_value_append_take(shape_list, fl_value_new_int(dim));
+    }
+
+    // Note: Flutter does not allow return a nested map, so we have to use list here to keep the output_info format
+    FlValue *output_info = fl_value_new_list();
+    fl_value_append_take(output_info, fl_value_new_string(value_id.c_str()));
+    fl_value_append_take(output_info, fl_value_new_string(tensor_type.c_str()));
+    fl_value_append_take(output_info, shape_list);
+
+    fl_value_set_string_take(outputs_map, output.first.c_str(), output_info);
+  }
+
+  return outputs_map;
+}
+
+// Configure run options from the map sent by Dart, if any. Returns the LoRA adapters it activates, which must
+// be kept until the run ends. Throws Ort::Exception for an unknown adapter.
+static ActiveLoraAdapters apply_run_options(FlutterOnnxruntimePlugin *self, FlValue *run_options_value,
+                                            Ort::RunOptions &run_options) {
+  if (run_options_value == nullptr || fl_value_get_type(run_options_value) != FL_VALUE_TYPE_MAP) {
+    return ActiveLoraAdapters();
+  }
+
+  // Extract log severity level if provided
+  FlValue *log_severity_level_value = fl_value_lookup_string(run_options_value, "logSeverityLevel");
+  if (log_severity_level_value != nullptr && fl_value_get_type(log_severity_level_value) == FL_VALUE_TYPE_INT) {
+    run_options.SetRunLogSeverityLevel(fl_value_get_int(log_severity_level_value));
+  }
+
+  // Extract log verbosity level if provided
+  FlValue *log_verbosity_level_value = fl_value_lookup_string(run_options_value, "logVerbosityLevel");
+  if (log_verbosity_level_value != nullptr && fl_value_get_type(log_verbosity_level_value) == FL_VALUE_TYPE_INT) {
+    run_options.SetRunLogVerbosityLevel(fl_value_get_int(log_verbosity_level_value));
+  }
+
+  // Extract terminate option if provided
+  FlValue *terminate_value = fl_value_lookup_string(run_options_value, "terminate");
+  if (terminate_value != nullptr && fl_value_get_type(terminate_value) == FL_VALUE_TYPE_BOOL) {
+    if (fl_value_get_bool(terminate_value)) {
+      run_options.SetTerminate();
+    }
+  }
+
+  // Adapters switch the fine-tuned variant the base model runs as, for this run only
+  std::vector<std::string> adapter_ids;
+  FlValue *adapters_value = fl_value_lookup_string(run_options_value, "loraAdapters");
+  if (adapters_value != nullptr && fl_value_get_type(adapters_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(adapters_value); i++) {
+      FlValue *adapter_id = fl_value_get_list_value(adapters_value, i);
+      if (fl_value_get_type(adapter_id) != FL_VALUE_TYPE_STRING) {
+        throw Ort::Exception("LoRA adapter IDs must be strings", ORT_INVALID_ARGUMENT);
+      }
+      adapter_ids.push_back(fl_value_get_string(adapter_id));
+    }
+  }
+  return self->lora_adapter_manager->activate(adapter_ids, run_options);
+}
+
+// Read the optional list of outputs a run should fetch; null or absent leaves `names` empty (all outputs).
+// Returns false if the value is not a list of strings.
+static bool read_output_names(FlValue *output_names_value, std::vector<std::string> &names) {
+  names.clear();
+  if (output_names_value == nullptr || fl_value_get_type(output_names_value) == FL_VALUE_TYPE_NULL) {
+    return true;
+  }
+  if (fl_value_get_type(output_names_value) != FL_VALUE_TYPE_LIST) {
+    return false;
+  }
+  for (size_t i = 0; i < fl_value_get_length(output_names_value); i++) {
+    FlValue *name = fl_value_get_list_value(output_names_value, i);
+    if (fl_value_get_type(name) != FL_VALUE_TYPE_STRING) {
+      return false;
+    }
+    names.push_back(fl_value_get_string(name));
+  }
+  return true;
+}
+
+static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) { // inputs is a map from Dart
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+
+  // Only these outputs are fetched and stored, all of them when empty
+  std::vector<std::string> output_names;
+  if (!read_output_names(fl_value_lookup_string(args, "outputNames"), output_names)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Output names must be a list of strings", nullptr));
+  }
+
+  // Check if session exists
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Prepare input tensors and the input names they are bound to
+    NamedTensors inputs = collect_input_tensors(self, inputs_value);
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_tensors;
+    for (auto &input : inputs) {
+      input_names.push_back(input.first);
+      input_tensors.push_back(std::move(input.second));
+    }
+
+    // Create and configure run options
+    Ort::RunOptions run_options;
+    ActiveLoraAdapters adapters = apply_run_options(self, run_options_value, run_options);
+
+    // Run inference using SessionManager. Outputs bound as session state stay native and are not returned.
+    NamedTensors output_tensors = self->session_manager->runInference(session_id, input_names, std::move(input_tensors),
+                                                                      &run_options, output_names, adapters.ids);
+
+    // Process outputs
+    g_autoptr(FlValue) outputs_map = store_output_tensors(self, output_tensors, read_scope_id(args));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_FAILED", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *run_many(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_ids_value = fl_value_lookup_string(args, "sessionIds");
+  if (session_ids_value == nullptr || fl_value_get_type(session_ids_value) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session IDs must be a non-null list", nullptr));
+  }
+
+  std::vector<std::string> session_ids;
+  for (size_t i = 0; i < fl_value_get_length(session_ids_value); i++) {
+    FlValue *id_value = fl_value_get_list_value(session_ids_value, i);
+    if (fl_value_get_type(id_value) != FL_VALUE_TYPE_STRING) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Session IDs must be strings", nullptr));
+    }
+    if (!self->session_manager->hasSession(fl_value_get_string(id_value))) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+    }
+    session_ids.push_back(fl_value_get_string(id_value));
+  }
+
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  try {
+    // One copy of each input, shared by all sessions
+    NamedTensors inputs = collect_input_tensors(self, inputs_value);
+
+    Ort::RunOptions run_options;
+    ActiveLoraAdapters adapters = apply_run_options(self, fl_value_lookup_string(args, "runOptions"), run_options);
+
+    std::vector<NamedTensors> outputs = self->session_manager->runMany(session_ids, inputs, &run_options, adapters.ids);
+
+    // One output map per session, in the order the sessions were given
+    std::string scope_id = read_scope_id(args);
+    g_autoptr(FlValue) result = fl_value_new_list();
+    for (auto &session_outputs : outputs) {
+      fl_value_append_take(result, store_output_tensors(self, session_outputs, scope_id));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_FAILED", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *run_with_data(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  // Outputs to send back; all of them when absent
+  std::vector<std::string> output_names;
+  if (!read_output_names(fl_value_lookup_string(args, "outputNames"), output_names)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Output names must be a list of strings", nullptr));
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Inputs wrap the typed lists of this call in place and are never registered with the tensor manager
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_tensors;
+    for (size_t i = 0; i < fl_value_get_length(inputs_value); i++) {
+      FlValue *name = fl_value_get_map_key(inputs_value, i);
+      FlValue *input = fl_value_get_map_value(inputs_value, i);
+      FlValue *type_value = fl_value_get_type(input) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(input, "dataType")
+                                                                          : nullptr;
+      std::vector<int64_t> shape;
+      if (fl_value_get_type(name) != FL_VALUE_TYPE_STRING || type_value == nullptr ||
+          fl_value_get_type(type_value) != FL_VALUE_TYPE_STRING ||
+          !fl_value_to_int64_vector(fl_value_lookup_string(input, "shape"), shape)) {
+        throw Ort::Exception("Each input needs a dataType, an integer shape and data", ORT_INVALID_ARGUMENT);
+      }
+      input_names.push_back(fl_value_get_string(name));
+      input_tensors.push_back(
+          fl_value_to_tensor(fl_value_lookup_string(input, "data"), fl_value_get_string(type_value), shape));
+    }
+
+    Ort::RunOptions run_options;
+    ActiveLoraAdapters adapters = apply_run_options(self, fl_value_lookup_string(args, "runOptions"), run_options);
+
+    NamedTensors outputs = self->session_manager->runInference(session_id, input_names, std::move(input_tensors),
+                                                               &run_options, output_names, adapters.ids);
+
+    // Outputs are serialized and freed here, so nothing is left to read or release afterwards
+    g_autoptr(FlValue) result = fl_value_new_map();
+    for (const auto &output : outputs) {
+      fl_value_set_string_take(result, output.first.c_str(), tensor_to_fl_value(output.second));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_FAILED", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+// State of an autotuneSession call, owned by its GTask
+struct AutotuneTask {
+  FlutterOnnxruntimePlugin *plugin;
+  FlMethodCall *method_call;
+  std::string model_path;
+  // Copies of the sample inputs, so releasing the caller's values meanwhile does not matter
+  NamedTensors inputs;
+  int64_t budget_ms;
+  TuningObjective objective;
+  // The caller's session options (providers etc.), applied to every candidate, and their canonical form
+  FlValue *session_options;
+  std::string options_key;
+  TuningResult result;
+  std::string error_message;
+};
+
+static void autotune_task_free(gpointer data) {
+  AutotuneTask *task_data = static_cast<AutotuneTask *>(data);
+  if (task_data->session_options != nullptr) {
+    fl_value_unref(task_data->session_options);
+  }
+  g_object_unref(task_data->method_call);
+  g_object_unref(task_data->plugin);
+  delete task_data;
+}
+
+static void autotune_thread(GTask *task, gpointer source_object, gpointer data, GCancellable *cancellable) {
+  AutotuneTask *task_data = static_cast<AutotuneTask *>(data);
+
+  // The options were checked before the task started, so building them again cannot fail
+  auto configure = [task_data](Ort::SessionOptions &options) {
+    FlMethodResponse *options_error = build_session_options(task_data->session_options, options);
+    if (options_error != nullptr) {
+      g_object_unref(options_error);
+    }
+  };
+
+  try {
+    task_data->result = task_data->plugin->session_tuner->tune(task_data->model_path, task_data->inputs,
+                                                               task_data->budget_ms, task_data->objective,
+                                                               task_data->options_key, configure);
+  } catch (const std::exception &e) {
+    task_data->error_message = e.what();
+  }
+
+  g_task_return_pointer(task, nullptr, nullptr);
+}
+
+static FlValue *tuning_measurement_to_fl_value(const TuningMeasurement &measurement) {
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "intraOpNumThreads", fl_value_new_int(measurement.options.intra_op_threads));
+  fl_value_set_string_take(result, "interOpNumThreads", fl_value_new_int(measurement.options.inter_op_threads));
+  fl_value_set_string_take(result, "parallelExecution", fl_value_new_bool(measurement.options.parallel));
+  fl_value_set_string_take(result, "latencyMs", fl_value_new_float(measurement.latency_ms));
+  fl_value_set_string_take(result, "runsPerSecond", fl_value_new_float(measurement.runs_per_second));
+  fl_value_set_string_take(result, "concurrency", fl_value_new_int(static_cast<int64_t>(measurement.concurrency)));
+  fl_value_set_string_take(result, "runs", fl_value_new_int(static_cast<int64_t>(measurement.runs)));
+  return result;
+}
+
+// Runs on the platform thread once every candidate is measured
+static void autotune_done(GObject *source_object, GAsyncResult *result, gpointer user_data) {
+  AutotuneTask *task_data = static_cast<AutotuneTask *>(g_task_get_task_data(G_TASK(result)));
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (!task_data->error_message.empty()) {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", task_data->error_message.c_str(), nullptr));
+  } else {
+    g_autoptr(FlValue) tuning = tuning_measurement_to_fl_value(task_data->result.best);
+    FlValue *candidates = fl_value_new_list();
+    for (const auto &measurement : task_data->result.candidates) {
+      fl_value_append_take(candidates, tuning_measurement_to_fl_value(measurement));
+    }
+    fl_value_set_string_take(tuning, "candidates", candidates);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(tuning));
+  }
+  fl_method_call_respond(task_data->method_call, response, nullptr);
+}
+
+static FlMethodResponse *autotune_session(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args) {
+  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  FlValue *budget_value = fl_value_lookup_string(args, "budgetMs");
+  FlValue *objective_value = fl_value_lookup_string(args, "objective");
+
+  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+  }
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+  if (budget_value == nullptr || fl_value_get_type(budget_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(budget_value) < 1) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Budget must be a positive integer", nullptr));
+  }
+  TuningObjective objective = TuningObjective::kLatency;
+  if (objective_value != nullptr && fl_value_get_type(objective_value) == FL_VALUE_TYPE_STRING) {
+    if (strcmp(fl_value_get_string(objective_value), "throughput") == 0) {
+      objective = TuningObjective::kThroughput;
+    } else if (strcmp(fl_value_get_string(objective_value), "latency") != 0) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Objective must be 'latency' or 'throughput'", nullptr));
+    }
+  }
+
+  std::unique_ptr<AutotuneTask> task_data = std::make_unique<AutotuneTask>();
+  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+  Ort::SessionOptions checked_options;
+  FlMethodResponse *options_error = build_session_options(session_options_value, checked_options);
+  if (options_error != nullptr) {
+    return options_error;
+  }
+
+  try {
+    task_data->inputs = collect_input_tensors(self, inputs_value);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("EVICTED_VALUE", e.what(), nullptr));
+  }
+  if (task_data->inputs.empty()) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "No valid sample inputs", nullptr));
+  }
+
+  // The store lives under the user's cache directory, which may not exist yet
+  g_autofree gchar *store_dir = g_build_filename(g_get_user_cache_dir(), "flutter_onnxruntime", nullptr);
+  g_mkdir_with_parents(store_dir, 0700);
+
+  task_data->model_path = fl_value_get_string(model_path_value);
+  task_data->budget_ms = fl_value_get_int(budget_value);
+  task_data->objective = objective;
+  task_data->session_options = session_options_value != nullptr ? fl_value_ref(session_options_value) : nullptr;
+  task_data->options_key = fl_value_to_canonical_string(session_options_value);
+  task_data->plugin = FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self));
+  task_data->method_call = FL_METHOD_CALL(g_object_ref(method_call));
+
+  g_autoptr(GTask) task = g_task_new(self, nullptr, autotune_done, nullptr);
+  g_task_set_task_data(task, task_data.release(), autotune_task_free);
+  g_task_run_in_thread(task, autotune_thread);
+
+  return nullptr;
+}
+
+static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  // Get session ID
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    // Similar to closeSession, return success even if ID is invalid.
+    // Alternatively, return an error:
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  self->session_manager->closeSession(session_id);
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  }
+
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Get metadata using the SessionManager
+    g_autoptr(FlValue) result = metadata_to_fl_value(self->session_manager->getModelMetadata(session_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  }
+
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Get input info from SessionManager
+    g_autoptr(FlValue) result = tensor_info_to_fl_value(self->session_manager->getInputInfo(session_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  }
+
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Get output info from SessionManager
+    g_autoptr(FlValue) result = tensor_info_to_fl_value(self->session_manager->getOutputInfo(session_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *set_state_bindings(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *bindings_value = fl_value_lookup_string(args, "bindings");
+  if (bindings_value == nullptr || fl_value_get_type(bindings_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Bindings must be a non-null map", nullptr));
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  // Bindings map each output name to the input name it feeds on the next run
+  std::map<std::string, std::string> output_to_input;
+  for (const auto &entry : fl_value_to_map(bindings_value)) {
+    if (fl_value_get_type(entry.second) != FL_VALUE_TYPE_STRING) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Binding targets must be input names", nullptr));
+    }
+    output_to_input[entry.first] = fl_value_get_string(entry.second);
+  }
+
+  try {
+    self->session_manager->setStateBindings(session_id, output_to_input);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *reset_state(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    self->session_manager->resetState(session_id);
+  } catch (const Ort::Exception &e) {
+    // The session is either held by a generate call or was closed after the check above
+    const gchar *code = e.GetOrtErrorCode() == ORT_INVALID_ARGUMENT ? "INVALID_SESSION" : "BUSY";
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(code, e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *set_constant_input(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  FlValue *name_value = fl_value_lookup_string(args, "name");
+  FlValue *value_id_value = fl_value_lookup_string(args, "valueId");
+
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  if (name_value == nullptr || fl_value_get_type(name_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Input name must be a non-null string", nullptr));
+  }
+  // A null value ID removes the constant input
+  bool remove = value_id_value == nullptr || fl_value_get_type(value_id_value) == FL_VALUE_TYPE_NULL;
+  if (!remove && fl_value_get_type(value_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Value ID must be a string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  // The session keeps its own copy, made once here, so the OrtValue can be released on the Dart side
+  Ort::Value value(nullptr);
+  if (!remove) {
+    std::string value_id = fl_value_get_string(value_id_value);
+    if (self->tensor_manager->wasEvicted(value_id)) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("EVICTED_VALUE", evicted_value_message(value_id).c_str(), nullptr));
+    }
+    if (self->tensor_manager->getTensor(value_id) == nullptr) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_VALUE", "Tensor not found", nullptr));
+    }
+    try {
+      value = self->tensor_manager->cloneTensor(value_id);
+    } catch (const std::exception &e) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+    }
+  }
+
+  try {
+    self->session_manager->setConstantInput(session_id, fl_value_get_string(name_value), std::move(value));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_result_cache(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *max_entries_value = fl_value_lookup_string(args, "maxEntries");
+  FlValue *max_bytes_value = fl_value_lookup_string(args, "maxBytes");
+  if (max_entries_value == nullptr || fl_value_get_type(max_entries_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(max_entries_value) < 0 || max_bytes_value == nullptr ||
+      fl_value_get_type(max_bytes_value) != FL_VALUE_TYPE_INT || fl_value_get_int(max_bytes_value) < 0) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Max entries and max bytes must be non-negative integers", nullptr));
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    self->session_manager->configureResultCache(session_id, static_cast<size_t>(fl_value_get_int(max_entries_value)),
+                                                static_cast<size_t>(fl_value_get_int(max_bytes_value)));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *configure_bucketing(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *dimension_value = fl_value_lookup_string(args, "dimension");
+  FlValue *mask_input_value = fl_value_lookup_string(args, "maskInput");
+  std::vector<int64_t> buckets;
+  if (dimension_value == nullptr || fl_value_get_type(dimension_value) != FL_VALUE_TYPE_STRING ||
+      !fl_value_to_int64_vector(fl_value_lookup_string(args, "buckets"), buckets)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Bucketing needs a dimension name and a list of bucket sizes", nullptr));
+  }
+  std::string mask_input;
+  if (mask_input_value != nullptr && fl_value_get_type(mask_input_value) == FL_VALUE_TYPE_STRING) {
+    mask_input = fl_value_get_string(mask_input_value);
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    self->session_manager->configureBucketing(session_id, fl_value_get_string(dimension_value), std::move(buckets),
+                                              mask_input);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *set_input_casting(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  FlValue *enabled_value = fl_value_lookup_string(args, "enabled");
+  if (enabled_value == nullptr || fl_value_get_type(enabled_value) != FL_VALUE_TYPE_BOOL) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Enabled must be a boolean", nullptr));
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    self->session_manager->setInputCasting(session_id, fl_value_get_bool(enabled_value));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+// Load a LoRA adapter from a file path or from the bytes of such a file
+static FlMethodResponse *load_lora_adapter(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *path_value = fl_value_lookup_string(args, "path");
+  FlValue *bytes_value = fl_value_lookup_string(args, "bytes");
+  bool from_path = path_value != nullptr && fl_value_get_type(path_value) == FL_VALUE_TYPE_STRING;
+  bool from_bytes = bytes_value != nullptr && fl_value_get_type(bytes_value) == FL_VALUE_TYPE_UINT8_LIST;
+  if (from_path == from_bytes) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Either an adapter path or adapter bytes must be given", nullptr));
+  }
+
+  try {
+    std::string adapter_id =
+        from_path ? self->lora_adapter_manager->loadAdapter(fl_value_get_string(path_value))
+                  : self->lora_adapter_manager->loadAdapterFromBytes(fl_value_get_uint8_list(bytes_value),
+                                                                     fl_value_get_length(bytes_value));
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "adapterId", fl_value_new_string(adapter_id.c_str()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *release_lora_adapter(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *adapter_id_value = fl_value_lookup_string(args, "adapterId");
+  if (adapter_id_value == nullptr || fl_value_get_type(adapter_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Adapter ID must be a non-null string", nullptr));
+  }
+
+  // Like closing a session, releasing an unknown adapter succeeds
+  self->lora_adapter_manager->releaseAdapter(fl_value_get_string(adapter_id_value));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_result_cache_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  const char *session_id = fl_value_get_string(session_id_value);
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    ResultCacheStats stats = self->session_manager->getResultCacheStats(session_id);
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "hits", fl_value_new_int(static_cast<int64_t>(stats.hits)));
+    fl_value_set_string_take(result, "misses", fl_value_new_int(static_cast<int64_t>(stats.misses)));
+    fl_value_set_string_take(result, "evictions", fl_value_new_int(static_cast<int64_t>(stats.evictions)));
+    fl_value_set_string_take(result, "entries", fl_value_new_int(static_cast<int64_t>(stats.entries)));
+    fl_value_set_string_take(result, "bytes", fl_value_new_int(static_cast<int64_t>(stats.bytes)));
+    fl_value_set_string_take(result, "maxEntries", fl_value_new_int(static_cast<int64_t>(stats.max_entries)));
+    fl_value_set_string_take(result, "maxBytes", fl_value_new_int(static_cast<int64_t>(stats.max_bytes)));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", e.what(), nullptr));
+  }
+}
+
+// State of a generate call, owned by its GTask
+struct GenerationTask {
+  FlutterOnnxruntimePlugin *plugin;
+  FlMethodCall *method_call;
+  std::string session_id;
+  std::string generation_id;
+  std::vector<int64_t> prompt_ids;
+  GenerationConfig config;
+  std::shared_ptr<std::atomic<bool>> cancelled;
+  GenerationResult result;
+  std::string error_code;
+  std::string error_message;
+};
+
+static void generation_task_free(gpointer data) {
+  GenerationTask *task_data = static_cast<GenerationTask *>(data);
+  g_object_unref(task_data->method_call);
+  g_object_unref(task_data->plugin);
+  delete task_data;
+}
+
+// Runs on a worker thread: the decode loop itself
+static void generation_thread(GTask *task, gpointer source_object, gpointer data, GCancellable *cancellable) {
+  GenerationTask *task_data = static_cast<GenerationTask *>(data);
+  FlutterOnnxruntimePlugin *self = task_data->plugin;
+
+  // Stream each token over the event channel; the loop waits here if the platform thread falls behind
+  auto on_token = [self, task_data](int64_t token, size_t index) {
+    FlValue *event = fl_value_new_map();
+    fl_value_set_string_take(event, "event", fl_value_new_string("generatedToken"));
+    fl_value_set_string_take(event, "generationId", fl_value_new_string(task_data->generation_id.c_str()));
+    fl_value_set_string_take(event, "token", fl_value_new_int(token));
+    fl_value_set_string_take(event, "index", fl_value_new_int(static_cast<int64_t>(index)));
+    if (self->event_stream != nullptr) {
+      self->event_stream->push(event);
+    } else {
+      fl_value_unref(event);
+    }
+  };
+
+  try {
+    task_data->result = runGeneration(*self->session_manager, task_data->session_id, task_data->prompt_ids,
+                                      task_data->config, on_token, task_data->cancelled.get());
+  } catch (const Ort::Exception &e) {
+    task_data->error_code = "INFERENCE_FAILED";
+    task_data->error_message = e.what();
+  } catch (const std::exception &e) {
+    task_data->error_code = "PLUGIN_ERROR";
+    task_data->error_message = e.what();
+  }
+
+  g_task_return_pointer(task, nullptr, nullptr);
+}
+
+// Runs on the platform thread once the decode loop has finished
+static void generation_done(GObject *source_object, GAsyncResult *result, gpointer user_data) {
+  GenerationTask *task_data = static_cast<GenerationTask *>(g_task_get_task_data(G_TASK(result)));
+  FlutterOnnxruntimePlugin *self = task_data->plugin;
+
+  {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->generations.erase(task_data->generation_id);
+  }
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (!task_data->error_code.empty()) {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new(task_data->error_code.c_str(),
+                                                               task_data->error_message.c_str(), nullptr));
+  } else {
+    g_autoptr(FlValue) value = fl_value_new_map();
+    fl_value_set_string_take(value, "generationId", fl_value_new_string(task_data->generation_id.c_str()));
+    fl_value_set_string_take(value, "tokens", vector_to_fl_value(task_data->result.tokens));
+    fl_value_set_string_take(value, "stopReason", fl_value_new_string(task_data->result.stop_reason.c_str()));
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+  }
+  fl_method_call_respond(task_data->method_call, response, nullptr);
+}
+
+// Parse the generation config sent from Dart. Returns an error response for malformed values.
+static FlMethodResponse *parse_generation_config(FlValue *config_value, GenerationConfig &config) {
+  if (config_value == nullptr || fl_value_get_type(config_value) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+
+  for (const auto &entry : fl_value_to_map(config_value)) {
+    const std::string &key = entry.first;
+    FlValue *value = entry.second;
+    FlValueType type = fl_value_get_type(value);
+
+    if (type == FL_VALUE_TYPE_NULL) {
+      continue;
+    }
+    if (key == "inputIdsName" || key == "attentionMaskName" || key == "positionIdsName" || key == "logitsName") {
+      if (type != FL_VALUE_TYPE_STRING) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Tensor names must be strings", nullptr));
+      }
+      std::string name = fl_value_get_string(value);
+      if (key == "inputIdsName") {
+        config.input_ids_name = name;
+      } else if (key == "attentionMaskName") {
+        config.attention_mask_name = name;
+      } else if (key == "positionIdsName") {
+        config.position_ids_name = name;
+      } else {
+        config.logits_name = name;
+      }
+    } else if (key == "maxLength" || key == "topK" || key == "seed") {
+      if (type != FL_VALUE_TYPE_INT) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_ARG", "maxLength, topK and seed must be integers", nullptr));
+      }
+      int64_t number = fl_value_get_int(value);
+      if (key == "maxLength") {
+        config.max_length = number;
+      } else if (key == "topK") {
+        config.top_k = number;
+      } else {
+        config.seed = static_cast<uint64_t>(number);
+      }
+    } else if (key == "temperature" || key == "topP") {
+      if (type != FL_VALUE_TYPE_FLOAT && type != FL_VALUE_TYPE_INT) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_ARG", "temperature and topP must be numbers", nullptr));
+      }
+      float number =
+          type == FL_VALUE_TYPE_FLOAT ? static_cast<float>(fl_value_get_float(value)) : fl_value_get_int(value);
+      if (key == "temperature") {
+        config.temperature = number;
+      } else {
+        config.top_p = number;
+      }
+    } else if (key == "stopTokens") {
+      if (!fl_value_to_int64_vector(value, config.stop_tokens)) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_ARG", "stopTokens must be a list of integers", nullptr));
+      }
+    }
+  }
 
-  g_autoptr(FlValue) result = fl_value_new_list();
-  for (const auto &provider : providers) {
-    // Map the provider name to the standardized enum name
-    std::string mappedName = mapProviderNameToEnumName(provider);
-    fl_value_append_take(result, fl_value_new_string(mappedName.c_str()));
-  }
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  return nullptr;
 }
 
-static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args) {
+static FlMethodResponse *generate(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call, FlValue *args) {
   FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
   if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
     return FL_METHOD_RESPONSE(
@@ -366,263 +2034,332 @@ static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *
   }
   const char *session_id = fl_value_get_string(session_id_value);
 
-  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
-  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) { // inputs is a map from Dart
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  FlValue *generation_id_value = fl_value_lookup_string(args, "generationId");
+  if (generation_id_value == nullptr || fl_value_get_type(generation_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Generation ID must be a non-null string", nullptr));
   }
 
-  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+  std::vector<int64_t> prompt_ids;
+  if (!fl_value_to_int64_vector(fl_value_lookup_string(args, "promptIds"), prompt_ids) || prompt_ids.empty()) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Prompt IDs must be a non-empty list of integers", nullptr));
+  }
+
+  GenerationConfig config;
+  FlMethodResponse *config_error = parse_generation_config(fl_value_lookup_string(args, "config"), config);
+  if (config_error != nullptr) {
+    return config_error;
+  }
 
-  // Check if session exists
   if (!self->session_manager->hasSession(session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
   }
 
-  try {
-    std::vector<std::string> input_names = self->session_manager->getInputNames(session_id);
-    std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
-
-    // Prepare input tensors
-    std::vector<Ort::Value> input_tensors;
-
-    // Iterate through each input
-    size_t num_inputs = fl_value_get_length(inputs_value);
-    for (size_t i = 0; i < num_inputs; i++) {
-      FlValue *key = fl_value_get_map_key(inputs_value, i);
-      FlValue *value = fl_value_get_map_value(inputs_value, i);
+  GenerationTask *task_data = new GenerationTask();
+  task_data->plugin = FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self));
+  task_data->method_call = FL_METHOD_CALL(g_object_ref(method_call));
+  task_data->session_id = session_id;
+  task_data->generation_id = fl_value_get_string(generation_id_value);
+  task_data->prompt_ids = std::move(prompt_ids);
+  task_data->config = std::move(config);
+  task_data->cancelled = std::make_shared<std::atomic<bool>>(false);
 
-      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
-        continue;
-      }
+  {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->generations[task_data->generation_id] = task_data->cancelled;
+  }
 
-      FlValue *tensor_id_map = fl_value_lookup_string(value, "valueId");
+  g_autoptr(GTask) task = g_task_new(self, nullptr, generation_done, nullptr);
+  g_task_set_task_data(task, task_data, generation_task_free);
+  g_task_run_in_thread(task, generation_thread);
 
-      if (tensor_id_map == nullptr || fl_value_get_type(tensor_id_map) != FL_VALUE_TYPE_STRING) {
-        continue;
-      }
+  return nullptr;
+}
 
-      std::string tensor_id = fl_value_get_string(tensor_id_map);
+static FlMethodResponse *cancel_generation(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *generation_id_value = fl_value_lookup_string(args, "generationId");
+  if (generation_id_value == nullptr || fl_value_get_type(generation_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Generation ID must be a non-null string", nullptr));
+  }
 
-      // Get the tensor value
-      Ort::Value *tensor_ptr = self->tensor_manager->getTensor(tensor_id);
-      if (tensor_ptr != nullptr) {
-        try {
-          // Use the tensor manager to clone the tensor
-          Ort::Value new_tensor = self->tensor_manager->cloneTensor(tensor_id);
-          input_tensors.push_back(std::move(new_tensor));
-        } catch (const std::exception &e) {
-          g_warning("Failed to clone tensor %s: %s", tensor_id.c_str(), e.what());
-          // Continue with the next tensor
-        }
-      }
-    }
+  // Unknown IDs are ignored: the generation may already have finished
+  std::lock_guard<std::mutex> lock(self->mutex);
+  auto it = self->generations.find(fl_value_get_string(generation_id_value));
+  if (it != self->generations.end()) {
+    it->second->store(true);
+  }
 
-    // Create and configure run options
-    Ort::RunOptions run_options;
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
 
-    // Configure run options if provided
-    if (run_options_value != nullptr && fl_value_get_type(run_options_value) == FL_VALUE_TYPE_MAP) {
-      // Extract log severity level if provided
-      FlValue *log_severity_level_value = fl_value_lookup_string(run_options_value, "logSeverityLevel");
-      if (log_severity_level_value != nullptr && fl_value_get_type(log_severity_level_value) == FL_VALUE_TYPE_INT) {
-        run_options.SetRunLogSeverityLevel(fl_value_get_int(log_severity_level_value));
-      }
+// Parse one glue op map, e.g. {op: "resize", height: 224, width: 224}
+static GlueOp parse_glue_op(FlValue *op_value) {
+  if (fl_value_get_type(op_value) != FL_VALUE_TYPE_MAP) {
+    throw Ort::Exception("Glue ops must be maps", ORT_INVALID_ARGUMENT);
+  }
 
-      // Extract log verbosity level if provided
-      FlValue *log_verbosity_level_value = fl_value_lookup_string(run_options_value, "logVerbosityLevel");
-      if (log_verbosity_level_value != nullptr && fl_value_get_type(log_verbosity_level_value) == FL_VALUE_TYPE_INT) {
-        run_options.SetRunLogVerbosityLevel(fl_value_get_int(log_verbosity_level_value));
-      }
+  GlueOp op;
+  FlValue *name_value = fl_value_lookup_string(op_value, "op");
+  if (name_value == nullptr || fl_value_get_type(name_value) != FL_VALUE_TYPE_STRING) {
+    throw Ort::Exception("Glue op needs an 'op' name", ORT_INVALID_ARGUMENT);
+  }
+  op.op = fl_value_get_string(name_value);
 
-      // Extract terminate option if provided
-      FlValue *terminate_value = fl_value_lookup_string(run_options_value, "terminate");
-      if (terminate_value != nullptr && fl_value_get_type(terminate_value) == FL_VALUE_TYPE_BOOL) {
-        if (fl_value_get_bool(terminate_value)) {
-          run_options.SetTerminate();
-        }
-      }
+  if (op.op == "crop") {
+    if (!fl_value_to_int64_vector(fl_value_lookup_string(op_value, "starts"), op.starts) ||
+        !fl_value_to_int64_vector(fl_value_lookup_string(op_value, "ends"), op.ends)) {
+      throw Ort::Exception("crop needs integer lists 'starts' and 'ends'", ORT_INVALID_ARGUMENT);
     }
-
-    // Run inference using SessionManager
-    std::vector<Ort::Value> output_tensors;
-    if (!input_tensors.empty()) {
-      output_tensors = self->session_manager->runInference(session_id, input_tensors, &run_options);
+  } else if (op.op == "resize") {
+    FlValue *height_value = fl_value_lookup_string(op_value, "height");
+    FlValue *width_value = fl_value_lookup_string(op_value, "width");
+    if (height_value == nullptr || width_value == nullptr || fl_value_get_type(height_value) != FL_VALUE_TYPE_INT ||
+        fl_value_get_type(width_value) != FL_VALUE_TYPE_INT) {
+      throw Ort::Exception("resize needs integer 'height' and 'width'", ORT_INVALID_ARGUMENT);
     }
+    op.height = fl_value_get_int(height_value);
+    op.width = fl_value_get_int(width_value);
+  } else if (op.op == "cast") {
+    FlValue *to_value = fl_value_lookup_string(op_value, "to");
+    if (to_value == nullptr || fl_value_get_type(to_value) != FL_VALUE_TYPE_STRING) {
+      throw Ort::Exception("cast needs a target type 'to'", ORT_INVALID_ARGUMENT);
+    }
+    op.to = elementTypeFromString(fl_value_get_string(to_value));
+  } else {
+    throw Ort::Exception("Unknown glue op: " + op.op, ORT_INVALID_ARGUMENT);
+  }
 
-    // Process outputs
-    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+  return op;
+}
 
-    // For each output tensor, directly store it using TensorManager's storeTensor
-    for (size_t i = 0; i < output_tensors.size(); i++) {
-      // Create a tensor ID
-      std::string value_id = self->tensor_manager->generateTensorId();
+static FlMethodResponse *create_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *stages_value = fl_value_lookup_string(args, "stages");
+  if (stages_value == nullptr || fl_value_get_type(stages_value) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Stages must be a non-null list", nullptr));
+  }
+  FlValue *edges_value = fl_value_lookup_string(args, "edges");
 
-      // Store the tensor directly using storeTensor - this transfers ownership
-      self->tensor_manager->storeTensor(value_id, std::move(output_tensors[i]));
+  try {
+    std::vector<PipelineStage> stages;
+    for (size_t i = 0; i < fl_value_get_length(stages_value); i++) {
+      FlValue *stage_value = fl_value_get_list_value(stages_value, i);
+      FlValue *name_value =
+          fl_value_get_type(stage_value) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(stage_value, "name") : nullptr;
+      FlValue *session_value = fl_value_get_type(stage_value) == FL_VALUE_TYPE_MAP
+                                   ? fl_value_lookup_string(stage_value, "sessionId")
+                                   : nullptr;
+      if (name_value == nullptr || session_value == nullptr || fl_value_get_type(name_value) != FL_VALUE_TYPE_STRING ||
+          fl_value_get_type(session_value) != FL_VALUE_TYPE_STRING) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_ARG", "Each stage needs a name and a sessionId", nullptr));
+      }
+      stages.push_back({fl_value_get_string(name_value), fl_value_get_string(session_value)});
+    }
 
-      // get the tensor type and shape from tensor manager
-      // Note: only do this after storeTensor get the tensor registered in tensor manager
-      std::string tensor_type = self->tensor_manager->getTensorType(value_id);
-      std::vector<int64_t> shape = self->tensor_manager->getTensorShape(value_id);
+    std::vector<PipelineEdge> edges;
+    if (edges_value != nullptr && fl_value_get_type(edges_value) == FL_VALUE_TYPE_LIST) {
+      for (size_t i = 0; i < fl_value_get_length(edges_value); i++) {
+        FlValue *edge_value = fl_value_get_list_value(edges_value, i);
+        FlValue *from_value =
+            fl_value_get_type(edge_value) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(edge_value, "from") : nullptr;
+        FlValue *to_value =
+            fl_value_get_type(edge_value) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(edge_value, "to") : nullptr;
+        if (from_value == nullptr || to_value == nullptr || fl_value_get_type(from_value) != FL_VALUE_TYPE_STRING ||
+            fl_value_get_type(to_value) != FL_VALUE_TYPE_STRING) {
+          return FL_METHOD_RESPONSE(
+              fl_method_error_response_new("INVALID_ARG", "Each edge needs 'from' and 'to' endpoints", nullptr));
+        }
 
-      // Add the value ID to the outputs map
-      FlValue *shape_list = fl_value_new_list();
-      for (const auto &dim : shape) {
-        fl_value_append_take(shape_list, fl_value_new_int(dim));
+        PipelineEdge edge;
+        edge.from = fl_value_get_string(from_value);
+        edge.to = fl_value_get_string(to_value);
+        FlValue *ops_value = fl_value_lookup_string(edge_value, "ops");
+        if (ops_value != nullptr && fl_value_get_type(ops_value) == FL_VALUE_TYPE_LIST) {
+          for (size_t j = 0; j < fl_value_get_length(ops_value); j++) {
+            edge.ops.push_back(parse_glue_op(fl_value_get_list_value(ops_value, j)));
+          }
+        }
+        edges.push_back(std::move(edge));
       }
+    }
 
-      // Note: Flutter does not allow return a nested map, so we have to use list here to keep the output_info format
-      FlValue *output_info = fl_value_new_list();
-      fl_value_append_take(output_info, fl_value_new_string(value_id.c_str()));
-      fl_value_append_take(output_info, fl_value_new_string(tensor_type.c_str()));
-      fl_value_append_take(output_info, shape_list);
+    std::string pipeline_id = self->pipeline_manager->createPipeline(stages, edges);
 
-      fl_value_set_string_take(outputs_map, output_names[i].c_str(), output_info);
-    }
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "pipelineId", fl_value_new_string(pipeline_id.c_str()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } catch (const Ort::Exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_FAILED", e.what(), nullptr));
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
   }
 }
 
-static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  // Get session ID
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    // Similar to closeSession, return success even if ID is invalid.
-    // Alternatively, return an error:
+static FlMethodResponse *run_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *pipeline_id_value = fl_value_lookup_string(args, "pipelineId");
+  if (pipeline_id_value == nullptr || fl_value_get_type(pipeline_id_value) != FL_VALUE_TYPE_STRING) {
     return FL_METHOD_RESPONSE(
-        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+        fl_method_error_response_new("INVALID_ARG", "Pipeline ID must be a non-null string", nullptr));
   }
+  const char *pipeline_id = fl_value_get_string(pipeline_id_value);
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
-  self->session_manager->closeSession(session_id);
-
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
-}
-
-static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
-  if (!self->session_manager->hasSession(session_id)) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  if (!self->pipeline_manager->hasPipeline(pipeline_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PIPELINE", "Pipeline not found", nullptr));
   }
 
   try {
-    // Get metadata using the SessionManager
-    ModelMetadata metadata = self->session_manager->getModelMetadata(session_id);
-
-    // Create empty custom metadata map
-    FlValue *custom_metadata_map = fl_value_new_map();
-    g_autoptr(FlValue) result = fl_value_new_map();
-    fl_value_set_string_take(result, "producerName", fl_value_new_string(metadata.producer_name.c_str()));
-    fl_value_set_string_take(result, "graphName", fl_value_new_string(metadata.graph_name.c_str()));
-    fl_value_set_string_take(result, "domain", fl_value_new_string(metadata.domain.c_str()));
-    fl_value_set_string_take(result, "description", fl_value_new_string(metadata.description.c_str()));
-    fl_value_set_string_take(result, "version", fl_value_new_int(metadata.version));
-    fl_value_set_string_take(result, "customMetadataMap", custom_metadata_map);
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    NamedTensors outputs = self->pipeline_manager->runPipeline(pipeline_id, collect_input_tensors(self, inputs_value));
+    g_autoptr(FlValue) outputs_map = store_output_tensors(self, outputs, read_scope_id(args));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
   } catch (const Ort::Exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_FAILED", e.what(), nullptr));
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
   }
 }
 
-static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+static FlMethodResponse *close_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *pipeline_id_value = fl_value_lookup_string(args, "pipelineId");
+  if (pipeline_id_value == nullptr || fl_value_get_type(pipeline_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Pipeline ID must be a non-null string", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
+  self->pipeline_manager->closePipeline(fl_value_get_string(pipeline_id_value));
 
-  if (!self->session_manager->hasSession(session_id)) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *start_pipeline_stream(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *pipeline_id_value = fl_value_lookup_string(args, "pipelineId");
+  if (pipeline_id_value == nullptr || fl_value_get_type(pipeline_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Pipeline ID must be a non-null string", nullptr));
   }
+  const char *pipeline_id = fl_value_get_string(pipeline_id_value);
 
-  try {
-    // Get input info from SessionManager
-    std::vector<TensorInfo> input_info = self->session_manager->getInputInfo(session_id);
-    g_autoptr(FlValue) result = fl_value_new_list();
+  // Two frames per stage: one being worked on, one waiting (double buffering)
+  size_t queue_capacity = 2;
+  FlValue *capacity_value = fl_value_lookup_string(args, "queueCapacity");
+  if (capacity_value != nullptr && fl_value_get_type(capacity_value) == FL_VALUE_TYPE_INT) {
+    if (fl_value_get_int(capacity_value) < 1) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Queue capacity must be at least 1", nullptr));
+    }
+    queue_capacity = static_cast<size_t>(fl_value_get_int(capacity_value));
+  }
+
+  if (!self->pipeline_manager->hasPipeline(pipeline_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PIPELINE", "Pipeline not found", nullptr));
+  }
 
-    for (const auto &info : input_info) {
-      FlValue *info_map = fl_value_new_map();
-      fl_value_set_string_take(info_map, "name", fl_value_new_string(info.name.c_str()));
+  // Runs on the last stage's thread; waits here if the platform thread falls behind, which throttles the stream
+  auto on_result = [self](const std::string &stream_id, uint64_t frame_id, NamedTensors &&outputs,
+                          const std::string &error) {
+    if (self->event_stream == nullptr) {
+      return;
+    }
 
-      // Add shape
-      FlValue *shape_list = fl_value_new_list();
-      for (const auto &dim : info.shape) {
-        fl_value_append_take(shape_list, fl_value_new_int(dim));
+    FlValue *event = fl_value_new_map();
+    fl_value_set_string_take(event, "event", fl_value_new_string("pipelineResult"));
+    fl_value_set_string_take(event, "streamId", fl_value_new_string(stream_id.c_str()));
+    fl_value_set_string_take(event, "frameId", fl_value_new_int(static_cast<int64_t>(frame_id)));
+    std::vector<std::string> value_ids;
+    if (error.empty()) {
+      FlValue *outputs_map = store_output_tensors(self, outputs, "");
+      for (size_t i = 0; i < fl_value_get_length(outputs_map); i++) {
+        FlValue *output_info = fl_value_get_map_value(outputs_map, i);
+        value_ids.push_back(fl_value_get_string(fl_value_get_list_value(output_info, 0)));
       }
-      fl_value_set_string_take(info_map, "shape", shape_list);
+      fl_value_set_string_take(event, "outputs", outputs_map);
+    } else {
+      fl_value_set_string_take(event, "error", fl_value_new_string(error.c_str()));
+    }
 
-      // Add type
-      fl_value_set_string_take(info_map, "type", fl_value_new_string(info.type.c_str()));
+    // Outputs of a result that never reaches Dart have no owner, so they are released here
+    self->event_stream->push(event, true, [self, value_ids]() {
+      for (const auto &value_id : value_ids) {
+        self->tensor_manager->releaseTensor(value_id);
+      }
+    });
+  };
 
-      fl_value_append_take(result, info_map);
+  // Tells Dart that no more results will follow for this stream
+  auto on_closed = [self](const std::string &stream_id) {
+    if (self->event_stream == nullptr) {
+      return;
     }
+
+    FlValue *event = fl_value_new_map();
+    fl_value_set_string_take(event, "event", fl_value_new_string("pipelineStreamClosed"));
+    fl_value_set_string_take(event, "streamId", fl_value_new_string(stream_id.c_str()));
+    self->event_stream->push(event);
+  };
+
+  try {
+    std::string stream_id = self->pipeline_manager->startStream(pipeline_id, queue_capacity, on_result, on_closed);
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "streamId", fl_value_new_string(stream_id.c_str()));
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } catch (const Ort::Exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PIPELINE", e.what(), nullptr));
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
   }
 }
 
-static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+static FlMethodResponse *push_pipeline_frame(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *stream_id_value = fl_value_lookup_string(args, "streamId");
+  if (stream_id_value == nullptr || fl_value_get_type(stream_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Stream ID must be a non-null string", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
+  FlValue *frame_id_value = fl_value_lookup_string(args, "frameId");
+  if (frame_id_value == nullptr || fl_value_get_type(frame_id_value) != FL_VALUE_TYPE_INT) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Frame ID must be an integer", nullptr));
+  }
 
-  if (!self->session_manager->hasSession(session_id)) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
   }
 
   try {
-    // Get output info from SessionManager
-    std::vector<TensorInfo> output_info = self->session_manager->getOutputInfo(session_id);
-    g_autoptr(FlValue) result = fl_value_new_list();
-
-    for (const auto &info : output_info) {
-      FlValue *info_map = fl_value_new_map();
-      fl_value_set_string_take(info_map, "name", fl_value_new_string(info.name.c_str()));
-
-      // Add shape
-      FlValue *shape_list = fl_value_new_list();
-      for (const auto &dim : info.shape) {
-        fl_value_append_take(shape_list, fl_value_new_int(dim));
-      }
-      fl_value_set_string_take(info_map, "shape", shape_list);
+    bool accepted = self->pipeline_manager->pushFrame(fl_value_get_string(stream_id_value),
+                                                      static_cast<uint64_t>(fl_value_get_int(frame_id_value)),
+                                                      collect_input_tensors(self, inputs_value));
 
-      // Add type
-      fl_value_set_string_take(info_map, "type", fl_value_new_string(info.type.c_str()));
-
-      fl_value_append_take(result, info_map);
-    }
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "accepted", fl_value_new_bool(accepted));
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } catch (const Ort::Exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PIPELINE", e.what(), nullptr));
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
   }
 }
 
+static FlMethodResponse *stop_pipeline_stream(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *stream_id_value = fl_value_lookup_string(args, "streamId");
+  if (stream_id_value == nullptr || fl_value_get_type(stream_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Stream ID must be a non-null string", nullptr));
+  }
+
+  self->pipeline_manager->stopStream(fl_value_get_string(stream_id_value));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
 static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
   FlValue *source_type_value = fl_value_lookup_string(args, "sourceType");
   FlValue *data_value = fl_value_lookup_string(args, "data");
@@ -649,6 +2386,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
   }
 
   std::string valueId;
+  std::string scope_id = read_scope_id(args);
 
   try {
     // Handle data according to source type
@@ -676,7 +2414,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for float32 type", nullptr));
       }
-      valueId = self->tensor_manager->createFloat32Tensor(data_vec, shape);
+      valueId = self->tensor_manager->createFloat32Tensor(data_vec, shape, scope_id);
     } else if (strcmp(source_type, "int32") == 0) {
       std::vector<int32_t> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_INT32_LIST) {
@@ -698,7 +2436,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int32 type", nullptr));
       }
-      valueId = self->tensor_manager->createInt32Tensor(data_vec, shape);
+      valueId = self->tensor_manager->createInt32Tensor(data_vec, shape, scope_id);
     } else if (strcmp(source_type, "int64") == 0) {
       std::vector<int64_t> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_INT64_LIST) {
@@ -720,7 +2458,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int64 type", nullptr));
       }
-      valueId = self->tensor_manager->createInt64Tensor(data_vec, shape);
+      valueId = self->tensor_manager->createInt64Tensor(data_vec, shape, scope_id);
     } else if (strcmp(source_type, "uint8") == 0) {
       std::vector<uint8_t> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_UINT8_LIST) {
@@ -742,7 +2480,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int8 type", nullptr));
       }
-      valueId = self->tensor_manager->createUint8Tensor(data_vec, shape);
+      valueId = self->tensor_manager->createUint8Tensor(data_vec, shape, scope_id);
     } else if (strcmp(source_type, "bool") == 0) {
       std::vector<bool> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
@@ -760,7 +2498,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of booleans for bool type", nullptr));
       }
-      valueId = self->tensor_manager->createBoolTensor(data_vec, shape);
+      valueId = self->tensor_manager->createBoolTensor(data_vec, shape, scope_id);
     } else if (strcmp(source_type, "string") == 0) {
       std::vector<std::string> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
@@ -778,7 +2516,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of strings for string type", nullptr));
       }
-      valueId = self->tensor_manager->createStringTensor(data_vec, shape);
+      valueId = self->tensor_manager->createStringTensor(data_vec, shape, scope_id);
     } else {
       std::string error_message = "Unsupported source data type: ";
       error_message += source_type;
@@ -816,11 +2554,16 @@ static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlVal
   const char *value_id = fl_value_get_string(value_id_value);
   const char *target_type = fl_value_get_string(target_type_value);
 
+  if (self->tensor_manager->wasEvicted(value_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("EVICTED_VALUE", evicted_value_message(value_id).c_str(), nullptr));
+  }
+
   std::string new_tensor_id;
   try {
     std::lock_guard<std::mutex> lock(self->mutex);
 
-    new_tensor_id = self->tensor_manager->convertTensor(value_id, target_type);
+    new_tensor_id = self->tensor_manager->convertTensor(value_id, target_type, read_scope_id(args));
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", e.what(), nullptr));
   }
@@ -859,6 +2602,10 @@ static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlVa
       if (tensor_data != nullptr) {
         fl_value_unref(tensor_data);
       }
+      if (self->tensor_manager->wasEvicted(value_id)) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("EVICTED_VALUE", evicted_value_message(value_id).c_str(), nullptr));
+      }
       return FL_METHOD_RESPONSE(
           fl_method_error_response_new("INVALID_VALUE", "Tensor not found or already being disposed", nullptr));
     }
@@ -884,3 +2631,216 @@ static FlMethodResponse *release_ort_value(FlutterOnnxruntimePlugin *self, FlVal
 
   return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
 }
+
+static FlMethodResponse *pin_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *value_id_value = fl_value_lookup_string(args, "valueId");
+  FlValue *pinned_value = fl_value_lookup_string(args, "pinned");
+
+  if (value_id_value == nullptr || fl_value_get_type(value_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
+  }
+  if (pinned_value == nullptr || fl_value_get_type(pinned_value) != FL_VALUE_TYPE_BOOL) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Pinned must be a boolean", nullptr));
+  }
+
+  const char *value_id = fl_value_get_string(value_id_value);
+  if (!self->tensor_manager->setPinned(value_id, fl_value_get_bool(pinned_value))) {
+    if (self->tensor_manager->wasEvicted(value_id)) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("EVICTED_VALUE", evicted_value_message(value_id).c_str(), nullptr));
+    }
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_VALUE", "Tensor not found", nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_tensor_budget(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *budget_value = fl_value_lookup_string(args, "budgetBytes");
+  FlValue *soft_limit_value = fl_value_lookup_string(args, "softLimitBytes");
+
+  if (budget_value == nullptr || fl_value_get_type(budget_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(budget_value) < 0 || soft_limit_value == nullptr ||
+      fl_value_get_type(soft_limit_value) != FL_VALUE_TYPE_INT || fl_value_get_int(soft_limit_value) < 0) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Budget and soft limit must be non-negative integers", nullptr));
+  }
+
+  self->tensor_manager->configureBudget(static_cast<size_t>(fl_value_get_int(budget_value)),
+                                        static_cast<size_t>(fl_value_get_int(soft_limit_value)));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *begin_scope(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *parent_id_value = fl_value_lookup_string(args, "parentId");
+  std::string parent_id;
+  if (parent_id_value != nullptr && fl_value_get_type(parent_id_value) == FL_VALUE_TYPE_STRING) {
+    parent_id = fl_value_get_string(parent_id_value);
+  }
+
+  try {
+    std::string scope_id = self->tensor_manager->beginScope(parent_id);
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "scopeId", fl_value_new_string(scope_id.c_str()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *release_scope(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *scope_id_value = fl_value_lookup_string(args, "scopeId");
+  FlValue *keep_value = fl_value_lookup_string(args, "keep");
+
+  if (scope_id_value == nullptr || fl_value_get_type(scope_id_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Scope ID cannot be null", nullptr));
+  }
+
+  std::set<std::string> keep_ids;
+  if (keep_value != nullptr && fl_value_get_type(keep_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(keep_value); i++) {
+      FlValue *value_id = fl_value_get_list_value(keep_value, i);
+      if (fl_value_get_type(value_id) == FL_VALUE_TYPE_STRING) {
+        keep_ids.insert(fl_value_get_string(value_id));
+      }
+    }
+  }
+
+  try {
+    size_t released = self->tensor_manager->releaseScope(fl_value_get_string(scope_id_value), keep_ids);
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "released", fl_value_new_int(static_cast<int64_t>(released)));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+}
+
+// Copy `value`, replacing every {"$ref": index, "path": [...]} map by the part of results[index] the path
+// leads to. Path steps are map keys, or indices into lists. Throws std::invalid_argument on a bad reference.
+static FlValue *resolve_batch_refs(FlValue *value, FlValue *results) {
+  FlValueType type = fl_value_get_type(value);
+  if (type == FL_VALUE_TYPE_LIST) {
+    g_autoptr(FlValue) copy = fl_value_new_list();
+    for (size_t i = 0; i < fl_value_get_length(value); i++) {
+      fl_value_append_take(copy, resolve_batch_refs(fl_value_get_list_value(value, i), results));
+    }
+    return static_cast<FlValue *>(g_steal_pointer(&copy));
+  }
+  if (type != FL_VALUE_TYPE_MAP) {
+    return fl_value_ref(value);
+  }
+
+  FlValue *ref_value = fl_value_lookup_string(value, "$ref");
+  if (ref_value == nullptr) {
+    g_autoptr(FlValue) copy = fl_value_new_map();
+    for (size_t i = 0; i < fl_value_get_length(value); i++) {
+      fl_value_set_take(copy, fl_value_ref(fl_value_get_map_key(value, i)),
+                        resolve_batch_refs(fl_value_get_map_value(value, i), results));
+    }
+    return static_cast<FlValue *>(g_steal_pointer(&copy));
+  }
+
+  if (fl_value_get_type(ref_value) != FL_VALUE_TYPE_INT || fl_value_get_int(ref_value) < 0 ||
+      static_cast<size_t>(fl_value_get_int(ref_value)) >= fl_value_get_length(results)) {
+    throw std::invalid_argument("A batch reference must name an earlier operation");
+  }
+  int64_t index = fl_value_get_int(ref_value);
+  FlValue *target = fl_value_get_list_value(results, static_cast<size_t>(index));
+
+  FlValue *path_value = fl_value_lookup_string(value, "path");
+  if (path_value != nullptr && fl_value_get_type(path_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(path_value) && target != nullptr; i++) {
+      FlValue *step = fl_value_get_list_value(path_value, i);
+      if (fl_value_get_type(target) == FL_VALUE_TYPE_LIST && fl_value_get_type(step) == FL_VALUE_TYPE_INT) {
+        int64_t position = fl_value_get_int(step);
+        bool in_range = position >= 0 && static_cast<size_t>(position) < fl_value_get_length(target);
+        target = in_range ? fl_value_get_list_value(target, static_cast<size_t>(position)) : nullptr;
+      } else if (fl_value_get_type(target) == FL_VALUE_TYPE_MAP) {
+        target = fl_value_lookup(target, step);
+      } else {
+        target = nullptr;
+      }
+    }
+  }
+  if (target == nullptr) {
+    throw std::invalid_argument("Batch reference path not found in the result of operation " +
+                                std::to_string(index));
+  }
+  return fl_value_ref(target);
+}
+
+static FlMethodResponse *execute_batch(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *operations_value = fl_value_lookup_string(args, "operations");
+  if (operations_value == nullptr || fl_value_get_type(operations_value) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Operations must be a non-null list", nullptr));
+  }
+
+  // Operations run in order on this thread, exactly as if each had been its own call
+  g_autoptr(FlValue) results = fl_value_new_list();
+  for (size_t i = 0; i < fl_value_get_length(operations_value); i++) {
+    FlValue *operation = fl_value_get_list_value(operations_value, i);
+    bool is_map = fl_value_get_type(operation) == FL_VALUE_TYPE_MAP;
+    FlValue *method_value = is_map ? fl_value_lookup_string(operation, "method") : nullptr;
+    FlValue *operation_args = is_map ? fl_value_lookup_string(operation, "args") : nullptr;
+    if (operation_args != nullptr && fl_value_get_type(operation_args) == FL_VALUE_TYPE_NULL) {
+      operation_args = nullptr;
+    }
+
+    g_autoptr(FlMethodResponse) response = nullptr;
+    if (method_value == nullptr || fl_value_get_type(method_value) != FL_VALUE_TYPE_STRING) {
+      response = FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Each operation needs a method name", nullptr));
+    } else if (operation_args != nullptr && fl_value_get_type(operation_args) != FL_VALUE_TYPE_MAP) {
+      response =
+          FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Operation args must be a map", nullptr));
+    } else {
+      const gchar *method = fl_value_get_string(method_value);
+      try {
+        g_autoptr(FlValue) resolved_args =
+            operation_args != nullptr ? resolve_batch_refs(operation_args, results) : fl_value_new_map();
+        response = dispatch_sync_method(self, method, resolved_args);
+      } catch (const std::invalid_argument &e) {
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+      } catch (const std::exception &e) {
+        // Backstop for handlers that let an exception through; it must not escape the method-call callback
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+      }
+      // Methods responding from a worker thread, and batches themselves, cannot be nested
+      if (response == nullptr) {
+        std::string message = std::string("Method cannot run in a batch: ") + method;
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", message.c_str(), nullptr));
+      }
+    }
+
+    if (FL_IS_METHOD_SUCCESS_RESPONSE(response)) {
+      fl_value_append(results, fl_method_success_response_get_result(FL_METHOD_SUCCESS_RESPONSE(response)));
+      continue;
+    }
+
+    // Stop at the first failure. Values created by earlier operations stay alive; their results are in the
+    // details so the caller can release them.
+    const gchar *code = "PLUGIN_ERROR";
+    std::string message = "Operation " + std::to_string(i) + " failed";
+    if (FL_IS_METHOD_ERROR_RESPONSE(response)) {
+      FlMethodErrorResponse *error = FL_METHOD_ERROR_RESPONSE(response);
+      code = fl_method_error_response_get_code(error);
+      const gchar *error_message = fl_method_error_response_get_message(error);
+      if (error_message != nullptr) {
+        message += std::string(": ") + error_message;
+      }
+    }
+
+    g_autoptr(FlValue) details = fl_value_new_map();
+    fl_value_set_string_take(details, "index", fl_value_new_int(static_cast<int64_t>(i)));
+    fl_value_set_string_take(details, "code", fl_value_new_string(code));
+    fl_value_set_string(details, "results", results);
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("BATCH_FAILED", message.c_str(), details));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(results));
+}
@@ -0,0 +1,246 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "generation.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+TokenSampler::TokenSampler(const GenerationConfig &config)
+    : temperature_(config.temperature), top_k_(config.top_k), top_p_(config.top_p), rng_(config.seed) {}
+
+int64_t TokenSampler::sample(const float *logits, size_t vocab_size) {
+  if (vocab_size == 0) {
+    throw Ort::Exception("Logits are empty", ORT_INVALID_ARGUMENT);
+  }
+
+  // Greedy decoding
+  if (temperature_ <= 0.0f) {
+    return std::max_element(logits, logits + vocab_size) - logits;
+  }
+
+  candidates_.resize(vocab_size);
+  for (size_t i = 0; i < vocab_size; i++) {
+    candidates_[i] = {logits[i] / temperature_, static_cast<int64_t>(i)};
+  }
+
+  // Keep the candidates sorted by descending logit; only the top k need ordering when top-k is set
+  auto by_logit = [](const std::pair<float, int64_t> &a, const std::pair<float, int64_t> &b) {
+    return a.first > b.first;
+  };
+  size_t keep = vocab_size;
+  if (top_k_ > 0 && static_cast<size_t>(top_k_) < vocab_size) {
+    keep = static_cast<size_t>(top_k_);
+    std::partial_sort(candidates_.begin(), candidates_.begin() + keep, candidates_.end(), by_logit);
+  } else {
+    std::sort(candidates_.begin(), candidates_.end(), by_logit);
+  }
+  candidates_.resize(keep);
+
+  // Softmax over the remaining candidates
+  float max_logit = candidates_.front().first;
+  float sum = 0.0f;
+  for (auto &candidate : candidates_) {
+    candidate.first = std::exp(candidate.first - max_logit);
+    sum += candidate.first;
+  }
+
+  // Nucleus filtering: keep the smallest prefix whose probability mass reaches top_p
+  if (top_p_ < 1.0f) {
+    float cumulative = 0.0f;
+    size_t cutoff = 0;
+    while (cutoff < candidates_.size()) {
+      cumulative += candidates_[cutoff++].first / sum;
+      if (cumulative >= top_p_) {
+        break;
+      }
+    }
+    candidates_.resize(cutoff);
+    sum = 0.0f;
+    for (const auto &candidate : candidates_) {
+      sum += candidate.first;
+    }
+  }
+
+  std::uniform_real_distribution<float> distribution(0.0f, sum);
+  float target = distribution(rng_);
+  for (const auto &candidate : candidates_) {
+    target -= candidate.first;
+    if (target <= 0.0f) {
+      return candidate.second;
+    }
+  }
+  return candidates_.back().second;
+}
+
+namespace {
+
+// Create a [1, values.size()] int32 or int64 tensor, following the type the model declares for the input
+Ort::Value createIdsTensor(const std::vector<int64_t> &values, const std::string &type) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<int64_t> shape = {1, static_cast<int64_t>(values.size())};
+
+  if (type == "int32") {
+    Ort::Value tensor =
+        Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32);
+    int32_t *data = tensor.GetTensorMutableData<int32_t>();
+    for (size_t i = 0; i < values.size(); i++) {
+      data[i] = static_cast<int32_t>(values[i]);
+    }
+    return tensor;
+  }
+  if (type == "int64") {
+    Ort::Value tensor =
+        Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+    std::copy(values.begin(), values.end(), tensor.GetTensorMutableData<int64_t>());
+    return tensor;
+  }
+  throw Ort::Exception("Unsupported id tensor type: " + type, ORT_INVALID_ARGUMENT);
+}
+
+// Claims the session state for one generation and puts the caller's bindings and state back on every exit
+class StateClaim {
+public:
+  StateClaim(SessionManager &session_manager, const std::string &session_id)
+      : session_manager_(session_manager), session_id_(session_id),
+        saved_(session_manager.claimState(session_id)) {}
+
+  ~StateClaim() { session_manager_.restoreState(session_id_, std::move(saved_)); }
+
+  StateClaim(const StateClaim &) = delete;
+  StateClaim &operator=(const StateClaim &) = delete;
+
+  const std::map<std::string, std::string> &bindings() const { return saved_.bindings; }
+
+private:
+  SessionManager &session_manager_;
+  std::string session_id_;
+  SavedState saved_;
+};
+
+} // namespace
+
+GenerationResult runGeneration(SessionManager &session_manager, const std::string &session_id,
+                               const std::vector<int64_t> &prompt_ids, const GenerationConfig &config,
+                               const TokenCallback &on_token, const std::atomic<bool> *cancelled) {
+  if (prompt_ids.empty()) {
+    throw Ort::Exception("Prompt must contain at least one token", ORT_INVALID_ARGUMENT);
+  }
+
+  std::map<std::string, std::string> input_types;
+  for (const auto &info : session_manager.getInputInfo(session_id)) {
+    input_types[info.name] = info.type;
+  }
+  std::vector<std::string> output_names = session_manager.getOutputNames(session_id);
+
+  if (input_types.count(config.input_ids_name) == 0) {
+    throw Ort::Exception("Model has no input named " + config.input_ids_name, ORT_INVALID_ARGUMENT);
+  }
+  if (std::find(output_names.begin(), output_names.end(), config.logits_name) == output_names.end()) {
+    throw Ort::Exception("Model has no output named " + config.logits_name, ORT_INVALID_ARGUMENT);
+  }
+  bool has_attention_mask = input_types.count(config.attention_mask_name) > 0;
+  bool has_position_ids = input_types.count(config.position_ids_name) > 0;
+
+  // Other runs on the session fail as busy until the generation ends
+  StateClaim claim(session_manager, session_id);
+
+  // Bind the KV cache by the usual naming convention unless the caller set bindings explicitly
+  std::map<std::string, std::string> bindings = claim.bindings();
+  if (bindings.empty()) {
+    const std::string present_prefix = "present";
+    for (const auto &output_name : output_names) {
+      if (output_name.compare(0, present_prefix.size(), present_prefix) != 0) {
+        continue;
+      }
+      std::string input_name = "past_key_values" + output_name.substr(present_prefix.size());
+      if (input_types.count(input_name) > 0) {
+        bindings[output_name] = input_name;
+      }
+    }
+    if (!bindings.empty()) {
+      session_manager.setStateBindings(session_id, bindings);
+    }
+  }
+  bool uses_cache = !bindings.empty();
+  session_manager.initEmptyState(session_id);
+
+  TokenSampler sampler(config);
+  GenerationResult result;
+  std::vector<int64_t> sequence = prompt_ids;
+  // Tokens not yet seen by the model; with a KV cache only these are fed on the next step
+  std::vector<int64_t> pending = prompt_ids;
+
+  while (true) {
+    if (cancelled != nullptr && cancelled->load()) {
+      result.stop_reason = "cancelled";
+      break;
+    }
+    if (static_cast<int64_t>(sequence.size()) >= config.max_length) {
+      result.stop_reason = "maxLength";
+      break;
+    }
+
+    const std::vector<int64_t> &step_ids = uses_cache ? pending : sequence;
+    size_t past_length = sequence.size() - step_ids.size();
+
+    std::vector<std::string> input_names = {config.input_ids_name};
+    std::vector<Ort::Value> input_tensors;
+    input_tensors.push_back(createIdsTensor(step_ids, input_types[config.input_ids_name]));
+
+    if (has_attention_mask) {
+      input_names.push_back(config.attention_mask_name);
+      input_tensors.push_back(
+          createIdsTensor(std::vector<int64_t>(sequence.size(), 1), input_types[config.attention_mask_name]));
+    }
+    if (has_position_ids) {
+      std::vector<int64_t> positions(step_ids.size());
+      for (size_t i = 0; i < positions.size(); i++) {
+        positions[i] = static_cast<int64_t>(past_length + i);
+      }
+      input_names.push_back(config.position_ids_name);
+      input_tensors.push_back(createIdsTensor(positions, input_types[config.position_ids_name]));
+    }
+
+    NamedTensors outputs = session_manager.runInference(session_id, input_names, std::move(input_tensors));
+
+    auto logits_it = std::find_if(outputs.begin(), outputs.end(),
+                                  [&](const auto &output) { return output.first == config.logits_name; });
+    if (logits_it == outputs.end()) {
+      throw Ort::Exception("Model did not produce " + config.logits_name, ORT_FAIL);
+    }
+
+    auto logits_info = logits_it->second.GetTensorTypeAndShapeInfo();
+    if (logits_info.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+      throw Ort::Exception("Logits must be float32", ORT_INVALID_ARGUMENT);
+    }
+    std::vector<int64_t> logits_shape = logits_info.GetShape();
+    if (logits_shape.empty()) {
+      throw Ort::Exception("Logits must have a vocabulary dimension", ORT_INVALID_ARGUMENT);
+    }
+
+    // Logits are [batch, vocab] or [batch, sequence, vocab]; sample from the last position
+    size_t vocab_size = static_cast<size_t>(logits_shape.back());
+    size_t element_count = logits_info.GetElementCount();
+    const float *logits = logits_it->second.GetTensorData<float>() + (element_count - vocab_size);
+
+    int64_t token = sampler.sample(logits, vocab_size);
+    sequence.push_back(token);
+    pending.assign(1, token);
+    result.tokens.push_back(token);
+
+    if (on_token) {
+      on_token(token, result.tokens.size() - 1);
+    }
+
+    if (std::find(config.stop_tokens.begin(), config.stop_tokens.end(), token) != config.stop_tokens.end()) {
+      result.stop_reason = "stopToken";
+      break;
+    }
+  }
+
+  return result;
+}
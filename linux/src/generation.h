@@ -0,0 +1,78 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef GENERATION_H
+#define GENERATION_H
+
+#include "session_manager.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Settings for an autoregressive decode loop over a decoder-only model
+struct GenerationConfig {
+  // Names of the model inputs and outputs driven by the loop. Position ids and attention mask are only
+  // fed when the model declares them.
+  std::string input_ids_name = "input_ids";
+  std::string attention_mask_name = "attention_mask";
+  std::string position_ids_name = "position_ids";
+  std::string logits_name = "logits";
+
+  // Total sequence length (prompt plus generated tokens) at which generation stops
+  int64_t max_length = 128;
+
+  // Token ids that end generation once produced (the stop token itself is emitted)
+  std::vector<int64_t> stop_tokens;
+
+  // Sampling parameters. A temperature of 0 selects greedy decoding, top_k of 0 disables top-k filtering
+  // and top_p of 1 disables nucleus filtering.
+  float temperature = 0.0f;
+  int64_t top_k = 0;
+  float top_p = 1.0f;
+  uint64_t seed = 0;
+};
+
+// Outcome of a generation run
+struct GenerationResult {
+  std::vector<int64_t> tokens;
+  // One of "stopToken", "maxLength" or "cancelled"
+  std::string stop_reason;
+};
+
+// Picks the next token from a row of logits
+class TokenSampler {
+public:
+  explicit TokenSampler(const GenerationConfig &config);
+
+  int64_t sample(const float *logits, size_t vocab_size);
+
+private:
+  float temperature_;
+  int64_t top_k_;
+  float top_p_;
+  std::mt19937_64 rng_;
+
+  // Scratch buffer of (probability, token id) reused across steps
+  std::vector<std::pair<float, int64_t>> candidates_;
+};
+
+// Called on the generating thread for every produced token
+using TokenCallback = std::function<void(int64_t token, size_t index)>;
+
+// Runs the decode loop for a session. When the session has no state bindings, `present*` outputs are bound
+// to the matching `past_key_values*` inputs so the KV cache stays native between steps; without any bound
+// state the whole sequence is fed on every step. The generation starts from empty state and claims it for
+// its duration, so other runs on the session fail as busy meanwhile; the caller's bindings and state are
+// restored when it returns, is cancelled or throws.
+GenerationResult runGeneration(SessionManager &session_manager, const std::string &session_id,
+                               const std::vector<int64_t> &prompt_ids, const GenerationConfig &config,
+                               const TokenCallback &on_token, const std::atomic<bool> *cancelled = nullptr);
+
+#endif // GENERATION_H
@@ -0,0 +1,60 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef HASHING_H
+#define HASHING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hashing_detail {
+
+constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t mixWord(uint64_t k) { return rotl(k * kC1, 31) * kC2; }
+
+// MurmurHash3 finalizer: every input bit affects every output bit
+inline uint64_t finalize(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace hashing_detail
+
+// Initial value for hashBytes
+constexpr uint64_t kHashSeed = 0x9e3779b97f4a7c15ULL;
+
+// Non-cryptographic 64-bit hash of `size` bytes, continuing from `seed` (kHashSeed or an earlier result).
+// Words are mixed MurmurHash3-style, fast on large tensors and without the linear bits a plain word-folded
+// FNV hash has. Callers that must not confuse two inputs still compare them on a hash match.
+inline uint64_t hashBytes(uint64_t seed, const void *data, size_t size) {
+  using namespace hashing_detail;
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  uint64_t h = seed;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    h ^= mixWord(word);
+    h = rotl(h, 27) * 5 + 0x52dce729;
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, size - i);
+    h ^= mixWord(word);
+  }
+  return finalize(h ^ size);
+}
+
+#endif // HASHING_H
@@ -0,0 +1,56 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "lora_adapter_manager.h"
+
+LoraAdapterManager::LoraAdapterManager() : next_adapter_id_(1) {}
+
+std::string LoraAdapterManager::loadAdapter(const std::string &path) {
+  // Without an allocator the weights stay in CPU memory and are copied to the device by each run that uses them
+  return storeAdapter(Ort::LoraAdapter::CreateLoraAdapter(path, nullptr));
+}
+
+std::string LoraAdapterManager::loadAdapterFromBytes(const uint8_t *data, size_t size) {
+  if (size == 0) {
+    throw Ort::Exception("Adapter data is empty", ORT_INVALID_ARGUMENT);
+  }
+  return storeAdapter(Ort::LoraAdapter::CreateLoraAdapterFromArray(data, size, nullptr));
+}
+
+std::string LoraAdapterManager::storeAdapter(Ort::LoraAdapter &&adapter) {
+  auto shared_adapter = std::make_shared<Ort::LoraAdapter>(std::move(adapter));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string adapter_id = "lora_adapter_" + std::to_string(next_adapter_id_++);
+  adapters_[adapter_id] = std::move(shared_adapter);
+  return adapter_id;
+}
+
+bool LoraAdapterManager::releaseAdapter(const std::string &adapter_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return adapters_.erase(adapter_id) > 0;
+}
+
+ActiveLoraAdapters LoraAdapterManager::activate(const std::vector<std::string> &adapter_ids,
+                                                Ort::RunOptions &run_options) {
+  ActiveLoraAdapters active;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &adapter_id : adapter_ids) {
+      auto it = adapters_.find(adapter_id);
+      if (it == adapters_.end()) {
+        throw Ort::Exception("LoRA adapter not found: " + adapter_id, ORT_INVALID_ARGUMENT);
+      }
+      active.adapters.push_back(it->second);
+    }
+  }
+
+  for (const auto &adapter : active.adapters) {
+    run_options.AddActiveLoraAdapter(*adapter);
+  }
+  active.ids = adapter_ids;
+  return active;
+}
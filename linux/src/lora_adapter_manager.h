@@ -0,0 +1,55 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef LORA_ADAPTER_MANAGER_H
+#define LORA_ADAPTER_MANAGER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+// Adapters activated for one run. The run must end before this is destroyed.
+struct ActiveLoraAdapters {
+  std::vector<std::shared_ptr<Ort::LoraAdapter>> adapters;
+  // IDs in activation order, which also key cached results of the run
+  std::vector<std::string> ids;
+};
+
+// Class to manage LoRA adapters, so a single loaded base model serves several fine-tuned variants.
+// An adapter holds only the low-rank weights and is switched per run through its run options.
+class LoraAdapterManager {
+public:
+  LoraAdapterManager();
+
+  // Disallow copy and assign
+  LoraAdapterManager(const LoraAdapterManager &) = delete;
+  LoraAdapterManager &operator=(const LoraAdapterManager &) = delete;
+
+  // Load an adapter file (.onnx_adapter) and return its ID
+  std::string loadAdapter(const std::string &path);
+
+  // Load an adapter from the content of such a file, which ONNX Runtime copies, and return its ID
+  std::string loadAdapterFromBytes(const uint8_t *data, size_t size);
+
+  // Release an adapter. Runs that already activated it keep it until they end. Returns false if the ID is unknown.
+  bool releaseAdapter(const std::string &adapter_id);
+
+  // Activate the adapters with `adapter_ids` in `run_options`. Throws Ort::Exception if an ID is unknown.
+  ActiveLoraAdapters activate(const std::vector<std::string> &adapter_ids, Ort::RunOptions &run_options);
+
+private:
+  std::string storeAdapter(Ort::LoraAdapter &&adapter);
+
+  std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<Ort::LoraAdapter>> adapters_;
+  uint64_t next_adapter_id_;
+};
+
+#endif // LORA_ADAPTER_MANAGER_H
@@ -0,0 +1,290 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "pipeline_manager.h"
+#include "tensor_ops.h"
+#include <algorithm>
+
+PipelineManager::PipelineManager(SessionManager *session_manager)
+    : session_manager_(session_manager), next_pipeline_id_(1), next_stream_id_(1) {}
+
+PipelineManager::~PipelineManager() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &stream : streams_) {
+    stream.second->queues.front()->close();
+    stopped_streams_.push_back(std::move(stream.second));
+  }
+  streams_.clear();
+  reapStoppedStreams(true);
+}
+
+size_t PipelineManager::resolveEndpoint(const std::vector<PipelineStage> &stages, const std::string &endpoint,
+                                        std::string &tensor_name) {
+  size_t dot = endpoint.find('.');
+  if (dot == std::string::npos) {
+    throw Ort::Exception("Endpoint must be written stage.tensor: " + endpoint, ORT_INVALID_ARGUMENT);
+  }
+
+  std::string stage_name = endpoint.substr(0, dot);
+  tensor_name = endpoint.substr(dot + 1);
+  for (size_t i = 0; i < stages.size(); i++) {
+    if (stages[i].name == stage_name) {
+      return i;
+    }
+  }
+  throw Ort::Exception("Unknown pipeline stage: " + stage_name, ORT_INVALID_ARGUMENT);
+}
+
+std::string PipelineManager::createPipeline(const std::vector<PipelineStage> &stages,
+                                            const std::vector<PipelineEdge> &edges) {
+  if (stages.empty()) {
+    throw Ort::Exception("Pipeline needs at least one stage", ORT_INVALID_ARGUMENT);
+  }
+
+  PipelineInfo info;
+  for (const auto &stage : stages) {
+    if (stage.name.empty() || stage.name.find('.') != std::string::npos) {
+      throw Ort::Exception("Stage names must be non-empty and must not contain '.'", ORT_INVALID_ARGUMENT);
+    }
+    for (const auto &existing : info.stages) {
+      if (existing.name == stage.name) {
+        throw Ort::Exception("Duplicate pipeline stage: " + stage.name, ORT_INVALID_ARGUMENT);
+      }
+    }
+    if (!session_manager_->hasSession(stage.session_id)) {
+      throw Ort::Exception("Session not found: " + stage.session_id, ORT_INVALID_ARGUMENT);
+    }
+    info.stages.push_back(stage);
+  }
+
+  for (const auto &edge : edges) {
+    PipelineInfo::Route route;
+    route.from_stage = resolveEndpoint(info.stages, edge.from, route.output);
+    route.to_stage = resolveEndpoint(info.stages, edge.to, route.input);
+    route.ops = edge.ops;
+
+    if (route.from_stage >= route.to_stage) {
+      throw Ort::Exception("Edge must feed a later stage: " + edge.from + " -> " + edge.to, ORT_INVALID_ARGUMENT);
+    }
+
+    std::vector<std::string> outputs = session_manager_->getOutputNames(info.stages[route.from_stage].session_id);
+    if (std::find(outputs.begin(), outputs.end(), route.output) == outputs.end()) {
+      throw Ort::Exception("Unknown output: " + edge.from, ORT_INVALID_ARGUMENT);
+    }
+    std::vector<std::string> inputs = session_manager_->getInputNames(info.stages[route.to_stage].session_id);
+    if (std::find(inputs.begin(), inputs.end(), route.input) == inputs.end()) {
+      throw Ort::Exception("Unknown input: " + edge.to, ORT_INVALID_ARGUMENT);
+    }
+    for (const auto &existing : info.routes) {
+      if (existing.to_stage == route.to_stage && existing.input == route.input) {
+        throw Ort::Exception("Input fed by more than one edge: " + edge.to, ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    info.routes.push_back(std::move(route));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string pipeline_id = "pipeline_" + std::to_string(next_pipeline_id_++);
+  pipelines_.emplace(pipeline_id, std::move(info));
+  return pipeline_id;
+}
+
+bool PipelineManager::hasPipeline(const std::string &pipeline_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pipelines_.find(pipeline_id) != pipelines_.end();
+}
+
+void PipelineManager::closePipeline(const std::string &pipeline_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pipelines_.erase(pipeline_id);
+}
+
+Ort::Value PipelineManager::applyGlueOps(Ort::Value &&tensor, const std::vector<GlueOp> &ops) {
+  Ort::Value current = std::move(tensor);
+  for (const auto &op : ops) {
+    if (op.op == "crop") {
+      current = cropTensor(current, op.starts, op.ends);
+    } else if (op.op == "resize") {
+      current = resizeTensor(current, op.height, op.width);
+    } else if (op.op == "cast") {
+      current = castTensor(current, op.to);
+    } else {
+      throw Ort::Exception("Unknown glue op: " + op.op, ORT_INVALID_ARGUMENT);
+    }
+  }
+  return current;
+}
+
+NamedTensors PipelineManager::runPipeline(const std::string &pipeline_id, NamedTensors &&inputs) {
+  PipelineInfo info;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pipelines_.find(pipeline_id);
+    if (it == pipelines_.end()) {
+      throw Ort::Exception("Pipeline not found", ORT_INVALID_ARGUMENT);
+    }
+    info = it->second;
+  }
+
+  // Inputs waiting for each stage, filled from the caller and then from edges
+  std::vector<NamedTensors> stage_inputs(info.stages.size());
+  for (auto &input : inputs) {
+    std::string input_name;
+    size_t stage = resolveEndpoint(info.stages, input.first, input_name);
+    stage_inputs[stage].emplace_back(input_name, std::move(input.second));
+  }
+
+  NamedTensors results;
+  for (size_t stage = 0; stage < info.stages.size(); stage++) {
+    runStage(info, stage, stage_inputs, results);
+  }
+
+  return results;
+}
+
+void PipelineManager::runStage(const PipelineInfo &info, size_t stage, std::vector<NamedTensors> &stage_inputs,
+                               NamedTensors &results) {
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_tensors;
+  for (auto &input : stage_inputs[stage]) {
+    input_names.push_back(input.first);
+    input_tensors.push_back(std::move(input.second));
+  }
+  stage_inputs[stage].clear();
+
+  NamedTensors outputs =
+      session_manager_->runInference(info.stages[stage].session_id, input_names, std::move(input_tensors));
+
+  for (auto &output : outputs) {
+    std::vector<const PipelineInfo::Route *> routes;
+    for (const auto &route : info.routes) {
+      if (route.from_stage == stage && route.output == output.first) {
+        routes.push_back(&route);
+      }
+    }
+
+    if (routes.empty()) {
+      results.emplace_back(info.stages[stage].name + "." + output.first, std::move(output.second));
+      continue;
+    }
+
+    // Fan out: every edge but the last gets its own copy, the last one takes the tensor itself
+    for (size_t i = 0; i < routes.size(); i++) {
+      Ort::Value tensor = i + 1 < routes.size() ? cloneValue(output.second) : std::move(output.second);
+      stage_inputs[routes[i]->to_stage].emplace_back(routes[i]->input, applyGlueOps(std::move(tensor), routes[i]->ops));
+    }
+  }
+}
+
+std::string PipelineManager::startStream(const std::string &pipeline_id, size_t queue_capacity,
+                                         FrameCallback on_result, StreamClosedCallback on_closed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reapStoppedStreams(false);
+
+  auto it = pipelines_.find(pipeline_id);
+  if (it == pipelines_.end()) {
+    throw Ort::Exception("Pipeline not found", ORT_INVALID_ARGUMENT);
+  }
+
+  auto stream = std::make_unique<PipelineStream>();
+  stream->id = "stream_" + std::to_string(next_stream_id_++);
+  stream->info = it->second;
+  stream->on_result = std::move(on_result);
+  stream->on_closed = std::move(on_closed);
+  for (size_t stage = 0; stage < stream->info.stages.size(); stage++) {
+    stream->queues.push_back(std::make_unique<BoundedQueue<std::unique_ptr<PipelineFrame>>>(queue_capacity));
+  }
+  for (size_t stage = 0; stage < stream->info.stages.size(); stage++) {
+    stream->workers.emplace_back(&PipelineManager::streamWorker, this, stream.get(), stage);
+  }
+
+  std::string stream_id = stream->id;
+  streams_.emplace(stream_id, std::move(stream));
+  return stream_id;
+}
+
+bool PipelineManager::pushFrame(const std::string &stream_id, uint64_t frame_id, NamedTensors &&inputs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = streams_.find(stream_id);
+  if (it == streams_.end()) {
+    throw Ort::Exception("Stream not found", ORT_INVALID_ARGUMENT);
+  }
+  PipelineStream *stream = it->second.get();
+
+  auto frame = std::make_unique<PipelineFrame>();
+  frame->id = frame_id;
+  frame->stage_inputs.resize(stream->info.stages.size());
+  for (auto &input : inputs) {
+    std::string input_name;
+    size_t stage = resolveEndpoint(stream->info.stages, input.first, input_name);
+    frame->stage_inputs[stage].emplace_back(input_name, std::move(input.second));
+  }
+
+  return stream->queues.front()->tryPush(frame);
+}
+
+void PipelineManager::stopStream(const std::string &stream_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = streams_.find(stream_id);
+  if (it == streams_.end()) {
+    return;
+  }
+
+  // Closing the first queue lets every stage drain and then close the queue after it
+  it->second->queues.front()->close();
+  stopped_streams_.push_back(std::move(it->second));
+  streams_.erase(it);
+  reapStoppedStreams(false);
+}
+
+void PipelineManager::streamWorker(PipelineStream *stream, size_t stage) {
+  size_t last_stage = stream->info.stages.size() - 1;
+  std::unique_ptr<PipelineFrame> frame;
+
+  while (stream->queues[stage]->pop(frame)) {
+    if (frame->error.empty()) {
+      try {
+        runStage(stream->info, stage, frame->stage_inputs, frame->results);
+      } catch (const std::exception &e) {
+        frame->error = e.what();
+      }
+    }
+
+    if (stage < last_stage) {
+      // Blocks while the next stage is saturated, which throttles this one in turn
+      if (!stream->queues[stage + 1]->push(frame)) {
+        break;
+      }
+    } else {
+      stream->on_result(stream->id, frame->id, std::move(frame->results), frame->error);
+    }
+    frame.reset();
+  }
+
+  if (stage < last_stage) {
+    stream->queues[stage + 1]->close();
+  } else {
+    stream->on_closed(stream->id);
+  }
+  stream->finished_workers++;
+}
+
+void PipelineManager::reapStoppedStreams(bool wait) {
+  for (auto it = stopped_streams_.begin(); it != stopped_streams_.end();) {
+    PipelineStream *stream = it->get();
+    if (!wait && stream->finished_workers.load() < stream->workers.size()) {
+      ++it;
+      continue;
+    }
+    for (auto &worker : stream->workers) {
+      worker.join();
+    }
+    it = stopped_streams_.erase(it);
+  }
+}
@@ -0,0 +1,157 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef PIPELINE_MANAGER_H
+#define PIPELINE_MANAGER_H
+
+#include "bounded_queue.h"
+#include "session_manager.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A glue operation applied to a tensor while it travels along an edge
+struct GlueOp {
+  // "crop", "resize" or "cast"
+  std::string op;
+  // crop: per-axis ranges
+  std::vector<int64_t> starts;
+  std::vector<int64_t> ends;
+  // resize: size of the last two axes
+  int64_t height = 0;
+  int64_t width = 0;
+  // cast: target element type
+  ONNXTensorElementDataType to = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+};
+
+// A stage runs one session
+struct PipelineStage {
+  // Stage name used in endpoints, must not contain '.'
+  std::string name;
+  std::string session_id;
+};
+
+// An edge feeds a stage output into an input of a later stage. Endpoints are written "stage.tensor".
+struct PipelineEdge {
+  std::string from;
+  std::string to;
+  std::vector<GlueOp> ops;
+};
+
+// Pipeline information structure
+struct PipelineInfo {
+  std::vector<PipelineStage> stages;
+
+  // Edges resolved to stage indices
+  struct Route {
+    size_t from_stage;
+    std::string output;
+    size_t to_stage;
+    std::string input;
+    std::vector<GlueOp> ops;
+  };
+  std::vector<Route> routes;
+};
+
+// One frame travelling through a pipeline stream
+struct PipelineFrame {
+  uint64_t id;
+  // Inputs waiting for each stage, filled by the caller and by edges
+  std::vector<NamedTensors> stage_inputs;
+  // Outputs not consumed by an edge, keyed "stage.output"
+  NamedTensors results;
+  // Set when a stage failed; later stages pass the frame on untouched
+  std::string error;
+};
+
+// Receives each finished frame on the last stage's thread, in frame order
+using FrameCallback = std::function<void(const std::string &stream_id, uint64_t frame_id, NamedTensors &&outputs,
+                                         const std::string &error)>;
+
+// Called once after the last frame of a stopped stream has been delivered
+using StreamClosedCallback = std::function<void(const std::string &stream_id)>;
+
+// A pipeline running one thread per stage, with bounded queues in between
+struct PipelineStream {
+  std::string id;
+  PipelineInfo info;
+  // queues[i] feeds stage i
+  std::vector<std::unique_ptr<BoundedQueue<std::unique_ptr<PipelineFrame>>>> queues;
+  std::vector<std::thread> workers;
+  FrameCallback on_result;
+  StreamClosedCallback on_closed;
+  // Workers that have returned; the stream can be joined without blocking once all have
+  std::atomic<size_t> finished_workers{0};
+};
+
+// Pipeline Manager Class: chains sessions so intermediate tensors never leave native memory
+class PipelineManager {
+public:
+  explicit PipelineManager(SessionManager *session_manager);
+  ~PipelineManager();
+
+  // Create a pipeline running the stages in the given order. Edges must go from an earlier stage to a
+  // later one and name existing outputs and inputs.
+  std::string createPipeline(const std::vector<PipelineStage> &stages, const std::vector<PipelineEdge> &edges);
+
+  // Check if a pipeline exists
+  bool hasPipeline(const std::string &pipeline_id);
+
+  // Close a pipeline; its sessions stay open
+  void closePipeline(const std::string &pipeline_id);
+
+  // Run a pipeline. Inputs are keyed "stage.input"; every stage output not consumed by an edge is
+  // returned keyed "stage.output".
+  NamedTensors runPipeline(const std::string &pipeline_id, NamedTensors &&inputs);
+
+  // Start streaming frames through a pipeline. Each stage runs on its own thread, so frame N+1 can be in
+  // an early stage while frame N is in a later one; throughput approaches that of the slowest stage.
+  // `queue_capacity` frames may wait in front of each stage (2 double-buffers every stage).
+  std::string startStream(const std::string &pipeline_id, size_t queue_capacity, FrameCallback on_result,
+                          StreamClosedCallback on_closed);
+
+  // Queue a frame without blocking. Inputs are keyed "stage.input" as for runPipeline. Returns false if the
+  // first stage is saturated, in which case the frame is dropped.
+  bool pushFrame(const std::string &stream_id, uint64_t frame_id, NamedTensors &&inputs);
+
+  // Stop accepting frames. Frames already queued still finish and are delivered; the threads are joined
+  // later, so this never blocks.
+  void stopStream(const std::string &stream_id);
+
+  // Apply glue operations to a tensor in order
+  static Ort::Value applyGlueOps(Ort::Value &&tensor, const std::vector<GlueOp> &ops);
+
+private:
+  // Run one stage: consume its queued inputs and route the outputs to later stages or to the results
+  void runStage(const PipelineInfo &info, size_t stage, std::vector<NamedTensors> &stage_inputs,
+                NamedTensors &results);
+
+  // Worker loop of one stage of a stream
+  void streamWorker(PipelineStream *stream, size_t stage);
+
+  // Join stopped streams whose workers have all returned. Callers hold mutex_.
+  void reapStoppedStreams(bool wait);
+
+  // Split "stage.tensor" at the first '.' and resolve the stage index
+  static size_t resolveEndpoint(const std::vector<PipelineStage> &stages, const std::string &endpoint,
+                                std::string &tensor_name);
+
+  SessionManager *session_manager_;
+  std::map<std::string, PipelineInfo> pipelines_;
+  std::map<std::string, std::unique_ptr<PipelineStream>> streams_;
+  std::vector<std::unique_ptr<PipelineStream>> stopped_streams_;
+  int next_pipeline_id_;
+  int next_stream_id_;
+  std::mutex mutex_;
+};
+
+#endif // PIPELINE_MANAGER_H
@@ -0,0 +1,164 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "result_cache.h"
+#include "hashing.h"
+#include "tensor_ops.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+void appendBytes(std::string &key, const void *data, size_t size) {
+  key.append(static_cast<const char *>(data), size);
+}
+
+template <typename T> void appendValue(std::string &key, const T &value) { appendBytes(key, &value, sizeof(value)); }
+
+// Length-prefixed after a tag naming the list, so no two lists of names share a key, whatever they hold
+void appendNames(std::string &key, char tag, const std::vector<std::string> &names) {
+  key += tag;
+  appendValue(key, names.size());
+  for (const auto &name : names) {
+    appendValue(key, name.size());
+    key += name;
+  }
+}
+
+} // namespace
+
+ResultCache::ResultCache(size_t max_entries, size_t max_bytes, KeyHasher hasher) : hasher_(hasher) {
+  stats_.max_entries = max_entries;
+  stats_.max_bytes = max_bytes;
+}
+
+uint64_t ResultCache::hashKey(const std::string &key) { return hashBytes(kHashSeed, key.data(), key.size()); }
+
+bool ResultCache::makeKey(const std::vector<std::string> &names, const std::vector<Ort::Value> &tensors,
+                          std::string &key) {
+  key.clear();
+  size_t count = std::min(names.size(), tensors.size());
+  appendValue(key, count);
+  for (size_t i = 0; i < count; i++) {
+    if (!tensors[i].IsTensor()) {
+      return false;
+    }
+    auto info = tensors[i].GetTensorTypeAndShapeInfo();
+    ONNXTensorElementDataType type = info.GetElementType();
+    size_t element_size = SessionManager::getElementSize(type);
+    if (element_size == 0) {
+      return false;
+    }
+
+    std::vector<int64_t> shape = info.GetShape();
+    appendValue(key, names[i].size());
+    key += names[i];
+    appendValue(key, type);
+    appendValue(key, shape.size());
+    appendBytes(key, shape.data(), shape.size() * sizeof(int64_t));
+    appendBytes(key, tensors[i].GetTensorRawData(), info.GetElementCount() * element_size);
+  }
+  return true;
+}
+
+void ResultCache::appendOutputNames(std::string &key, const std::vector<std::string> &output_names) {
+  appendNames(key, 'O', output_names);
+}
+
+void ResultCache::appendAdapterIds(std::string &key, const std::vector<std::string> &adapter_ids) {
+  appendNames(key, 'A', adapter_ids);
+}
+
+std::list<ResultCache::Entry>::iterator ResultCache::find(uint64_t hash, const std::string &key) {
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->key == key) {
+      return it->second;
+    }
+  }
+  return entries_.end();
+}
+
+bool ResultCache::lookup(const std::string &key, NamedTensors &outputs) {
+  uint64_t hash = hasher_(key);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto entry = find(hash, key);
+  if (entry == entries_.end()) {
+    stats_.misses++;
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  outputs.clear();
+  for (const auto &output : entry->outputs) {
+    outputs.emplace_back(output.first, cloneValue(output.second));
+  }
+  stats_.hits++;
+  return true;
+}
+
+void ResultCache::insert(std::string key, const NamedTensors &outputs) {
+  if (stats_.max_entries == 0) {
+    return;
+  }
+
+  size_t bytes = key.size();
+  for (const auto &output : outputs) {
+    if (!output.second.IsTensor()) {
+      return;
+    }
+    auto info = output.second.GetTensorTypeAndShapeInfo();
+    size_t element_size = SessionManager::getElementSize(info.GetElementType());
+    if (element_size == 0) {
+      return;
+    }
+    bytes += info.GetElementCount() * element_size;
+  }
+  if (stats_.max_bytes > 0 && bytes > stats_.max_bytes) {
+    return;
+  }
+
+  // Hash and copy outside the lock; the caller keeps the originals
+  uint64_t hash = hasher_(key);
+  Entry entry{hash, std::move(key), {}, bytes};
+  for (const auto &output : outputs) {
+    entry.outputs.emplace_back(output.first, cloneValue(output.second));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // A concurrent run of the same inputs may have stored them already
+  if (find(hash, entry.key) != entries_.end()) {
+    return;
+  }
+
+  while (!entries_.empty() && (entries_.size() >= stats_.max_entries ||
+                               (stats_.max_bytes > 0 && stats_.bytes + bytes > stats_.max_bytes))) {
+    auto victim = std::prev(entries_.end());
+    auto range = index_.equal_range(victim->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == victim) {
+        index_.erase(it);
+        break;
+      }
+    }
+    stats_.bytes -= victim->bytes;
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+
+  entries_.push_front(std::move(entry));
+  index_.emplace(hash, entries_.begin());
+  stats_.bytes += bytes;
+}
+
+ResultCacheStats ResultCache::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ResultCacheStats stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "session_manager.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Counters of a result cache
+struct ResultCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+  size_t max_entries = 0;
+  size_t max_bytes = 0;
+};
+
+// LRU cache of run outputs keyed by the inputs, so identical inputs skip the model. Entries are found by a hash
+// of the key and served only if the whole key matches.
+class ResultCache {
+public:
+  // Hash under which a key is indexed
+  using KeyHasher = uint64_t (*)(const std::string &key);
+
+  // `hasher` is only replaced by tests, e.g. to force collisions
+  ResultCache(size_t max_entries, size_t max_bytes, KeyHasher hasher = hashKey);
+
+  static uint64_t hashKey(const std::string &key);
+
+  // Build the key of a run from input names, element types, shapes and data. Returns false if an input cannot
+  // be keyed (e.g. a string tensor), in which case the run bypasses the cache.
+  static bool makeKey(const std::vector<std::string> &names, const std::vector<Ort::Value> &tensors,
+                      std::string &key);
+
+  // Append the names of the requested outputs to a key from makeKey, so runs fetching different
+  // outputs for the same inputs are cached apart
+  static void appendOutputNames(std::string &key, const std::vector<std::string> &output_names);
+
+  // Append the IDs of the LoRA adapters active in the run, so results of different adapters are cached apart
+  static void appendAdapterIds(std::string &key, const std::vector<std::string> &adapter_ids);
+
+  // Fill `outputs` with copies of the outputs stored for `key` and mark the entry as most recently used
+  bool lookup(const std::string &key, NamedTensors &outputs);
+
+  // Store copies of `outputs`, evicting least recently used entries until the limits are met. The key counts
+  // toward the byte limit. Results that are not numeric or larger than the byte limit on their own are not stored.
+  void insert(std::string key, const NamedTensors &outputs);
+
+  ResultCacheStats getStats();
+
+private:
+  struct Entry {
+    uint64_t hash;
+    std::string key;
+    NamedTensors outputs;
+    size_t bytes;
+  };
+
+  // Entry with `key` and hash `hash`, or entries_.end(); callers hold mutex_
+  std::list<Entry>::iterator find(uint64_t hash, const std::string &key);
+
+  // Most recently used first
+  std::list<Entry> entries_;
+  // Keys of different entries may share a hash
+  std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index_;
+  ResultCacheStats stats_;
+  KeyHasher hasher_;
+  std::mutex mutex_;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,78 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef SCOPE_ARENA_H
+#define SCOPE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bump allocator for the tensor buffers of one scope. Allocation advances a pointer within the current
+// block and nothing is freed individually; all blocks go at once when the arena is destroyed.
+class ScopeArena {
+public:
+  ScopeArena() : used_(0), capacity_(0) {}
+
+  ScopeArena(const ScopeArena &) = delete;
+  ScopeArena &operator=(const ScopeArena &) = delete;
+  ScopeArena(ScopeArena &&) = default;
+  ScopeArena &operator=(ScopeArena &&) = default;
+
+  // Uninitialized storage for `count` elements, aligned for SIMD loads
+  template <typename T> T *allocate(size_t count) {
+    return static_cast<T *>(allocateBytes(std::max<size_t>(count, 1) * sizeof(T)));
+  }
+
+  // Whether `ptr` points into memory of this arena
+  bool owns(const void *ptr) const {
+    const uint8_t *byte = static_cast<const uint8_t *>(ptr);
+    for (const auto &block : blocks_) {
+      if (byte >= block.data.get() && byte < block.data.get() + block.size) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static constexpr size_t kAlignment = 64;
+  static constexpr size_t kMinBlockSize = 64 * 1024;
+
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+  };
+
+  // Offset of the first aligned address at or after `used` bytes into the block at `start`. The address is
+  // rounded, not the offset, since the block itself need not be aligned.
+  static size_t alignedOffset(const uint8_t *start, size_t used) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(start) + used;
+    return used + (((address + kAlignment - 1) & ~(kAlignment - 1)) - address);
+  }
+
+  void *allocateBytes(size_t bytes) {
+    size_t offset = blocks_.empty() ? 0 : alignedOffset(blocks_.back().data.get(), used_);
+    if (blocks_.empty() || offset + bytes > capacity_) {
+      // Grow geometrically; the extra alignment slack lets the block start be rounded up
+      size_t size = std::max({bytes + kAlignment, kMinBlockSize, capacity_ * 2});
+      blocks_.push_back({std::unique_ptr<uint8_t[]>(new uint8_t[size]), size});
+      capacity_ = size;
+      offset = alignedOffset(blocks_.back().data.get(), 0);
+    }
+    used_ = offset + bytes;
+    return blocks_.back().data.get() + offset;
+  }
+
+  std::vector<Block> blocks_;
+  // Bytes used and available in the last block
+  size_t used_;
+  size_t capacity_;
+};
+
+#endif // SCOPE_ARENA_H
@@ -5,9 +5,273 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "session_manager.h"
+#include "result_cache.h"
+#include "tensor_ops.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <sys/stat.h>
+#include <thread>
 
-SessionManager::SessionManager() : next_session_id_(1), env_(ORT_LOGGING_LEVEL_WARNING, "FlutterOnnxRuntime") {
+// Gives the borrowed entries of a run's feed back without freeing them, however the run ends
+struct BorrowedFeeds {
+  std::vector<Ort::Value> &feeds;
+  std::vector<bool> borrowed;
+
+  ~BorrowedFeeds() {
+    for (size_t i = 0; i < feeds.size() && i < borrowed.size(); i++) {
+      if (borrowed[i]) {
+        feeds[i].release();
+      }
+    }
+  }
+};
+
+// Fail if another thread holds the claim on the session's state. Call with state_mutex held.
+static void checkStateOwner(const SessionInfo &session_info) {
+  if (session_info.state_owner != std::thread::id() && session_info.state_owner != std::this_thread::get_id()) {
+    throw Ort::Exception("Session is busy generating", ORT_FAIL);
+  }
+}
+
+// Symbolic name of every dimension of a tensor type, empty where the dimension has none
+static std::vector<std::string> symbolicDimensions(const Ort::TypeInfo &type_info) {
+  std::vector<std::string> dim_names;
+  if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+    for (const char *dim_name : type_info.GetTensorTypeAndShapeInfo().GetSymbolicDimensions()) {
+      dim_names.push_back(dim_name != nullptr ? dim_name : "");
+    }
+  }
+  return dim_names;
+}
+
+// Whether the input `input_name` has the named dimension `dim`
+static bool inputHasDim(const ModelEntry &model, const std::string &input_name, const std::string &dim) {
+  auto index = model.input_index.find(input_name);
+  if (index == model.input_index.end()) {
+    return false;
+  }
+  const std::vector<std::string> &dim_names = model.input_dim_names[index->second];
+  return std::find(dim_names.begin(), dim_names.end(), dim) != dim_names.end();
+}
+
+// Check a bucketing setup against a model, once, so runs only look up what they need. Constant inputs are
+// fed as they are, never padded, so none may have the bucketed dimension.
+static std::shared_ptr<const BucketingConfig>
+makeBucketingConfig(const ModelEntry &model, const std::string &dim, std::vector<int64_t> buckets,
+                    const std::string &mask_input,
+                    const std::map<std::string, std::shared_ptr<Ort::Value>> &constant_inputs) {
+  auto config = std::make_shared<BucketingConfig>();
+  config->dim = dim;
+  bool found = false;
+  for (const auto &dim_names : model.input_dim_names) {
+    found = found || std::find(dim_names.begin(), dim_names.end(), dim) != dim_names.end();
+  }
+  if (!found) {
+    throw Ort::Exception("No input has the free dimension " + dim, ORT_INVALID_ARGUMENT);
+  }
+  for (const auto &constant : constant_inputs) {
+    if (inputHasDim(model, constant.first, dim)) {
+      throw Ort::Exception("Constant input " + constant.first + " has the bucketed dimension " + dim,
+                           ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  std::sort(buckets.begin(), buckets.end());
+  buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+  if (buckets.front() < 1) {
+    throw Ort::Exception("Bucket sizes must be positive", ORT_INVALID_ARGUMENT);
+  }
+  config->buckets = std::move(buckets);
+
+  if (!mask_input.empty()) {
+    auto index = model.input_index.find(mask_input);
+    if (index == model.input_index.end()) {
+      throw Ort::Exception("Unknown input: " + mask_input, ORT_INVALID_ARGUMENT);
+    }
+    const std::vector<std::string> &dim_names = model.input_dim_names[index->second];
+    auto axis = std::find(dim_names.begin(), dim_names.end(), dim);
+    if (axis == dim_names.end()) {
+      throw Ort::Exception("Mask input " + mask_input + " lacks the dimension " + dim, ORT_INVALID_ARGUMENT);
+    }
+    config->mask_input = mask_input;
+    config->mask_axis = static_cast<size_t>(axis - dim_names.begin());
+    config->mask_type =
+        model.session->GetInputTypeInfo(index->second).GetTensorTypeAndShapeInfo().GetElementType();
+  }
+  return config;
+}
+
+int64_t applyBucketing(const BucketingConfig &config, const ModelEntry &model, std::vector<std::string> &names,
+                       std::vector<Ort::Value> &tensors) {
+  // Axis of the bucketed dimension in every input having it, and the size of every named dimension
+  std::vector<int64_t> axes(names.size(), -1);
+  std::map<std::string, int64_t> sizes;
+  int64_t length = -1;
+  for (size_t i = 0; i < names.size(); i++) {
+    auto index = model.input_index.find(names[i]);
+    if (index == model.input_index.end() || !tensors[i].IsTensor()) {
+      continue;
+    }
+    const std::vector<std::string> &dim_names = model.input_dim_names[index->second];
+    std::vector<int64_t> shape = tensors[i].GetTensorTypeAndShapeInfo().GetShape();
+    for (size_t dim = 0; dim < dim_names.size() && dim < shape.size(); dim++) {
+      if (dim_names[dim].empty()) {
+        continue;
+      }
+      sizes.emplace(dim_names[dim], shape[dim]);
+      if (dim_names[dim] == config.dim) {
+        // Inputs disagreeing on the size are left for ONNX Runtime to report
+        if (length >= 0 && length != shape[dim]) {
+          return -1;
+        }
+        length = shape[dim];
+        axes[i] = static_cast<int64_t>(dim);
+      }
+    }
+  }
+
+  auto bucket = std::lower_bound(config.buckets.begin(), config.buckets.end(), length);
+  if (length < 0 || bucket == config.buckets.end()) {
+    return -1;
+  }
+
+  if (*bucket > length) {
+    for (size_t i = 0; i < tensors.size(); i++) {
+      if (axes[i] >= 0) {
+        tensors[i] = padTensor(tensors[i], static_cast<size_t>(axes[i]), *bucket);
+      }
+    }
+  }
+
+  // A mask passed by the caller was padded with zeros above, which masks the padding already
+  if (!config.mask_input.empty() && std::find(names.begin(), names.end(), config.mask_input) == names.end()) {
+    size_t mask_index = model.input_index.at(config.mask_input);
+    std::vector<int64_t> shape = model.input_info[mask_index].shape;
+    const std::vector<std::string> &dim_names = model.input_dim_names[mask_index];
+    for (size_t dim = 0; dim < shape.size(); dim++) {
+      if (dim == config.mask_axis) {
+        shape[dim] = *bucket;
+        continue;
+      }
+      if (shape[dim] >= 0) {
+        continue;
+      }
+      auto size = dim < dim_names.size() ? sizes.find(dim_names[dim]) : sizes.end();
+      if (size == sizes.end()) {
+        throw Ort::Exception("Cannot tell the shape of the mask input " + config.mask_input, ORT_INVALID_ARGUMENT);
+      }
+      shape[dim] = size->second;
+    }
+    names.push_back(config.mask_input);
+    tensors.push_back(maskTensor(shape, config.mask_type, config.mask_axis, length));
+  }
+
+  return length;
+}
+
+// Convert the input at `index` to the element type the model declares for it. The result lives in a buffer
+// of the calling thread kept for its next run, so a steady stream of same-sized inputs allocates nothing.
+// Inputs that already match, and types the cast does not handle (strings, bfloat16, complex), are left for
+// ONNX Runtime to accept or report.
+static void castToInputType(const ModelEntry &model, size_t index, Ort::Value &feed) {
+  thread_local std::vector<std::vector<uint8_t>> buffers;
+
+  ONNXTensorElementDataType target_type = model.input_types[index];
+  if (!feed.IsTensor() || !isCastableType(target_type)) {
+    return;
+  }
+  ONNXTensorElementDataType type = feed.GetTensorTypeAndShapeInfo().GetElementType();
+  if (type == target_type || !isCastableType(type)) {
+    return;
+  }
+  if (buffers.size() <= index) {
+    buffers.resize(index + 1);
+  }
+  feed = castTensorInto(feed, target_type, buffers[index]);
+}
+
+void cropBucketedOutputs(const BucketingConfig &config, const ModelEntry &model, NamedTensors &outputs,
+                         int64_t length) {
+  for (auto &output : outputs) {
+    auto index = model.output_index.find(output.first);
+    if (index == model.output_index.end() || !output.second.IsTensor() ||
+        SessionManager::getElementSize(output.second.GetTensorTypeAndShapeInfo().GetElementType()) == 0) {
+      continue;
+    }
+    const std::vector<std::string> &dim_names = model.output_dim_names[index->second];
+    if (std::find(dim_names.begin(), dim_names.end(), config.dim) == dim_names.end()) {
+      continue;
+    }
+    std::vector<int64_t> starts(dim_names.size(), 0);
+    std::vector<int64_t> ends(dim_names.size(), INT64_MAX);
+    for (size_t dim = 0; dim < dim_names.size(); dim++) {
+      if (dim_names[dim] == config.dim) {
+        ends[dim] = length;
+      }
+    }
+    output.second = cropTensor(output.second, starts, ends);
+  }
+}
+
+// The first shape variant whose fixed dimensions all appear in the inputs with exactly those sizes, or
+// the session's own model
+static std::shared_ptr<ModelEntry> selectShapeVariant(const SessionInfo &session_info,
+                                                      const std::vector<std::string> &input_names,
+                                                      const std::vector<Ort::Value> &input_tensors) {
+  const ModelEntry &model = *session_info.model;
+
+  // Size of every named dimension in this run's inputs
+  std::map<std::string, int64_t> sizes;
+  for (size_t i = 0; i < input_names.size(); i++) {
+    auto index = model.input_index.find(input_names[i]);
+    if (index == model.input_index.end() || !input_tensors[i].IsTensor()) {
+      continue;
+    }
+    const std::vector<std::string> &dim_names = model.input_dim_names[index->second];
+    std::vector<int64_t> shape = input_tensors[i].GetTensorTypeAndShapeInfo().GetShape();
+    for (size_t dim = 0; dim < dim_names.size() && dim < shape.size(); dim++) {
+      if (!dim_names[dim].empty()) {
+        sizes.emplace(dim_names[dim], shape[dim]);
+      }
+    }
+  }
+
+  for (const auto &variant : session_info.shape_variants) {
+    bool matches = true;
+    for (const auto &dim : variant.dims) {
+      auto size = sizes.find(dim.first);
+      if (size == sizes.end() || size->second != dim.second) {
+        matches = false;
+        break;
+      }
+    }
+    if (matches) {
+      return variant.model;
+    }
+  }
+  return session_info.model;
+}
+
+// Ensembles are typically a handful of models, each already using ORT's intra-op threads
+static size_t runManyThreadCount() {
+  size_t hardware_threads = std::thread::hardware_concurrency();
+  return std::min<size_t>(std::max<size_t>(hardware_threads, 2) - 1, 3);
+}
+
+// Pool threads for loading `model_count` models: every model loads at once, up to one load per hardware
+// thread. The calling thread loads too, so it is not counted.
+static size_t preloadThreadCount(size_t model_count) {
+  size_t hardware_threads = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+  return std::min(model_count, hardware_threads) - 1;
+}
+
+SessionManager::SessionManager()
+    : model_cache_budget_(0), model_use_tick_(0), shared_loads_(0), next_session_id_(1),
+      env_(ORT_LOGGING_LEVEL_WARNING, "FlutterOnnxRuntime"), worker_pool_(runManyThreadCount()) {
   // Initialize ONNX Runtime environment in constructor
 }
 
@@ -15,55 +279,200 @@ SessionManager::~SessionManager() {
   // Clear all sessions
   std::lock_guard<std::mutex> lock(mutex_);
   sessions_.clear();
+  models_.clear();
 }
 
-std::string SessionManager::createSession(const char *model_path, void *options) {
-  std::lock_guard<std::mutex> lock(mutex_);
+// Identify a model file by canonical path, size and modification time, so a replaced file is not shared
+static bool modelIdentity(const char *model_path, std::string &identity, size_t &size_bytes) {
+  char resolved[PATH_MAX];
+  struct stat file_stat;
+  if (realpath(model_path, resolved) == nullptr || stat(resolved, &file_stat) != 0) {
+    return false;
+  }
 
-  // Generate a session ID
-  std::string session_id = generateSessionId();
+  identity = std::string(resolved) + "|" + std::to_string(file_stat.st_size) + "|" +
+             std::to_string(file_stat.st_mtim.tv_sec) + "." + std::to_string(file_stat.st_mtim.tv_nsec);
+  size_bytes = static_cast<size_t>(file_stat.st_size);
+  return true;
+}
 
-  try {
-    // Create session options
-    Ort::SessionOptions session_options;
+std::shared_ptr<ModelEntry> SessionManager::loadModel(const char *model_path, Ort::SessionOptions *options) {
+  // Create session options
+  Ort::SessionOptions session_options;
+
+  // If options are provided, use them
+  if (options != nullptr) {
+    session_options = std::move(*options);
+  }
 
-    // If options are provided, use them
-    if (options != nullptr) {
-      // Cast the void* to the correct type
-      Ort::SessionOptions *provided_options = static_cast<Ort::SessionOptions *>(options);
+  // Create a new session
+  auto model = std::make_shared<ModelEntry>();
+  model->session = std::make_shared<Ort::Session>(env_, model_path, session_options);
 
-      // Directly use the provided options
-      session_options = std::move(*provided_options);
+  // Get input names
+  Ort::AllocatorWithDefaultOptions allocator;
+  size_t num_inputs = model->session->GetInputCount();
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto input_name = model->session->GetInputNameAllocated(i, allocator);
+    model->input_names.push_back(std::string(input_name.get()));
+  }
+
+  // Get output names
+  size_t num_outputs = model->session->GetOutputCount();
+  for (size_t i = 0; i < num_outputs; i++) {
+    auto output_name = model->session->GetOutputNameAllocated(i, allocator);
+    model->output_names.push_back(std::string(output_name.get()));
+  }
+
+  // The name vectors are complete, so pointers into them stay valid for the model's lifetime
+  for (size_t i = 0; i < model->input_names.size(); i++) {
+    model->input_name_ptrs.push_back(model->input_names[i].c_str());
+    model->input_index.emplace(model->input_names[i], i);
+  }
+  for (size_t i = 0; i < model->output_names.size(); i++) {
+    model->output_name_ptrs.push_back(model->output_names[i].c_str());
+    model->output_index.emplace(model->output_names[i], i);
+  }
+
+  // Read the type and shape of every input and output once
+  auto describe = [](const std::string &name, const Ort::TypeInfo &type_info) {
+    TensorInfo info{};
+    info.name = name;
+    if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+      auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+      info.shape = tensor_info.GetShape();
+      info.type = getElementTypeString(tensor_info.GetElementType());
     } else {
-      // Configure default execution providers
-      // Default to CPU execution provider
+      // Non-tensor type
+      info.type = "non-tensor";
     }
+    return info;
+  };
+  for (size_t i = 0; i < num_inputs; i++) {
+    Ort::TypeInfo type_info = model->session->GetInputTypeInfo(i);
+    model->input_info.push_back(describe(model->input_names[i], type_info));
+    model->input_types.push_back(type_info.GetONNXType() == ONNX_TYPE_TENSOR
+                                     ? type_info.GetTensorTypeAndShapeInfo().GetElementType()
+                                     : ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED);
+    model->input_dim_names.push_back(symbolicDimensions(type_info));
+  }
+  for (size_t i = 0; i < num_outputs; i++) {
+    Ort::TypeInfo type_info = model->session->GetOutputTypeInfo(i);
+    model->output_info.push_back(describe(model->output_names[i], type_info));
+    model->output_dim_names.push_back(symbolicDimensions(type_info));
+  }
 
-    // Create a new session
-    std::unique_ptr<Ort::Session> ort_session = std::make_unique<Ort::Session>(env_, model_path, session_options);
+  // Read the metadata once, including the producer's custom key/value pairs
+  try {
+    Ort::ModelMetadata model_metadata = model->session->GetModelMetadata();
+    model->metadata.producer_name = model_metadata.GetProducerNameAllocated(allocator).get();
+    model->metadata.graph_name = model_metadata.GetGraphNameAllocated(allocator).get();
+    model->metadata.domain = model_metadata.GetDomainAllocated(allocator).get();
+    model->metadata.description = model_metadata.GetDescriptionAllocated(allocator).get();
+    model->metadata.version = model_metadata.GetVersion();
+    for (const auto &key : model_metadata.GetCustomMetadataMapKeysAllocated(allocator)) {
+      auto value = model_metadata.LookupCustomMetadataMapAllocated(key.get(), allocator);
+      model->metadata.custom_metadata[key.get()] = value ? value.get() : "";
+    }
+  } catch (const Ort::Exception &e) {
+    std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+  }
 
-    // Create session info
-    SessionInfo session_info;
-    session_info.session = std::move(ort_session);
+  return model;
+}
 
-    // Get input names
-    Ort::AllocatorWithDefaultOptions allocator;
-    size_t num_inputs = session_info.session->GetInputCount();
-    session_info.input_names.clear();
+std::shared_ptr<ModelEntry> SessionManager::acquireModel(const char *model_path, Ort::SessionOptions *options,
+                                                         const std::string &options_key) {
+  std::string identity;
+  size_t size_bytes = 0;
+  std::string model_key;
+  if (modelIdentity(model_path, identity, size_bytes)) {
+    model_key = identity + "|" + options_key;
+  }
 
-    for (size_t i = 0; i < num_inputs; i++) {
-      auto input_name = session_info.session->GetInputNameAllocated(i, allocator);
-      session_info.input_names.push_back(std::string(input_name.get()));
+  // Find a loaded model, wait for a load of the same model already in progress, or load it ourselves.
+  // Loading happens outside mutex_, so other sessions keep running and other models load in parallel.
+  std::shared_ptr<ModelEntry> model;
+  std::shared_future<std::shared_ptr<ModelEntry>> pending_load;
+  std::promise<std::shared_ptr<ModelEntry>> load_promise;
+  bool loading = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto cached = model_key.empty() ? models_.end() : models_.find(model_key);
+    auto in_flight = model_key.empty() ? loading_.end() : loading_.find(model_key);
+    if (cached != models_.end()) {
+      // Same file, same options: hand out another handle to the loaded session
+      model = cached->second;
+      shared_loads_++;
+    } else if (in_flight != loading_.end()) {
+      pending_load = in_flight->second;
+      shared_loads_++;
+    } else if (!model_key.empty()) {
+      loading_[model_key] = load_promise.get_future().share();
+      loading = true;
     }
+  }
 
-    // Get output names
-    size_t num_outputs = session_info.session->GetOutputCount();
-    session_info.output_names.clear();
-
-    for (size_t i = 0; i < num_outputs; i++) {
-      auto output_name = session_info.session->GetOutputNameAllocated(i, allocator);
-      session_info.output_names.push_back(std::string(output_name.get()));
+  if (pending_load.valid()) {
+    // Rethrows the error if that load failed
+    model = pending_load.get();
+  } else if (!model) {
+    try {
+      model = loadModel(model_path, options);
+      model->key = model_key;
+      model->size_bytes = size_bytes;
+    } catch (...) {
+      if (loading) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loading_.erase(model_key);
+        load_promise.set_exception(std::current_exception());
+      }
+      throw;
     }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (loading) {
+    models_[model_key] = model;
+    loading_.erase(model_key);
+  }
+  model->handles++;
+  model->last_used = ++model_use_tick_;
+
+  // Waiters take their handle only after this, so the model must be registered before they wake up
+  if (loading) {
+    load_promise.set_value(model);
+  }
+
+  // A new model may push idle ones over the budget
+  evictIdleModels();
+
+  return model;
+}
+
+void SessionManager::releaseModel(const std::shared_ptr<ModelEntry> &model) {
+  model->handles--;
+  model->last_used = ++model_use_tick_;
+  evictIdleModels();
+}
+
+std::string SessionManager::createSession(const char *model_path, Ort::SessionOptions *options,
+                                          const std::string &options_key) {
+  try {
+    std::shared_ptr<ModelEntry> model = acquireModel(model_path, options, options_key);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Generate a session ID
+    std::string session_id = generateSessionId();
+
+    // Create session info
+    auto session_info = std::make_shared<SessionInfo>();
+    session_info->session = model->session;
+    session_info->input_names = model->input_names;
+    session_info->output_names = model->output_names;
+    session_info->model = model;
 
     // Store the session info
     sessions_[session_id] = std::move(session_info);
@@ -78,18 +487,283 @@ std::string SessionManager::createSession(const char *model_path, void *options)
   }
 }
 
+// Run a freshly loaded model once on zero-filled inputs, so its first real run does not pay for lazy
+// initialization. Dynamic dimensions are set to 1.
+static void warmUpModel(Ort::Session &session, const std::vector<std::string> &input_names,
+                        const std::vector<std::string> &output_names) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<Ort::Value> input_tensors;
+  for (size_t i = 0; i < input_names.size(); i++) {
+    auto type_info = session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      throw Ort::Exception("Cannot warm up a model with non-tensor input: " + input_names[i], ORT_INVALID_ARGUMENT);
+    }
+
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+    size_t element_size = SessionManager::getElementSize(element_type);
+    if (element_size == 0) {
+      throw Ort::Exception("Cannot warm up a model with non-numeric input: " + input_names[i], ORT_INVALID_ARGUMENT);
+    }
+
+    std::vector<int64_t> shape = tensor_info.GetShape();
+    size_t element_count = 1;
+    for (auto &dim : shape) {
+      if (dim < 0) {
+        dim = 1;
+      }
+      element_count *= static_cast<size_t>(dim);
+    }
+
+    Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+    if (element_count > 0) {
+      std::memset(tensor.GetTensorMutableRawData(), 0, element_count * element_size);
+    }
+    input_tensors.push_back(std::move(tensor));
+  }
+
+  std::vector<const char *> input_names_char;
+  for (const auto &name : input_names) {
+    input_names_char.push_back(name.c_str());
+  }
+  std::vector<const char *> output_names_char;
+  for (const auto &name : output_names) {
+    output_names_char.push_back(name.c_str());
+  }
+
+  session.Run(Ort::RunOptions{nullptr}, input_names_char.data(), input_tensors.data(), input_tensors.size(),
+              output_names_char.data(), output_names_char.size());
+}
+
+void SessionManager::reloadSession(const std::string &session_id, const char *model_path,
+                                   Ort::SessionOptions *options, const std::string &options_key, bool warm_up) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  // Load and warm up the new model while the old one keeps serving
+  std::shared_ptr<ModelEntry> model = acquireModel(model_path, options, options_key);
+  try {
+    if (warm_up) {
+      warmUpModel(*model->session, model->input_names, model->output_names);
+    }
+
+    std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+    // Swapping the model between two decode steps would feed the old KV cache to the new model
+    checkStateOwner(*session_info);
+
+    // State bindings carry over only if the new model still has the bound tensors
+    for (const auto &binding : session_info->state_bindings) {
+      if (model->output_index.count(binding.first) == 0 || model->input_index.count(binding.second) == 0) {
+        throw Ort::Exception("New model lacks the state binding " + binding.first + " -> " + binding.second,
+                             ORT_INVALID_ARGUMENT);
+      }
+    }
+    for (const auto &constant : session_info->constant_inputs) {
+      if (model->input_index.count(constant.first) == 0) {
+        throw Ort::Exception("New model lacks the constant input " + constant.first, ORT_INVALID_ARGUMENT);
+      }
+    }
+    // Bucketing carries over only if the new model still has the dimension and the mask input, whose axis and
+    // element type may have moved
+    std::shared_ptr<const BucketingConfig> bucketing;
+    if (session_info->bucketing) {
+      const BucketingConfig &old_config = *session_info->bucketing;
+      try {
+        bucketing = makeBucketingConfig(*model, old_config.dim, old_config.buckets, old_config.mask_input,
+                                        session_info->constant_inputs);
+      } catch (const Ort::Exception &e) {
+        throw Ort::Exception(std::string("New model does not fit the bucketing: ") + e.what(), ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end() || it->second != session_info) {
+      throw Ort::Exception("Session was closed during reload", ORT_INVALID_ARGUMENT);
+    }
+
+    // Runs in flight hold the old model and finish on it; the next run picks up the new one
+    std::shared_ptr<ModelEntry> old_model = session_info->model;
+    session_info->session = model->session;
+    session_info->input_names = model->input_names;
+    session_info->output_names = model->output_names;
+    session_info->model = model;
+    session_info->bucketing = bucketing;
+
+    // State and cached results were produced by the old model, and so were the shape variants
+    for (const auto &variant : session_info->shape_variants) {
+      releaseModel(variant.model);
+    }
+    session_info->shape_variants.clear();
+    session_info->state_tensors.clear();
+    if (session_info->result_cache) {
+      ResultCacheStats stats = session_info->result_cache->getStats();
+      session_info->result_cache = std::make_shared<ResultCache>(stats.max_entries, stats.max_bytes);
+    }
+
+    releaseModel(old_model);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseModel(model);
+    throw;
+  }
+}
+
+std::vector<std::string> SessionManager::preloadSessions(const std::vector<std::string> &model_paths,
+                                                         std::vector<Ort::SessionOptions> &options,
+                                                         const std::vector<std::string> &options_keys) {
+  if (options.size() != model_paths.size() || options_keys.size() != model_paths.size()) {
+    throw Ort::Exception("Every model needs its options", ORT_INVALID_ARGUMENT);
+  }
+
+  if (model_paths.empty()) {
+    return {};
+  }
+
+  // Loading is a one-off burst, sized apart from the runMany pool so loads are not capped at its few threads
+  WorkerPool load_pool(preloadThreadCount(model_paths.size()));
+  std::vector<std::string> session_ids(model_paths.size());
+  std::vector<std::string> errors(model_paths.size());
+  load_pool.parallelFor(model_paths.size(), [&](size_t index) {
+    try {
+      session_ids[index] = createSession(model_paths[index].c_str(), &options[index], options_keys[index]);
+    } catch (const std::exception &e) {
+      errors[index] = e.what();
+    }
+  });
+
+  for (size_t i = 0; i < model_paths.size(); i++) {
+    if (errors[i].empty()) {
+      continue;
+    }
+    // All or nothing: do not leave the other sessions open behind the caller's back
+    for (const auto &session_id : session_ids) {
+      if (!session_id.empty()) {
+        closeSession(session_id);
+      }
+    }
+    throw Ort::Exception("Failed to load " + model_paths[i] + ": " + errors[i], ORT_FAIL);
+  }
+  return session_ids;
+}
+
+void SessionManager::addShapeVariant(const std::string &session_id, const char *model_path,
+                                     Ort::SessionOptions *options, const std::string &options_key,
+                                     const std::map<std::string, int64_t> &dims) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  if (dims.empty()) {
+    throw Ort::Exception("A shape variant needs at least one fixed dimension", ORT_INVALID_ARGUMENT);
+  }
+
+  std::shared_ptr<ModelEntry> model = acquireModel(model_path, options, options_key);
+  try {
+    std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+
+    // Routing compares these names with the dimensions of the inputs, so they must name input dimensions
+    for (const auto &dim : dims) {
+      bool found = false;
+      for (const auto &dim_names : session_info->model->input_dim_names) {
+        found = found || std::find(dim_names.begin(), dim_names.end(), dim.first) != dim_names.end();
+      }
+      if (!found) {
+        throw Ort::Exception("No input has the free dimension " + dim.first, ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end() || it->second != session_info) {
+      throw Ort::Exception("Session was closed while adding a shape variant", ORT_INVALID_ARGUMENT);
+    }
+    session_info->shape_variants.push_back({dims, model});
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseModel(model);
+    throw;
+  }
+}
+
 bool SessionManager::closeSession(const std::string &session_id) {
   std::lock_guard<std::mutex> lock(mutex_);
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
+    std::shared_ptr<ModelEntry> model = it->second->model;
+    std::vector<ShapeVariant> shape_variants = it->second->shape_variants;
     sessions_.erase(it);
+
+    if (model) {
+      releaseModel(model);
+    }
+    for (const auto &variant : shape_variants) {
+      releaseModel(variant.model);
+    }
     return true;
   }
 
   return false;
 }
 
+void SessionManager::evictIdleModels() {
+  size_t total_bytes = 0;
+  for (const auto &model : models_) {
+    total_bytes += model.second->size_bytes;
+  }
+
+  while (true) {
+    auto victim = models_.end();
+    for (auto it = models_.begin(); it != models_.end(); ++it) {
+      if (it->second->handles == 0 && (victim == models_.end() || it->second->last_used < victim->second->last_used)) {
+        victim = it;
+      }
+    }
+    if (victim == models_.end() || (model_cache_budget_ > 0 && total_bytes <= model_cache_budget_)) {
+      return;
+    }
+
+    // Runs in flight keep their own reference, so the session is freed once they finish
+    total_bytes -= victim->second->size_bytes;
+    models_.erase(victim);
+  }
+}
+
+void SessionManager::setModelCacheBudget(size_t budget_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  model_cache_budget_ = budget_bytes;
+  evictIdleModels();
+}
+
+ModelCacheStats SessionManager::getModelCacheStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  ModelCacheStats stats;
+  stats.models = models_.size();
+  for (const auto &model : models_) {
+    stats.bytes += model.second->size_bytes;
+    if (model.second->handles == 0) {
+      stats.idle_models++;
+    }
+  }
+  stats.budget_bytes = model_cache_budget_;
+  stats.shared_loads = shared_loads_;
+  return stats;
+}
+
+std::shared_ptr<SessionInfo> SessionManager::getSessionInfo(const std::string &session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = sessions_.find(session_id);
+  if (it == sessions_.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
 bool SessionManager::hasSession(const std::string &session_id) {
   std::lock_guard<std::mutex> lock(mutex_);
   return sessions_.find(session_id) != sessions_.end();
@@ -100,7 +774,7 @@ std::vector<std::string> SessionManager::getInputNames(const std::string &sessio
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
-    return it->second.input_names;
+    return it->second->input_names;
   }
 
   return {};
@@ -111,7 +785,7 @@ std::vector<std::string> SessionManager::getOutputNames(const std::string &sessi
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
-    return it->second.output_names;
+    return it->second->output_names;
   }
 
   return {};
@@ -159,184 +833,575 @@ const char *SessionManager::getElementTypeString(ONNXTensorElementDataType eleme
   }
 }
 
+// Get element size helper
+size_t SessionManager::getElementSize(ONNXTensorElementDataType element_type) {
+  switch (element_type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    return 1;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+    return 2;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    return 4;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64:
+    return 8;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
 // Get model metadata
 ModelMetadata SessionManager::getModelMetadata(const std::string &session_id) {
   std::lock_guard<std::mutex> lock(mutex_);
-  ModelMetadata metadata{};
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
-    try {
-      Ort::Session *session = it->second.session.get();
-      if (session) {
-        // Get model metadata
-        Ort::ModelMetadata model_metadata = session->GetModelMetadata();
-        Ort::AllocatorWithDefaultOptions allocator;
-
-        // Extract metadata details
-        auto producer_name = model_metadata.GetProducerNameAllocated(allocator);
-        auto graph_name = model_metadata.GetGraphNameAllocated(allocator);
-        auto domain = model_metadata.GetDomainAllocated(allocator);
-        auto description = model_metadata.GetDescriptionAllocated(allocator);
-
-        metadata.producer_name = producer_name.get();
-        metadata.graph_name = graph_name.get();
-        metadata.domain = domain.get();
-        metadata.description = description.get();
-        metadata.version = model_metadata.GetVersion();
-
-        // Add custom metadata if needed
-        // Currently returning an empty map as in the original implementation
-      }
-    } catch (const Ort::Exception &e) {
-      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
-    } catch (const std::exception &e) {
-      std::cerr << "Error: " << e.what() << std::endl;
-    }
+    return it->second->model->metadata;
   }
 
-  return metadata;
+  return ModelMetadata{};
 }
 
 // Get input info
 std::vector<TensorInfo> SessionManager::getInputInfo(const std::string &session_id) {
   std::lock_guard<std::mutex> lock(mutex_);
-  std::vector<TensorInfo> info_list;
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
-    try {
-      Ort::Session *session = it->second.session.get();
-      if (session) {
-        size_t num_inputs = session->GetInputCount();
-        Ort::AllocatorWithDefaultOptions allocator;
-
-        for (size_t i = 0; i < num_inputs; i++) {
-          TensorInfo info{};
-
-          // Get input name
-          auto input_name = session->GetInputNameAllocated(i, allocator);
-          info.name = input_name.get();
-
-          // Get type and shape
-          auto type_info = session->GetInputTypeInfo(i);
-          ONNXType onnx_type = type_info.GetONNXType();
-
-          if (onnx_type == ONNX_TYPE_TENSOR) {
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            info.shape = tensor_info.GetShape();
-
-            // Get element type
-            ONNXTensorElementDataType element_type = tensor_info.GetElementType();
-            info.type = getElementTypeString(element_type);
-          } else {
-            // Non-tensor type
-            info.type = "non-tensor";
-          }
-
-          info_list.push_back(info);
-        }
-      }
-    } catch (const Ort::Exception &e) {
-      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
-    } catch (const std::exception &e) {
-      std::cerr << "Error: " << e.what() << std::endl;
-    }
+    return it->second->model->input_info;
   }
 
-  return info_list;
+  return {};
 }
 
 // Get output info
 std::vector<TensorInfo> SessionManager::getOutputInfo(const std::string &session_id) {
   std::lock_guard<std::mutex> lock(mutex_);
-  std::vector<TensorInfo> info_list;
 
   auto it = sessions_.find(session_id);
   if (it != sessions_.end()) {
-    try {
-      Ort::Session *session = it->second.session.get();
-      if (session) {
-        size_t num_outputs = session->GetOutputCount();
-        Ort::AllocatorWithDefaultOptions allocator;
-
-        for (size_t i = 0; i < num_outputs; i++) {
-          TensorInfo info{};
-
-          // Get output name
-          auto output_name = session->GetOutputNameAllocated(i, allocator);
-          info.name = output_name.get();
-
-          // Get type and shape
-          auto type_info = session->GetOutputTypeInfo(i);
-          ONNXType onnx_type = type_info.GetONNXType();
-
-          if (onnx_type == ONNX_TYPE_TENSOR) {
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            info.shape = tensor_info.GetShape();
-
-            // Get element type
-            ONNXTensorElementDataType element_type = tensor_info.GetElementType();
-            info.type = getElementTypeString(element_type);
-          } else {
-            // Non-tensor type
-            info.type = "non-tensor";
-          }
-
-          info_list.push_back(info);
-        }
-      }
-    } catch (const Ort::Exception &e) {
-      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
-    } catch (const std::exception &e) {
-      std::cerr << "Error: " << e.what() << std::endl;
-    }
+    return it->second->model->output_info;
   }
 
-  return info_list;
+  return {};
 }
 
 // Run inference
-std::vector<Ort::Value> SessionManager::runInference(const std::string &session_id,
-                                                     const std::vector<Ort::Value> &input_tensors,
-                                                     Ort::RunOptions *run_options) {
+NamedTensors SessionManager::runInference(const std::string &session_id, const std::vector<std::string> &input_names,
+                                          std::vector<Ort::Value> &&input_tensors, Ort::RunOptions *run_options,
+                                          const std::vector<std::string> &output_names,
+                                          const std::vector<std::string> &adapter_ids) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  std::vector<Ort::Value> output_tensors;
+  // A stateful step reads and replaces the state, so it keeps the lock until the state is stored again
+  std::unique_lock<std::mutex> state_lock(session_info->state_mutex);
+  checkStateOwner(*session_info);
 
-  auto it = sessions_.find(session_id);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  if (input_names.size() != input_tensors.size()) {
+    throw Ort::Exception("Input names and input tensors must have the same length", ORT_INVALID_ARGUMENT);
   }
 
-  Ort::Session *session = it->second.session.get();
+  // A reload may swap the model once the lock is released; this run stays on the one it started with
+  std::shared_ptr<ModelEntry> base_model = session_info->model;
+  bool stateful = !session_info->state_bindings.empty();
+  bool cast_inputs = session_info->cast_inputs;
+
+  // Bucketing pads the inputs and may add the mask input, so it works on a copy of the names
+  std::shared_ptr<const BucketingConfig> bucketing = stateful ? nullptr : session_info->bucketing;
+  std::vector<std::string> bucketed_names;
+  int64_t unpadded_size = -1;
+  if (bucketing) {
+    bucketed_names = input_names;
+    unpadded_size = applyBucketing(*bucketing, *base_model, bucketed_names, input_tensors);
+  }
+  const std::vector<std::string> &names = unpadded_size >= 0 ? bucketed_names : input_names;
+
+  // Stateful runs stay on the session's own model, so the carried state always fits it
+  std::shared_ptr<ModelEntry> model = base_model;
+  if (!session_info->shape_variants.empty() && !stateful) {
+    model = selectShapeVariant(*session_info, names, input_tensors);
+  }
+  Ort::Session *session = model->session.get();
   if (!session) {
     throw Ort::Exception("Session is invalid", ORT_INVALID_ARGUMENT);
   }
 
-  if (input_tensors.empty()) {
+  // Bind the caller's inputs by name into model order, so any subset in any order is accepted
+  std::vector<Ort::Value> feeds;
+  feeds.reserve(model->input_names.size());
+  for (size_t i = 0; i < model->input_names.size(); i++) {
+    feeds.emplace_back(nullptr);
+  }
+  BorrowedFeeds borrowed_feeds{feeds, std::vector<bool>(model->input_names.size(), false)};
+  for (size_t i = 0; i < names.size(); i++) {
+    auto index = model->input_index.find(names[i]);
+    if (index == model->input_index.end()) {
+      throw Ort::Exception("Unknown input: " + names[i], ORT_INVALID_ARGUMENT);
+    }
+    if (feeds[index->second]) {
+      throw Ort::Exception("Duplicate input: " + names[i], ORT_INVALID_ARGUMENT);
+    }
+    feeds[index->second] = std::move(input_tensors[i]);
+    if (cast_inputs) {
+      castToInputType(*model, index->second, feeds[index->second]);
+    }
+  }
+
+  // Prepare output names. A stateful run always fetches its bound outputs so the state carries over.
+  // Fetching everything uses the model's own arrays.
+  const std::vector<std::string> *fetch_names = &model->output_names;
+  const char *const *fetch_name_ptrs = model->output_name_ptrs.data();
+  std::vector<std::string> selected_names;
+  std::vector<const char *> selected_name_ptrs;
+  if (!output_names.empty()) {
+    std::vector<bool> requested(model->output_names.size(), false);
+    for (const auto &name : output_names) {
+      auto index = model->output_index.find(name);
+      if (index == model->output_index.end()) {
+        throw Ort::Exception("Unknown output: " + name, ORT_INVALID_ARGUMENT);
+      }
+      requested[index->second] = true;
+    }
+    for (size_t i = 0; i < model->output_names.size(); i++) {
+      if (requested[i] || session_info->state_bindings.count(model->output_names[i]) > 0) {
+        selected_names.push_back(model->output_names[i]);
+        selected_name_ptrs.push_back(model->output_name_ptrs[i]);
+      }
+    }
+    fetch_names = &selected_names;
+    fetch_name_ptrs = selected_name_ptrs.data();
+  }
+
+  // Feed the carried-over state into every bound input the caller did not supply explicitly.
+  // The state tensors are moved, not copied, and are consumed by this run.
+  std::vector<size_t> state_slots;
+  for (auto &state : session_info->state_tensors) {
+    auto index = model->input_index.find(state.first);
+    if (index == model->input_index.end() || feeds[index->second]) {
+      continue;
+    }
+    state_slots.push_back(index->second);
+    feeds[index->second] = std::move(state.second);
+  }
+
+  // Constant inputs fill the inputs still empty. The feed borrows the session's tensor rather than
+  // copying it, and holds a reference so it outlives the run even if it is replaced meanwhile.
+  std::vector<std::shared_ptr<Ort::Value>> constants;
+  for (const auto &constant : session_info->constant_inputs) {
+    auto index = model->input_index.find(constant.first);
+    if (index == model->input_index.end() || feeds[index->second]) {
+      continue;
+    }
+    constants.push_back(constant.second);
+    feeds[index->second] = Ort::Value(static_cast<OrtValue *>(*constant.second));
+    borrowed_feeds.borrowed[index->second] = true;
+  }
+
+  // Drop the inputs nobody supplied (e.g. optional ones); a full feed uses the model's arrays as they are
+  const char *const *feed_name_ptrs = model->input_name_ptrs.data();
+  std::vector<const char *> partial_name_ptrs;
+  size_t num_feeds = 0;
+  for (size_t i = 0; i < feeds.size(); i++) {
+    if (!feeds[i]) {
+      continue;
+    }
+    partial_name_ptrs.push_back(model->input_name_ptrs[i]);
+    if (i != num_feeds) {
+      feeds[num_feeds] = std::move(feeds[i]);
+      borrowed_feeds.borrowed[num_feeds] = borrowed_feeds.borrowed[i];
+      borrowed_feeds.borrowed[i] = false;
+    }
+    num_feeds++;
+  }
+  if (num_feeds == 0) {
     throw Ort::Exception("No input tensors provided", ORT_INVALID_ARGUMENT);
   }
+  if (num_feeds < model->input_names.size()) {
+    feeds.erase(feeds.begin() + num_feeds, feeds.end());
+    feed_name_ptrs = partial_name_ptrs.data();
+  }
 
-  // Prepare input names
-  std::vector<const char *> input_names_char;
-  for (const auto &name : it->second.input_names) {
-    input_names_char.push_back(name.c_str());
+  std::shared_ptr<ResultCache> result_cache = stateful ? nullptr : session_info->result_cache;
+  if (!stateful) {
+    state_lock.unlock();
   }
 
-  // Prepare output names
-  std::vector<const char *> output_names_char;
-  for (const auto &name : it->second.output_names) {
-    output_names_char.push_back(name.c_str());
+  // Identical inputs return the stored outputs without running the model. Inputs are keyed in model
+  // order, so the order the caller listed them in does not matter.
+  std::string cache_key;
+  if (result_cache) {
+    std::vector<std::string> feed_names(feed_name_ptrs, feed_name_ptrs + num_feeds);
+    if (!ResultCache::makeKey(feed_names, feeds, cache_key)) {
+      result_cache.reset();
+    }
+  }
+  if (result_cache && !output_names.empty()) {
+    ResultCache::appendOutputNames(cache_key, *fetch_names);
+  }
+  if (result_cache && !adapter_ids.empty()) {
+    ResultCache::appendAdapterIds(cache_key, adapter_ids);
+  }
+  if (result_cache) {
+    NamedTensors cached_outputs;
+    if (result_cache->lookup(cache_key, cached_outputs)) {
+      if (unpadded_size >= 0) {
+        cropBucketedOutputs(*bucketing, *base_model, cached_outputs, unpadded_size);
+      }
+      return cached_outputs;
+    }
   }
 
   // Create default run options if none provided
   Ort::RunOptions default_run_options;
   Ort::RunOptions *run_opts = run_options ? run_options : &default_run_options;
 
-  // Run inference - let exceptions propagate out
-  output_tensors = session->Run(*run_opts, input_names_char.data(), input_tensors.data(), input_tensors.size(),
-                                output_names_char.data(), output_names_char.size());
+  std::vector<Ort::Value> output_tensors;
+  try {
+    output_tensors =
+        session->Run(*run_opts, feed_name_ptrs, feeds.data(), feeds.size(), fetch_name_ptrs, fetch_names->size());
+  } catch (...) {
+    // Hand the state back so a failed step can be retried (only a stateful run has taken any)
+    for (size_t slot : state_slots) {
+      for (size_t i = 0; i < feeds.size(); i++) {
+        if (feed_name_ptrs[i] == model->input_name_ptrs[slot]) {
+          session_info->state_tensors.insert_or_assign(model->input_names[slot], std::move(feeds[i]));
+        }
+      }
+    }
+    throw;
+  }
+
+  if (!stateful) {
+    NamedTensors outputs;
+    for (size_t i = 0; i < output_tensors.size(); i++) {
+      outputs.emplace_back((*fetch_names)[i], std::move(output_tensors[i]));
+    }
+    if (result_cache) {
+      result_cache->insert(std::move(cache_key), outputs);
+    }
+    if (unpadded_size >= 0) {
+      cropBucketedOutputs(*bucketing, *base_model, outputs, unpadded_size);
+    }
+    return outputs;
+  }
+
+  // The consumed state is replaced by this run's bound outputs; everything else goes back to the caller
+  session_info->state_tensors.clear();
+  NamedTensors outputs;
+  for (size_t i = 0; i < output_tensors.size(); i++) {
+    const std::string &output_name = (*fetch_names)[i];
+    auto binding = session_info->state_bindings.find(output_name);
+    if (binding != session_info->state_bindings.end()) {
+      session_info->state_tensors.emplace(binding->second, std::move(output_tensors[i]));
+    } else {
+      outputs.emplace_back(output_name, std::move(output_tensors[i]));
+    }
+  }
+
+  return outputs;
+}
+
+std::vector<NamedTensors> SessionManager::runMany(const std::vector<std::string> &session_ids,
+                                                 const NamedTensors &inputs, Ort::RunOptions *run_options,
+                                                 const std::vector<std::string> &adapter_ids) {
+  // Resolve every session up front so a bad ID fails before anything runs
+  std::vector<std::vector<std::string>> session_inputs;
+  for (const auto &session_id : session_ids) {
+    if (!hasSession(session_id)) {
+      throw Ort::Exception("Session not found: " + session_id, ORT_INVALID_ARGUMENT);
+    }
+    session_inputs.push_back(getInputNames(session_id));
+  }
+
+  std::vector<NamedTensors> results(session_ids.size());
+  std::vector<std::string> errors(session_ids.size());
+  worker_pool_.parallelFor(session_ids.size(), [&](size_t index) {
+    try {
+      // Each run gets views of the inputs its model declares, so no tensor data is copied
+      std::vector<std::string> input_names;
+      std::vector<Ort::Value> input_tensors;
+      for (const auto &input : inputs) {
+        const auto &declared = session_inputs[index];
+        if (std::find(declared.begin(), declared.end(), input.first) != declared.end()) {
+          input_names.push_back(input.first);
+          input_tensors.push_back(viewValue(input.second));
+        }
+      }
+      results[index] =
+          runInference(session_ids[index], input_names, std::move(input_tensors), run_options, {}, adapter_ids);
+    } catch (const std::exception &e) {
+      errors[index] = e.what();
+    }
+  });
 
-  return output_tensors;
-}
\ No newline at end of file
+  for (size_t i = 0; i < session_ids.size(); i++) {
+    if (!errors[i].empty()) {
+      throw Ort::Exception("Session " + session_ids[i] + ": " + errors[i], ORT_FAIL);
+    }
+  }
+  return results;
+}
+
+void SessionManager::configureResultCache(const std::string &session_id, size_t max_entries, size_t max_bytes) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  session_info->result_cache = max_entries > 0 ? std::make_shared<ResultCache>(max_entries, max_bytes) : nullptr;
+}
+
+ResultCacheStats SessionManager::getResultCacheStats(const std::string &session_id) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  std::shared_ptr<ResultCache> result_cache;
+  {
+    std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+    result_cache = session_info->result_cache;
+  }
+  return result_cache ? result_cache->getStats() : ResultCacheStats();
+}
+
+std::map<std::string, SessionMemoryStats> SessionManager::getMemoryStats() {
+  std::map<std::string, std::shared_ptr<SessionInfo>> sessions;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions = sessions_;
+  }
+
+  std::map<std::string, SessionMemoryStats> all_stats;
+  for (const auto &entry : sessions) {
+    SessionInfo &session_info = *entry.second;
+    SessionMemoryStats &stats = all_stats[entry.first];
+
+    std::shared_ptr<ModelEntry> model;
+    {
+      std::lock_guard<std::mutex> state_lock(session_info.state_mutex);
+      model = session_info.model;
+      for (const auto &state : session_info.state_tensors) {
+        stats.state_bytes += tensorByteSize(state.second);
+      }
+      if (session_info.result_cache) {
+        stats.result_cache_bytes = session_info.result_cache->getStats().bytes;
+      }
+    }
+    stats.model_bytes = model->size_bytes;
+
+#if ORT_API_VERSION >= 23
+    try {
+      Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+      Ort::Allocator allocator(*model->session, memory_info);
+      OrtKeyValuePairs *pairs = nullptr;
+      Ort::ThrowOnError(Ort::GetApi().AllocatorGetStats(allocator, &pairs));
+
+      const char *const *keys = nullptr;
+      const char *const *values = nullptr;
+      size_t count = 0;
+      Ort::GetApi().GetKeyValuePairs(pairs, &keys, &values, &count);
+      for (size_t i = 0; i < count; i++) {
+        stats.allocator_stats[keys[i]] = std::strtoll(values[i], nullptr, 10);
+      }
+      Ort::GetApi().ReleaseKeyValuePairs(pairs);
+      stats.allocator_stats_available = true;
+    } catch (const Ort::Exception &e) {
+      // Sessions without an arena have no counters
+    }
+#endif
+  }
+  return all_stats;
+}
+
+void SessionManager::setStateBindings(const std::string &session_id,
+                                      const std::map<std::string, std::string> &output_to_input) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  checkStateOwner(*session_info);
+
+  const auto &inputs = session_info->input_names;
+  const auto &outputs = session_info->output_names;
+  for (const auto &binding : output_to_input) {
+    if (std::find(outputs.begin(), outputs.end(), binding.first) == outputs.end()) {
+      throw Ort::Exception("Unknown output name in state binding: " + binding.first, ORT_INVALID_ARGUMENT);
+    }
+    if (std::find(inputs.begin(), inputs.end(), binding.second) == inputs.end()) {
+      throw Ort::Exception("Unknown input name in state binding: " + binding.second, ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  session_info->state_bindings = output_to_input;
+  session_info->state_tensors.clear();
+}
+
+void SessionManager::resetState(const std::string &session_id) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  checkStateOwner(*session_info);
+  session_info->state_tensors.clear();
+}
+
+SavedState SessionManager::claimState(const std::string &session_id) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  if (session_info->state_owner != std::thread::id()) {
+    throw Ort::Exception("Session is busy generating", ORT_FAIL);
+  }
+
+  session_info->state_owner = std::this_thread::get_id();
+  SavedState saved;
+  saved.bindings = session_info->state_bindings;
+  saved.tensors = std::move(session_info->state_tensors);
+  session_info->state_tensors.clear();
+  return saved;
+}
+
+void SessionManager::restoreState(const std::string &session_id, SavedState &&saved) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    return;
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  session_info->state_bindings = std::move(saved.bindings);
+  session_info->state_tensors = std::move(saved.tensors);
+  session_info->state_owner = std::thread::id();
+}
+
+std::map<std::string, std::string> SessionManager::getStateBindings(const std::string &session_id) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    return {};
+  }
+
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  return session_info->state_bindings;
+}
+
+void SessionManager::configureBucketing(const std::string &session_id, const std::string &dim,
+                                        std::vector<int64_t> buckets, const std::string &mask_input) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+
+  if (buckets.empty()) {
+    session_info->bucketing = nullptr;
+    return;
+  }
+
+  session_info->bucketing = makeBucketingConfig(*session_info->model, dim, std::move(buckets), mask_input,
+                                                session_info->constant_inputs);
+}
+
+void SessionManager::setInputCasting(const std::string &session_id, bool enabled) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  session_info->cast_inputs = enabled;
+}
+
+void SessionManager::setConstantInput(const std::string &session_id, const std::string &input_name,
+                                      Ort::Value &&value) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+
+  if (!value) {
+    session_info->constant_inputs.erase(input_name);
+    return;
+  }
+
+  // Checked once here, so runs can feed the tensor without looking at it again
+  auto index = session_info->model->input_index.find(input_name);
+  if (index == session_info->model->input_index.end()) {
+    throw Ort::Exception("Unknown input: " + input_name, ORT_INVALID_ARGUMENT);
+  }
+  auto type_info = session_info->model->session->GetInputTypeInfo(index->second);
+  if (type_info.GetONNXType() == ONNX_TYPE_TENSOR &&
+      type_info.GetTensorTypeAndShapeInfo().GetElementType() != value.GetTensorTypeAndShapeInfo().GetElementType()) {
+    throw Ort::Exception("Constant input has the wrong element type: " + input_name, ORT_INVALID_ARGUMENT);
+  }
+  if (session_info->bucketing && inputHasDim(*session_info->model, input_name, session_info->bucketing->dim)) {
+    throw Ort::Exception("Constant input " + input_name + " has the bucketed dimension " +
+                             session_info->bucketing->dim,
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  // Runs hash the constants with the other inputs, so cached results of the old value stay apart
+  session_info->constant_inputs[input_name] = std::make_shared<Ort::Value>(std::move(value));
+}
+
+void SessionManager::initEmptyState(const std::string &session_id) {
+  std::shared_ptr<SessionInfo> session_info = getSessionInfo(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> state_lock(session_info->state_mutex);
+  checkStateOwner(*session_info);
+
+  Ort::Session *session = session_info->session.get();
+  session_info->state_tensors.clear();
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (const auto &binding : session_info->state_bindings) {
+    const std::string &input_name = binding.second;
+    size_t index = std::find(session_info->input_names.begin(), session_info->input_names.end(), input_name) -
+                   session_info->input_names.begin();
+
+    auto type_info = session->GetInputTypeInfo(index);
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+    size_t element_size = getElementSize(element_type);
+    if (element_size == 0) {
+      throw Ort::Exception("Unsupported state tensor type for input: " + input_name, ORT_INVALID_ARGUMENT);
+    }
+
+    std::vector<int64_t> shape = tensor_info.GetShape();
+    bool seen_dynamic = false;
+    size_t element_count = 1;
+    for (auto &dim : shape) {
+      if (dim < 0) {
+        dim = seen_dynamic ? 0 : 1;
+        seen_dynamic = true;
+      }
+      element_count *= static_cast<size_t>(dim);
+    }
+
+    Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+    if (element_count > 0) {
+      std::memset(tensor.GetTensorMutableRawData(), 0, element_count * element_size);
+    }
+    session_info->state_tensors.emplace(input_name, std::move(tensor));
+  }
+}
@@ -7,22 +7,22 @@
 #ifndef SESSION_MANAGER_H
 #define SESSION_MANAGER_H
 
+#include "worker_pool.h"
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <onnxruntime_cxx_api.h>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // Forward declaration
 class TensorManager;
-
-// Session information structure
-struct SessionInfo {
-  std::unique_ptr<Ort::Session> session;
-  std::vector<std::string> input_names;
-  std::vector<std::string> output_names;
-};
+class ResultCache;
+struct ResultCacheStats;
 
 // Model metadata structure
 struct ModelMetadata {
@@ -41,18 +41,183 @@ struct TensorInfo {
   std::vector<int64_t> shape;
 };
 
+// A loaded model, shared by every session handle created with the same model file and options
+struct ModelEntry {
+  // Canonical model identity and options, empty if the model cannot be shared
+  std::string key;
+  std::shared_ptr<Ort::Session> session;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  // Built once at load and never changed: c_str() of every name in model order, as Run() takes them,
+  // and the position of every name, so runs bind inputs and outputs by name without string work
+  std::vector<const char *> input_name_ptrs;
+  std::vector<const char *> output_name_ptrs;
+  std::unordered_map<std::string, size_t> input_index;
+  std::unordered_map<std::string, size_t> output_index;
+  // Introspection read once at load; queries return these instead of walking the model again
+  std::vector<TensorInfo> input_info;
+  std::vector<TensorInfo> output_info;
+  ModelMetadata metadata{};
+  // Element type of every input, ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED for non-tensor inputs
+  std::vector<ONNXTensorElementDataType> input_types;
+  // Symbolic name of every dimension of every input and output (e.g. "batch"), empty where it has none
+  std::vector<std::vector<std::string>> input_dim_names;
+  std::vector<std::vector<std::string>> output_dim_names;
+  // Estimated memory held by the session (the model file size)
+  size_t size_bytes = 0;
+  // Open handles; the model is idle at zero and may be evicted
+  size_t handles = 0;
+  // Tick of the last open or close, for LRU eviction of idle models
+  uint64_t last_used = 0;
+};
+
+// Counters of the model cache
+struct ModelCacheStats {
+  size_t models = 0;
+  size_t idle_models = 0;
+  size_t bytes = 0;
+  size_t budget_bytes = 0;
+  // createSession calls served by an already loaded model
+  uint64_t shared_loads = 0;
+};
+
+// Memory held on behalf of one session
+struct SessionMemoryStats {
+  // Estimated size of the loaded model (shared by sessions using the same model)
+  size_t model_bytes = 0;
+  // State tensors carried between runs
+  size_t state_bytes = 0;
+  // Outputs held by the result cache
+  size_t result_cache_bytes = 0;
+  // Counters of the session's CPU arena as reported by ONNX Runtime (e.g. "InUse", "MaxInUse",
+  // "NumAllocs"). Only valid when allocator_stats_available is set.
+  std::map<std::string, int64_t> allocator_stats;
+  // False when the counters are unknown: the plugin was built against ONNX Runtime older than 1.23 (the
+  // version pinned by default has no allocator statistics API) or the session has no CPU arena
+  bool allocator_stats_available = false;
+};
+
+// The same model loaded once more with some free dimensions fixed, e.g. {"seq_len": 128}
+struct ShapeVariant {
+  std::map<std::string, int64_t> dims;
+  std::shared_ptr<ModelEntry> model;
+};
+
+// Padding of one variable dimension to a few fixed sizes, so ONNX Runtime sees few distinct shapes
+struct BucketingConfig {
+  // Symbolic name of the padded dimension, e.g. "seq_len"
+  std::string dim;
+  // Sizes to pad to, ascending; longer inputs run unpadded
+  std::vector<int64_t> buckets;
+  // Input filled with 1 for real and 0 for padded positions unless the caller passes it; empty for none
+  std::string mask_input;
+  ONNXTensorElementDataType mask_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  size_t mask_axis = 0;
+};
+
+// Session information structure: one handle returned by createSession
+struct SessionInfo {
+  std::shared_ptr<Ort::Session> session;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+
+  // The model this handle uses; reloadSession swaps it (and the fields above) under both locks
+  std::shared_ptr<ModelEntry> model;
+
+  // Shape-specialized variants of the model. A run whose inputs match all fixed dimensions of a
+  // variant goes to the first such variant. Changed under both locks.
+  std::vector<ShapeVariant> shape_variants;
+
+  // Stateful mode: maps an output name to the input it feeds on the next run
+  std::map<std::string, std::string> state_bindings;
+
+  // State tensors carried between runs, keyed by the input name they feed
+  std::map<std::string, Ort::Value> state_tensors;
+
+  // Tensors fed into every run that leaves their input out, keyed by input name. Shared so a run
+  // keeps the ones it uses alive if they are replaced meanwhile.
+  std::map<std::string, std::shared_ptr<Ort::Value>> constant_inputs;
+
+  // Opt-in cache of outputs keyed by input content, nullptr when off. Stateful runs bypass it.
+  std::shared_ptr<ResultCache> result_cache;
+
+  // Opt-in bucketing of a variable dimension, nullptr when off. Stateful runs bypass it.
+  std::shared_ptr<const BucketingConfig> bucketing;
+
+  // Opt-in conversion of numeric inputs to the element type the model declares for them
+  bool cast_inputs = false;
+
+  // Thread that claimed the state with claimState, e.g. for a generation; default-constructed when unclaimed.
+  // While claimed, runs and state changes from any other thread fail as busy.
+  std::thread::id state_owner;
+
+  // Guards the state, the constant inputs, the result cache, the bucketing, input casting and the owner above.
+  // Runs of a stateful session hold it for the whole step; stateless runs only take it briefly, so they can
+  // overlap on one session.
+  std::mutex state_mutex;
+};
+
+// Output tensors of a run paired with their output names, in model output order
+using NamedTensors = std::vector<std::pair<std::string, Ort::Value>>;
+
+// Pad every input along the bucketed dimension to the next bucket size and add the mask input if the
+// caller left it out. Returns the unpadded size of the dimension, or -1 if the run is left as it is.
+int64_t applyBucketing(const BucketingConfig &config, const ModelEntry &model, std::vector<std::string> &names,
+                       std::vector<Ort::Value> &tensors);
+
+// Crop the outputs having the bucketed dimension back to its unpadded size
+void cropBucketedOutputs(const BucketingConfig &config, const ModelEntry &model, NamedTensors &outputs,
+                         int64_t length);
+
+// State bindings and tensors of a session set aside by claimState
+struct SavedState {
+  std::map<std::string, std::string> bindings;
+  std::map<std::string, Ort::Value> tensors;
+};
+
 // Session Manager Class
 class SessionManager {
 public:
   SessionManager();
   ~SessionManager();
 
-  // Create a new session from a model file path
-  std::string createSession(const char *model_path, void *options);
+  // Create a new session from a model file path. A model already loaded from the same file with the same
+  // `options_key` (a canonical form of the options) is shared instead of being loaded again; each call still
+  // returns its own session ID with its own state. `options` may be consumed.
+  std::string createSession(const char *model_path, Ort::SessionOptions *options, const std::string &options_key = "");
+
+  // Create sessions for several models in parallel, e.g. at startup, so loading costs about as much as the
+  // slowest model when there are at least as many hardware threads as models; beyond that, models wait for a
+  // free thread. Returns the session IDs in order. If any model fails to load, the others are closed and
+  // the error is thrown. `options` are consumed.
+  std::vector<std::string> preloadSessions(const std::vector<std::string> &model_paths,
+                                           std::vector<Ort::SessionOptions> &options,
+                                           const std::vector<std::string> &options_keys);
+
+  // Swap the model behind a session while it keeps serving. The new model is loaded (and, with `warm_up`, run
+  // once on zero-filled inputs) before the swap; runs already in flight finish on the old model, which is
+  // released after the last of them. Held state and cached results are dropped. On failure the session keeps
+  // its old model. `options` may be consumed.
+  void reloadSession(const std::string &session_id, const char *model_path, Ort::SessionOptions *options,
+                     const std::string &options_key, bool warm_up);
+
+  // Load the session's model again with the free dimensions in `dims` fixed (by symbolic name), so ONNX
+  // Runtime can optimize and plan memory for those static shapes. Stateless runs whose inputs have
+  // exactly these dimensions are routed to the variant. `options` are the session's options and may be
+  // consumed. Variants are dropped by reloadSession.
+  void addShapeVariant(const std::string &session_id, const char *model_path, Ort::SessionOptions *options,
+                       const std::string &options_key, const std::map<std::string, int64_t> &dims);
 
-  // Close and remove a session
+  // Close and remove a session. The model is released once no session uses it and the cache budget is exceeded.
   bool closeSession(const std::string &session_id);
 
+  // Keep idle models loaded while all cached models together stay within `budget_bytes`, evicting the least
+  // recently used idle model first. 0 (the default) releases a model as soon as its last session closes.
+  void setModelCacheBudget(size_t budget_bytes);
+
+  // Get the model cache counters
+  ModelCacheStats getModelCacheStats();
+
   // Get session info
   bool hasSession(const std::string &session_id);
 
@@ -71,19 +236,110 @@ public:
   // Get output tensor info for a session
   std::vector<TensorInfo> getOutputInfo(const std::string &session_id);
 
-  // Run inference with a session
-  std::vector<Ort::Value> runInference(const std::string &session_id, const std::vector<Ort::Value> &input_tensors,
-                                       Ort::RunOptions *run_options = nullptr);
+  // Run inference with a session, binding each input tensor to the input name at the same index.
+  // In stateful mode the carried-over state fills any bound input not given by the caller, and bound
+  // outputs are kept as the next state instead of being returned.
+  // Only `output_names` are fetched, all outputs when empty; ORT then skips nodes no fetched output needs.
+  // `adapter_ids` names the LoRA adapters active in `run_options`, so cached results of other adapters stay apart.
+  NamedTensors runInference(const std::string &session_id, const std::vector<std::string> &input_names,
+                            std::vector<Ort::Value> &&input_tensors, Ort::RunOptions *run_options = nullptr,
+                            const std::vector<std::string> &output_names = {},
+                            const std::vector<std::string> &adapter_ids = {});
+
+  // Run several sessions on the same inputs concurrently and return their outputs in session order.
+  // Every session receives the inputs it declares; the tensors are shared read-only, not copied.
+  // Throws if any run fails, naming the session, after all runs have finished.
+  std::vector<NamedTensors> runMany(const std::vector<std::string> &session_ids, const NamedTensors &inputs,
+                                    Ort::RunOptions *run_options = nullptr,
+                                    const std::vector<std::string> &adapter_ids = {});
+
+  // Cache outputs of this session by input content, holding at most `max_entries` results and
+  // `max_bytes` of output data (0 = no byte limit). Zero entries turns the cache off. Any cached
+  // results and counters are dropped.
+  void configureResultCache(const std::string &session_id, size_t max_entries, size_t max_bytes);
+
+  // Pad the inputs of every stateless run along the free dimension `dim` to the smallest of `buckets`
+  // that fits, run, and crop the outputs having that dimension back. `mask_input`, if not empty, is
+  // filled with the matching mask unless the caller passes it. Empty `buckets` turns bucketing off.
+  void configureBucketing(const std::string &session_id, const std::string &dim, std::vector<int64_t> buckets,
+                          const std::string &mask_input);
+
+  // Convert numeric inputs whose element type differs from the one the model declares (e.g. float32 data
+  // for a float16 input) as part of every run, instead of requiring a converted copy from the caller.
+  // The converted tensors are transient and live in per-thread buffers reused by later runs.
+  void setInputCasting(const std::string &session_id, bool enabled);
+
+  // Get the result cache counters of a session; all zero when the cache is off
+  ResultCacheStats getResultCacheStats(const std::string &session_id);
+
+  // Get the memory held by every open session, keyed by session ID
+  std::map<std::string, SessionMemoryStats> getMemoryStats();
+
+  // Declare which outputs are fed back as inputs on the next run (output name -> input name).
+  // Passing an empty map turns stateful mode off. Any held state is dropped.
+  void setStateBindings(const std::string &session_id, const std::map<std::string, std::string> &output_to_input);
+
+  // Drop the state tensors held for a session while keeping its bindings
+  void resetState(const std::string &session_id);
+
+  // Get the state bindings of a session (output name -> input name)
+  std::map<std::string, std::string> getStateBindings(const std::string &session_id);
+
+  // Supply `value` for the input `input_name` on every run of a session that does not pass it
+  // explicitly. The tensor is fed as is, never copied. A null value removes the constant input.
+  void setConstantInput(const std::string &session_id, const std::string &input_name, Ort::Value &&value);
+
+  // Claim the state of a session for the calling thread and set the held state tensors aside; the bindings stay
+  // in place. Until restoreState, runs and state changes from other threads fail with "Session is busy".
+  // Throws the same if another thread holds the claim.
+  SavedState claimState(const std::string &session_id);
+
+  // Put back state set aside by claimState and release the claim. Does nothing if the session was closed.
+  void restoreState(const std::string &session_id, SavedState &&saved);
+
+  // Reset the state to the initial tensors a fresh sequence expects: the first dynamic dimension
+  // (batch) becomes 1, other dynamic dimensions (e.g. past sequence length) become 0, and any
+  // remaining elements are zero-filled
+  void initEmptyState(const std::string &session_id);
 
   // Helper method to get element type string
   static const char *getElementTypeString(ONNXTensorElementDataType element_type);
 
+  // Helper method to get the size in bytes of one element, or 0 for non-numeric types
+  static size_t getElementSize(ONNXTensorElementDataType element_type);
+
 private:
   // Generate a unique session ID
   std::string generateSessionId();
 
+  // Look up a session, or nullptr. The returned reference keeps it alive while a run is in flight,
+  // so the manager lock is not held during inference.
+  std::shared_ptr<SessionInfo> getSessionInfo(const std::string &session_id);
+
+  // Load a model and read its input and output names. Runs without holding mutex_.
+  std::shared_ptr<ModelEntry> loadModel(const char *model_path, Ort::SessionOptions *options);
+
+  // Get a loaded model for a new handle, loading it outside mutex_ if needed. Counts the handle.
+  std::shared_ptr<ModelEntry> acquireModel(const char *model_path, Ort::SessionOptions *options,
+                                           const std::string &options_key);
+
+  // Give back a handle taken by acquireModel. Callers hold mutex_.
+  void releaseModel(const std::shared_ptr<ModelEntry> &model);
+
+  // Release idle models, least recently used first, until the cache fits its budget. Callers hold mutex_.
+  void evictIdleModels();
+
   // Map of session IDs to session info
-  std::map<std::string, SessionInfo> sessions_;
+  std::map<std::string, std::shared_ptr<SessionInfo>> sessions_;
+
+  // Loaded models keyed by model identity and options
+  std::map<std::string, std::shared_ptr<ModelEntry>> models_;
+
+  // Loads in progress, so a second request for the same model waits for the first instead of loading twice
+  std::map<std::string, std::shared_future<std::shared_ptr<ModelEntry>>> loading_;
+  size_t model_cache_budget_;
+  uint64_t model_use_tick_;
+  uint64_t shared_loads_;
 
   // Counter for generating unique session IDs
   int next_session_id_;
@@ -93,6 +349,9 @@ private:
 
   // ONNX Runtime environment
   Ort::Env env_;
+
+  // Threads running the sessions of runMany side by side; preloadSessions uses a pool of its own
+  WorkerPool worker_pool_;
 };
 
 #endif // SESSION_MANAGER_H
\ No newline at end of file
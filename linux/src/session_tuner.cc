@@ -0,0 +1,319 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "session_tuner.h"
+#include "hashing.h"
+#include "tensor_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+// Closes a tuning session however its measurement ends
+struct TuningSession {
+  SessionManager *session_manager;
+  std::string session_id;
+
+  ~TuningSession() { session_manager->closeSession(session_id); }
+};
+
+} // namespace
+
+void TunedOptions::apply(Ort::SessionOptions &options) const {
+  options.SetIntraOpNumThreads(intra_op_threads);
+  options.SetInterOpNumThreads(inter_op_threads);
+  options.SetExecutionMode(parallel ? ORT_PARALLEL : ORT_SEQUENTIAL);
+}
+
+std::string TunedOptions::toString() const {
+  return "intra=" + std::to_string(intra_op_threads) + ",inter=" + std::to_string(inter_op_threads) +
+         ",mode=" + (parallel ? "parallel" : "sequential");
+}
+
+SessionTuner::SessionTuner(SessionManager *session_manager, std::string store_path)
+    : session_manager_(session_manager), store_path_(std::move(store_path)), store_loaded_(false) {}
+
+std::vector<TunedOptions> SessionTuner::candidates(unsigned cores) {
+  cores = std::max(1u, cores);
+
+  // Powers of two, all hardware threads, and half of them (the physical cores with SMT)
+  std::vector<int> thread_counts;
+  for (unsigned count = 1; count < cores; count *= 2) {
+    thread_counts.push_back(static_cast<int>(count));
+  }
+  thread_counts.push_back(static_cast<int>(cores));
+  if (cores >= 6) {
+    thread_counts.push_back(static_cast<int>(cores / 2));
+  }
+  std::sort(thread_counts.begin(), thread_counts.end());
+  thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+  std::vector<TunedOptions> result;
+  for (int count : thread_counts) {
+    TunedOptions options;
+    options.intra_op_threads = count;
+    result.push_back(options);
+  }
+
+  // Parallel mode only pays off for graphs with independent branches, so a single split is tried
+  if (cores >= 4) {
+    TunedOptions options;
+    options.intra_op_threads = static_cast<int>(cores / 2);
+    options.inter_op_threads = 2;
+    options.parallel = true;
+    result.push_back(options);
+  }
+  return result;
+}
+
+TuningMeasurement SessionTuner::measure(const std::string &model_path, const TunedOptions &candidate,
+                                        const NamedTensors &inputs, int64_t slice_ms, TuningObjective objective,
+                                        const std::string &options_key,
+                                        const std::function<void(Ort::SessionOptions &)> &configure) {
+  Ort::SessionOptions options;
+  configure(options);
+  candidate.apply(options);
+
+  // A key of its own, so a candidate never picks up a model loaded with other settings or base options
+  std::string cache_key = "autotune|" + candidate.toString() + "|" + options_key;
+  TuningSession session{session_manager_, session_manager_->createSession(model_path.c_str(), &options, cache_key)};
+
+  std::vector<std::string> names;
+  for (const auto &input : inputs) {
+    names.push_back(input.first);
+  }
+  auto run_once = [&]() {
+    // The sample inputs are shared read-only by every run
+    std::vector<Ort::Value> tensors;
+    for (const auto &input : inputs) {
+      tensors.push_back(viewValue(input.second));
+    }
+    session_manager_->runInference(session.session_id, names, std::move(tensors));
+  };
+
+  // The first run pays for lazy initialization and is not measured
+  run_once();
+
+  TuningMeasurement measurement;
+  measurement.options = candidate;
+  if (objective == TuningObjective::kThroughput) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    measurement.concurrency = std::max(1u, cores / static_cast<unsigned>(candidate.intra_op_threads));
+  }
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point start = Clock::now();
+  Clock::time_point deadline = start + std::chrono::milliseconds(slice_ms);
+  std::vector<std::vector<double>> latencies(measurement.concurrency);
+  std::vector<std::exception_ptr> errors(measurement.concurrency);
+  auto caller = [&](size_t index) {
+    try {
+      // Every caller runs at least once, so a slow model still gets a measurement
+      do {
+        Clock::time_point run_start = Clock::now();
+        run_once();
+        latencies[index].push_back(std::chrono::duration<double, std::milli>(Clock::now() - run_start).count());
+      } while (Clock::now() < deadline);
+    } catch (...) {
+      errors[index] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> callers;
+  for (size_t i = 1; i < measurement.concurrency; i++) {
+    callers.emplace_back(caller, i);
+  }
+  caller(0);
+  for (auto &thread : callers) {
+    thread.join();
+  }
+  double elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  std::vector<double> all_latencies;
+  for (const auto &caller_latencies : latencies) {
+    all_latencies.insert(all_latencies.end(), caller_latencies.begin(), caller_latencies.end());
+  }
+  std::nth_element(all_latencies.begin(), all_latencies.begin() + all_latencies.size() / 2, all_latencies.end());
+  measurement.latency_ms = all_latencies[all_latencies.size() / 2];
+  measurement.runs = all_latencies.size();
+  measurement.runs_per_second = elapsed_seconds > 0 ? measurement.runs / elapsed_seconds : 0;
+  return measurement;
+}
+
+TuningResult SessionTuner::tune(const std::string &model_path, const NamedTensors &inputs, int64_t budget_ms,
+                                TuningObjective objective, const std::string &options_key,
+                                const std::function<void(Ort::SessionOptions &)> &configure) {
+  if (budget_ms <= 0) {
+    throw Ort::Exception("Tuning budget must be positive", ORT_INVALID_ARGUMENT);
+  }
+  std::string model_hash = modelHash(model_path);
+  if (model_hash.empty()) {
+    throw Ort::Exception("Cannot read model file: " + model_path, ORT_INVALID_ARGUMENT);
+  }
+
+  std::vector<TunedOptions> candidate_options = candidates(std::thread::hardware_concurrency());
+  int64_t slice_ms = std::max<int64_t>(1, budget_ms / static_cast<int64_t>(candidate_options.size()));
+
+  // Candidates are measured one after another, so they never compete for the cores
+  TuningResult result;
+  for (const auto &candidate : candidate_options) {
+    result.candidates.push_back(measure(model_path, candidate, inputs, slice_ms, objective, options_key, configure));
+  }
+
+  result.best = result.candidates.front();
+  for (const auto &measurement : result.candidates) {
+    bool better = objective == TuningObjective::kLatency ? measurement.latency_ms < result.best.latency_ms
+                                                         : measurement.runs_per_second > result.best.runs_per_second;
+    if (better) {
+      result.best = measurement;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  loadStore();
+  store_[model_hash + "|" + cpuModel()] = result.best.options;
+  saveStore();
+  return result;
+}
+
+bool SessionTuner::lookup(const std::string &model_path, TunedOptions &options) {
+  std::string model_hash = modelHash(model_path);
+  if (model_hash.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  loadStore();
+  auto it = store_.find(model_hash + "|" + cpuModel());
+  if (it == store_.end()) {
+    return false;
+  }
+  options = it->second;
+  return true;
+}
+
+std::string SessionTuner::modelHash(const std::string &model_path) {
+  struct stat file_stat;
+  if (stat(model_path.c_str(), &file_stat) != 0) {
+    return "";
+  }
+  std::string identity = model_path + "|" + std::to_string(file_stat.st_size) + "|" +
+                         std::to_string(file_stat.st_mtim.tv_sec) + "." + std::to_string(file_stat.st_mtim.tv_nsec);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = model_hashes_.find(identity);
+    if (it != model_hashes_.end()) {
+      return it->second;
+    }
+  }
+
+  // Hashed outside the lock; a model is read in full only once per file version
+  std::ifstream file(model_path, std::ios::binary);
+  if (!file) {
+    return "";
+  }
+  uint64_t hash = kHashSeed;
+  std::vector<char> chunk(1 << 20);
+  while (file) {
+    file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    hash = hashBytes(hash, chunk.data(), static_cast<size_t>(file.gcount()));
+  }
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  std::string model_hash = std::string(hex) + "-" + std::to_string(file_stat.st_size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  model_hashes_[identity] = model_hash;
+  return model_hash;
+}
+
+std::string SessionTuner::cpuModel() {
+  std::string name = "unknown";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      size_t colon = line.find(':');
+      if (colon != std::string::npos && colon + 2 <= line.size()) {
+        name = line.substr(colon + 2);
+      }
+      break;
+    }
+  }
+  return name + "|" + std::to_string(std::thread::hardware_concurrency());
+}
+
+void SessionTuner::loadStore() {
+  if (store_loaded_) {
+    return;
+  }
+  store_loaded_ = true;
+  if (store_path_.empty()) {
+    return;
+  }
+
+  // One entry per line: model hash, CPU model, intra-op threads, inter-op threads, mode, separated by tabs
+  std::ifstream file(store_path_);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+      fields.push_back(field);
+    }
+    if (fields.size() != 5) {
+      continue;
+    }
+    TunedOptions options;
+    options.intra_op_threads = std::atoi(fields[2].c_str());
+    options.inter_op_threads = std::atoi(fields[3].c_str());
+    options.parallel = fields[4] == "parallel";
+    if (options.intra_op_threads < 1 || options.inter_op_threads < 1) {
+      continue;
+    }
+    store_[fields[0] + "|" + fields[1]] = options;
+  }
+}
+
+void SessionTuner::saveStore() {
+  if (store_path_.empty()) {
+    return;
+  }
+
+  std::string temp_path = store_path_ + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::trunc);
+    for (const auto &entry : store_) {
+      // The key is "model hash|CPU model|thread count"; only the first separator splits it
+      size_t separator = entry.first.find('|');
+      file << entry.first.substr(0, separator) << '\t' << entry.first.substr(separator + 1) << '\t'
+           << entry.second.intra_op_threads << '\t' << entry.second.inter_op_threads << '\t'
+           << (entry.second.parallel ? "parallel" : "sequential") << '\n';
+    }
+    if (!file) {
+      std::remove(temp_path.c_str());
+      throw Ort::Exception("Cannot write tuned options to " + store_path_, ORT_FAIL);
+    }
+  }
+  if (std::rename(temp_path.c_str(), store_path_.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    throw Ort::Exception("Cannot write tuned options to " + store_path_, ORT_FAIL);
+  }
+}
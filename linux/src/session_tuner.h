@@ -0,0 +1,105 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef SESSION_TUNER_H
+#define SESSION_TUNER_H
+
+#include "session_manager.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+// Thread counts and execution mode of a session, as picked by the tuner
+struct TunedOptions {
+  int intra_op_threads = 1;
+  int inter_op_threads = 1;
+  // ORT_PARALLEL instead of ORT_SEQUENTIAL execution of independent graph branches
+  bool parallel = false;
+
+  void apply(Ort::SessionOptions &options) const;
+
+  // Stable text form, e.g. "intra=4,inter=1,mode=sequential", also used in model cache keys
+  std::string toString() const;
+};
+
+// What the tuner optimizes for
+enum class TuningObjective {
+  // Lowest median time of one run with a single caller
+  kLatency,
+  // Most runs per second with as many concurrent callers as the candidate's threads fit in the CPU
+  kThroughput,
+};
+
+// Benchmark of one candidate
+struct TuningMeasurement {
+  TunedOptions options;
+  double latency_ms = 0;
+  double runs_per_second = 0;
+  // Concurrent callers during the measurement
+  size_t concurrency = 1;
+  uint64_t runs = 0;
+};
+
+struct TuningResult {
+  TuningMeasurement best;
+  std::vector<TuningMeasurement> candidates;
+};
+
+// Picks session thread counts and execution mode for a model by benchmarking candidates natively, and
+// remembers the winner per model content and CPU, so later sessions reuse it without tuning again
+class SessionTuner {
+public:
+  // Tuned options are persisted to the file at `store_path`; an empty path keeps them in memory only
+  SessionTuner(SessionManager *session_manager, std::string store_path);
+
+  // Open a session of the model per candidate, run it on `inputs` for an equal share of `budget_ms`
+  // (model loading is not counted), and persist the best candidate for `objective`. `configure` fills
+  // the rest of every candidate's options (e.g. providers) before the candidate's settings are applied;
+  // `options_key` identifies what it fills (e.g. its canonical form) in the model cache keys of the candidates.
+  TuningResult tune(const std::string &model_path, const NamedTensors &inputs, int64_t budget_ms,
+                    TuningObjective objective, const std::string &options_key,
+                    const std::function<void(Ort::SessionOptions &)> &configure);
+
+  // Look up the options persisted for the model at `model_path` on this CPU
+  bool lookup(const std::string &model_path, TunedOptions &options);
+
+  // Settings worth trying on a CPU with `cores` hardware threads
+  static std::vector<TunedOptions> candidates(unsigned cores);
+
+private:
+  TuningMeasurement measure(const std::string &model_path, const TunedOptions &candidate, const NamedTensors &inputs,
+                            int64_t slice_ms, TuningObjective objective, const std::string &options_key,
+                            const std::function<void(Ort::SessionOptions &)> &configure);
+
+  // Content hash of a model file, memoized by path, size and modification time. Empty if it cannot be read.
+  std::string modelHash(const std::string &model_path);
+
+  // CPU model name and hardware thread count, e.g. "AMD Ryzen 7 5800X|16"
+  static std::string cpuModel();
+
+  // Read the store file once; callers hold mutex_
+  void loadStore();
+
+  // Write the store file through a temporary file, so a crash never leaves it half written. Callers hold mutex_.
+  void saveStore();
+
+  SessionManager *session_manager_;
+  std::string store_path_;
+  std::mutex mutex_;
+  bool store_loaded_;
+
+  // Tuned options keyed by "model hash|CPU model"
+  std::map<std::string, TunedOptions> store_;
+
+  // Model hashes keyed by "path|size|mtime"
+  std::map<std::string, std::string> model_hashes_;
+};
+
+#endif // SESSION_TUNER_H
@@ -6,28 +6,37 @@
 
 #include "tensor_manager.h"
 #include "session_manager.h"
+#include "tensor_ops.h"
 #include "value_conversion.h"
+#include <algorithm>
+#include <stdexcept>
 
 TensorManager::TensorManager()
-    : next_tensor_id_(1), memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {}
+    : use_tick_(0), next_scope_id_(1), over_soft_limit_(false), over_budget_(false), next_tensor_id_(1),
+      memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {}
 
 TensorManager::~TensorManager() {
   std::lock_guard<std::mutex> lock(mutex_);
   tensors_.clear();
   tensor_types_.clear();
   tensor_shapes_.clear();
+  tracked_.clear();
+  // Tensors go before the arenas holding their buffers
+  scopes_.clear();
 }
 
 std::string TensorManager::generateTensorId() { return "tensor_" + std::to_string(next_tensor_id_++); }
 
-std::string TensorManager::createFloat32Tensor(const std::vector<float> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createFloat32Tensor(const std::vector<float> &data, const std::vector<int64_t> &shape,
+                                               const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
     std::string tensor_id = generateTensorId();
     // make a more robust copy, avoid the delocation of the original data
-    float *tensor_data = new float[data.size()];
+    float *tensor_data = allocateData<float>(scope, data.size());
     std::copy(data.begin(), data.end(), tensor_data);
     // Create a new tensor with our persistent copy of the data
     auto tensor = Ort::Value::CreateTensor<float>(memory_info_, tensor_data, data.size(), shape.data(), shape.size());
@@ -35,6 +44,7 @@ std::string TensorManager::createFloat32Tensor(const std::vector<float> &data, c
     // Following RAII principles, use std::make_unique to tie the OrtValue lifetime to the pointer
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "float32";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -43,20 +53,23 @@ std::string TensorManager::createFloat32Tensor(const std::vector<float> &data, c
   }
 }
 
-std::string TensorManager::createInt32Tensor(const std::vector<int32_t> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createInt32Tensor(const std::vector<int32_t> &data, const std::vector<int64_t> &shape,
+                                             const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
     std::string tensor_id = generateTensorId();
     // Make a robust copy of the data
-    int32_t *tensor_data = new int32_t[data.size()];
+    int32_t *tensor_data = allocateData<int32_t>(scope, data.size());
     std::copy(data.begin(), data.end(), tensor_data);
     // Create a new tensor with our persistent copy of the data
     auto tensor = Ort::Value::CreateTensor<int32_t>(memory_info_, tensor_data, data.size(), shape.data(), shape.size());
     // Store the tensor with direct ownership, its type, and shape
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "int32";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -65,20 +78,23 @@ std::string TensorManager::createInt32Tensor(const std::vector<int32_t> &data, c
   }
 }
 
-std::string TensorManager::createInt64Tensor(const std::vector<int64_t> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createInt64Tensor(const std::vector<int64_t> &data, const std::vector<int64_t> &shape,
+                                             const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
     std::string tensor_id = generateTensorId();
     // Make a robust copy of the data
-    int64_t *tensor_data = new int64_t[data.size()];
+    int64_t *tensor_data = allocateData<int64_t>(scope, data.size());
     std::copy(data.begin(), data.end(), tensor_data);
     // Create a new tensor with our persistent copy of the data
     auto tensor = Ort::Value::CreateTensor<int64_t>(memory_info_, tensor_data, data.size(), shape.data(), shape.size());
     // Store the tensor with direct ownership, its type, and shape
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "int64";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -87,20 +103,23 @@ std::string TensorManager::createInt64Tensor(const std::vector<int64_t> &data, c
   }
 }
 
-std::string TensorManager::createUint8Tensor(const std::vector<uint8_t> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createUint8Tensor(const std::vector<uint8_t> &data, const std::vector<int64_t> &shape,
+                                             const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
     std::string tensor_id = generateTensorId();
     // Make a robust copy of the data
-    uint8_t *tensor_data = new uint8_t[data.size()];
+    uint8_t *tensor_data = allocateData<uint8_t>(scope, data.size());
     std::copy(data.begin(), data.end(), tensor_data);
     // Create a new tensor with our persistent copy of the data
     auto tensor = Ort::Value::CreateTensor<uint8_t>(memory_info_, tensor_data, data.size(), shape.data(), shape.size());
     // Store the tensor with direct ownership, its type, and shape
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "uint8";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -109,14 +128,16 @@ std::string TensorManager::createUint8Tensor(const std::vector<uint8_t> &data, c
   }
 }
 
-std::string TensorManager::createBoolTensor(const std::vector<bool> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createBoolTensor(const std::vector<bool> &data, const std::vector<int64_t> &shape,
+                                            const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
     std::string tensor_id = generateTensorId();
     // Create a regular array for the boolean data (std::vector<bool> is specialized and can't be used directly)
-    bool *tensor_data = new bool[data.size()];
+    bool *tensor_data = allocateData<bool>(scope, data.size());
     for (size_t i = 0; i < data.size(); i++) {
       tensor_data[i] = data[i];
     }
@@ -125,6 +146,7 @@ std::string TensorManager::createBoolTensor(const std::vector<bool> &data, const
     // Store the tensor with direct ownership, its type, and shape
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "bool";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -133,8 +155,10 @@ std::string TensorManager::createBoolTensor(const std::vector<bool> &data, const
   }
 }
 
-std::string TensorManager::createStringTensor(const std::vector<std::string> &data, const std::vector<int64_t> &shape) {
+std::string TensorManager::createStringTensor(const std::vector<std::string> &data, const std::vector<int64_t> &shape,
+                                              const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  TensorScope *scope = findScope(scope_id);
 
   try {
     // Create a unique tensor ID
@@ -160,6 +184,7 @@ std::string TensorManager::createStringTensor(const std::vector<std::string> &da
 
     tensors_[tensor_id] = std::make_unique<Ort::Value>(std::move(tensor));
     tensor_types_[tensor_id] = "string";
+    trackTensor(tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[tensor_id] = shape;
 
     return tensor_id;
@@ -180,6 +205,7 @@ FlValue *TensorManager::getTensorData(const std::string &tensor_id) {
     // Tensor not found
     return fl_value_new_null();
   }
+  touchTensor(tensor_id);
 
   // Create result map
   g_autoptr(FlValue) result = fl_value_new_map();
@@ -292,6 +318,7 @@ bool TensorManager::releaseTensor(const std::string &tensor_id) {
   }
 
   // Remove tensor, type, and shape
+  untrackTensor(tensor_id);
   tensors_.erase(tensor_it);
   if (type_it != tensor_types_.end()) {
     tensor_types_.erase(type_it);
@@ -311,11 +338,15 @@ Ort::Value *TensorManager::getTensor(const std::string &tensor_id) {
     return nullptr;
   }
 
+  touchTensor(tensor_id);
   return it->second.get();
 }
 
-void TensorManager::storeTensor(const std::string &tensor_id, Ort::Value &&tensor) {
+void TensorManager::storeTensor(const std::string &tensor_id, Ort::Value &&tensor, const std::string &scope_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  // A scope released while the run was in flight leaves its outputs to the caller
+  auto scope_it = scopes_.find(scope_id);
+  TensorScope *scope = scope_it != scopes_.end() ? &scope_it->second : nullptr;
 
   try {
     // Store the tensor
@@ -331,6 +362,7 @@ void TensorManager::storeTensor(const std::string &tensor_id, Ort::Value &&tenso
     // Get and store the tensor type
     ONNXTensorElementDataType element_type = tensor_info.GetElementType();
     tensor_types_[tensor_id] = SessionManager::getElementTypeString(element_type);
+    trackTensor(tensor_id, TensorOrigin::output, scope);
   } catch (const std::exception &e) {
     // Handle exception - maybe log it
   }
@@ -346,7 +378,8 @@ std::vector<int64_t> TensorManager::getTensorShape(const std::string &tensor_id)
   return tensor_shapes_.at(tensor_id);
 }
 
-std::string TensorManager::convertTensor(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertTensor(const std::string &tensor_id, const std::string &target_type,
+                                         const std::string &scope_id) {
 
   // Check if the tensor exists
   auto tensor_it = tensors_.find(tensor_id);
@@ -363,6 +396,8 @@ std::string TensorManager::convertTensor(const std::string &tensor_id, const std
 
     // Clone the tensor
     auto new_tensor = cloneTensor(tensor_id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    TensorScope *scope = findScope(scope_id);
     // Create a new tensor ID
     std::string new_tensor_id = generateTensorId();
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
@@ -372,6 +407,7 @@ std::string TensorManager::convertTensor(const std::string &tensor_id, const std
     Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
     std::vector<int64_t> shape = tensor_info.GetShape();
     tensor_types_[new_tensor_id] = source_type;
+    trackTensor(new_tensor_id, TensorOrigin::user, scope);
     tensor_shapes_[new_tensor_id] = shape;
 
     return new_tensor_id;
@@ -380,21 +416,23 @@ std::string TensorManager::convertTensor(const std::string &tensor_id, const std
   std::lock_guard<std::mutex> lock(mutex_);
   // Convert based on the source type
   if (source_type == "float32") {
-    return convertFloat32To(tensor_id, target_type);
+    return convertFloat32To(tensor_id, target_type, scope_id);
   } else if (source_type == "int32") {
-    return convertInt32To(tensor_id, target_type);
+    return convertInt32To(tensor_id, target_type, scope_id);
   } else if (source_type == "int64") {
-    return convertInt64To(tensor_id, target_type);
+    return convertInt64To(tensor_id, target_type, scope_id);
   } else if (source_type == "uint8") {
-    return convertUint8To(tensor_id, target_type);
+    return convertUint8To(tensor_id, target_type, scope_id);
   } else if (source_type == "bool") {
-    return convertBoolTo(tensor_id, target_type);
+    return convertBoolTo(tensor_id, target_type, scope_id);
   }
 
   throw std::runtime_error("Unsupported type conversion: " + source_type + " to " + target_type);
 }
 
-std::string TensorManager::convertFloat32To(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertFloat32To(const std::string &tensor_id, const std::string &target_type,
+                                            const std::string &scope_id) {
+  TensorScope *scope = findScope(scope_id);
   // Get the tensor
   Ort::Value *tensor = tensors_[tensor_id].get();
   Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
@@ -408,7 +446,7 @@ std::string TensorManager::convertFloat32To(const std::string &tensor_id, const
   // Convert to the target type
   if (target_type == "int32") {
     // Convert float32 to int32
-    int32_t *new_data = new int32_t[elem_count];
+    int32_t *new_data = allocateData<int32_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Round float to int
       new_data[i] = static_cast<int32_t>(data[i] + (data[i] >= 0 ? 0.5f : -0.5f));
@@ -417,7 +455,7 @@ std::string TensorManager::convertFloat32To(const std::string &tensor_id, const
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int64") {
     // Convert float32 to int64
-    int64_t *new_data = new int64_t[elem_count];
+    int64_t *new_data = allocateData<int64_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Round float to int64
       new_data[i] = static_cast<int64_t>(data[i] + (data[i] >= 0 ? 0.5f : -0.5f));
@@ -426,7 +464,7 @@ std::string TensorManager::convertFloat32To(const std::string &tensor_id, const
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "uint8") {
     // Convert float32 to uint8
-    uint8_t *new_data = new uint8_t[elem_count];
+    uint8_t *new_data = allocateData<uint8_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Clamp between 0 and 255
       float val = data[i] < 0 ? 0 : (data[i] > 255 ? 255 : data[i] + 0.5f);
@@ -436,7 +474,7 @@ std::string TensorManager::convertFloat32To(const std::string &tensor_id, const
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "bool") {
     // Convert float32 to bool
-    bool *new_data = new bool[elem_count];
+    bool *new_data = allocateData<bool>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] != 0.0f;
     }
@@ -449,11 +487,14 @@ std::string TensorManager::convertFloat32To(const std::string &tensor_id, const
   // Store the shape
   tensor_shapes_[new_tensor_id] = shape;
   tensor_types_[new_tensor_id] = target_type;
+  trackTensor(new_tensor_id, TensorOrigin::user, scope);
 
   return new_tensor_id;
 }
 
-std::string TensorManager::convertInt32To(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertInt32To(const std::string &tensor_id, const std::string &target_type,
+                                          const std::string &scope_id) {
+  TensorScope *scope = findScope(scope_id);
   // Get the tensor
   Ort::Value *tensor = tensors_[tensor_id].get();
   Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
@@ -467,7 +508,7 @@ std::string TensorManager::convertInt32To(const std::string &tensor_id, const st
   // Convert to the target type
   if (target_type == "float32") {
     // Convert int32 to float32
-    float *new_data = new float[elem_count];
+    float *new_data = allocateData<float>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = static_cast<float>(data[i]);
     }
@@ -475,7 +516,7 @@ std::string TensorManager::convertInt32To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int64") {
     // Convert int32 to int64
-    int64_t *new_data = new int64_t[elem_count];
+    int64_t *new_data = allocateData<int64_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = static_cast<int64_t>(data[i]);
     }
@@ -483,7 +524,7 @@ std::string TensorManager::convertInt32To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "uint8") {
     // Convert int32 to uint8
-    uint8_t *new_data = new uint8_t[elem_count];
+    uint8_t *new_data = allocateData<uint8_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Clamp between 0 and 255
       int32_t val = data[i] < 0 ? 0 : (data[i] > 255 ? 255 : data[i]);
@@ -493,7 +534,7 @@ std::string TensorManager::convertInt32To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "bool") {
     // Convert int32 to bool
-    bool *new_data = new bool[elem_count];
+    bool *new_data = allocateData<bool>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] != 0;
     }
@@ -506,11 +547,14 @@ std::string TensorManager::convertInt32To(const std::string &tensor_id, const st
   // Store the shape
   tensor_shapes_[new_tensor_id] = shape;
   tensor_types_[new_tensor_id] = target_type;
+  trackTensor(new_tensor_id, TensorOrigin::user, scope);
 
   return new_tensor_id;
 }
 
-std::string TensorManager::convertInt64To(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertInt64To(const std::string &tensor_id, const std::string &target_type,
+                                          const std::string &scope_id) {
+  TensorScope *scope = findScope(scope_id);
   // Get the tensor
   Ort::Value *tensor = tensors_[tensor_id].get();
   Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
@@ -524,7 +568,7 @@ std::string TensorManager::convertInt64To(const std::string &tensor_id, const st
   // Convert to the target type
   if (target_type == "float32") {
     // Convert int64 to float32
-    float *new_data = new float[elem_count];
+    float *new_data = allocateData<float>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Note: potential precision loss for large int64 values
       new_data[i] = static_cast<float>(data[i]);
@@ -533,7 +577,7 @@ std::string TensorManager::convertInt64To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int32") {
     // Convert int64 to int32
-    int32_t *new_data = new int32_t[elem_count];
+    int32_t *new_data = allocateData<int32_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Clamp to int32 range to prevent overflow
       int64_t val = data[i];
@@ -547,7 +591,7 @@ std::string TensorManager::convertInt64To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "uint8") {
     // Convert int64 to uint8
-    uint8_t *new_data = new uint8_t[elem_count];
+    uint8_t *new_data = allocateData<uint8_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       // Clamp between 0 and 255
       int64_t val = data[i] < 0 ? 0 : (data[i] > 255 ? 255 : data[i]);
@@ -557,7 +601,7 @@ std::string TensorManager::convertInt64To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "bool") {
     // Convert int64 to bool
-    bool *new_data = new bool[elem_count];
+    bool *new_data = allocateData<bool>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] != 0;
     }
@@ -570,11 +614,14 @@ std::string TensorManager::convertInt64To(const std::string &tensor_id, const st
   // Store the shape
   tensor_shapes_[new_tensor_id] = shape;
   tensor_types_[new_tensor_id] = target_type;
+  trackTensor(new_tensor_id, TensorOrigin::user, scope);
 
   return new_tensor_id;
 }
 
-std::string TensorManager::convertUint8To(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertUint8To(const std::string &tensor_id, const std::string &target_type,
+                                          const std::string &scope_id) {
+  TensorScope *scope = findScope(scope_id);
   // Get the tensor
   Ort::Value *tensor = tensors_[tensor_id].get();
   Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
@@ -588,7 +635,7 @@ std::string TensorManager::convertUint8To(const std::string &tensor_id, const st
   // Convert to the target type
   if (target_type == "float32") {
     // Convert uint8 to float32
-    float *new_data = new float[elem_count];
+    float *new_data = allocateData<float>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = static_cast<float>(data[i]);
     }
@@ -596,7 +643,7 @@ std::string TensorManager::convertUint8To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int32") {
     // Convert uint8 to int32
-    int32_t *new_data = new int32_t[elem_count];
+    int32_t *new_data = allocateData<int32_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = static_cast<int32_t>(data[i]);
     }
@@ -604,7 +651,7 @@ std::string TensorManager::convertUint8To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int64") {
     // Convert uint8 to int64
-    int64_t *new_data = new int64_t[elem_count];
+    int64_t *new_data = allocateData<int64_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = static_cast<int64_t>(data[i]);
     }
@@ -612,7 +659,7 @@ std::string TensorManager::convertUint8To(const std::string &tensor_id, const st
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "bool") {
     // Convert uint8 to bool
-    bool *new_data = new bool[elem_count];
+    bool *new_data = allocateData<bool>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] != 0;
     }
@@ -625,11 +672,14 @@ std::string TensorManager::convertUint8To(const std::string &tensor_id, const st
   // Store the shape
   tensor_shapes_[new_tensor_id] = shape;
   tensor_types_[new_tensor_id] = target_type;
+  trackTensor(new_tensor_id, TensorOrigin::user, scope);
 
   return new_tensor_id;
 }
 
-std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std::string &target_type) {
+std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std::string &target_type,
+                                         const std::string &scope_id) {
+  TensorScope *scope = findScope(scope_id);
   // Get the tensor
   Ort::Value *tensor = tensors_[tensor_id].get();
   Ort::TensorTypeAndShapeInfo tensor_info = tensor->GetTensorTypeAndShapeInfo();
@@ -643,7 +693,7 @@ std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std
   // Convert to the target type
   if (target_type == "float32") {
     // Convert bool to float32
-    float *new_data = new float[elem_count];
+    float *new_data = allocateData<float>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] ? 1.0f : 0.0f;
     }
@@ -651,7 +701,7 @@ std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int32") {
     // Convert bool to int32
-    int32_t *new_data = new int32_t[elem_count];
+    int32_t *new_data = allocateData<int32_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] ? 1 : 0;
     }
@@ -659,7 +709,7 @@ std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "int64") {
     // Convert bool to int64
-    int64_t *new_data = new int64_t[elem_count];
+    int64_t *new_data = allocateData<int64_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] ? 1 : 0;
     }
@@ -667,7 +717,7 @@ std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std
     tensors_[new_tensor_id] = std::make_unique<Ort::Value>(std::move(new_tensor));
   } else if (target_type == "uint8") {
     // Convert bool to uint8
-    uint8_t *new_data = new uint8_t[elem_count];
+    uint8_t *new_data = allocateData<uint8_t>(scope, elem_count);
     for (size_t i = 0; i < elem_count; i++) {
       new_data[i] = data[i] ? 1 : 0;
     }
@@ -680,6 +730,7 @@ std::string TensorManager::convertBoolTo(const std::string &tensor_id, const std
   // Store the shape
   tensor_shapes_[new_tensor_id] = shape;
   tensor_types_[new_tensor_id] = target_type;
+  trackTensor(new_tensor_id, TensorOrigin::user, scope);
 
   return new_tensor_id;
 }
@@ -695,6 +746,7 @@ Ort::Value TensorManager::cloneTensor(const std::string &tensor_id) {
   if (tensor_it == tensors_.end() || type_it == tensor_types_.end() || shape_it == tensor_shapes_.end()) {
     throw std::runtime_error("Tensor not found: " + tensor_id);
   }
+  touchTensor(tensor_id);
 
   Ort::Value *tensor_ptr = tensor_it->second.get();
   const std::string &tensor_type = type_it->second;
@@ -772,3 +824,206 @@ Ort::Value TensorManager::cloneTensor(const std::string &tensor_id) {
     throw std::runtime_error("Unsupported tensor type: " + tensor_type);
   }
 }
+
+void TensorManager::trackTensor(const std::string &tensor_id, TensorOrigin origin, TensorScope *scope) {
+  // Storing over an existing ID replaces that tensor
+  untrackTensor(tensor_id);
+
+  TrackedTensor tracked{tensor_types_[tensor_id], origin, tensorByteSize(*tensors_[tensor_id]), false, ++use_tick_};
+  TensorUsage &by_type = memory_stats_.by_type[tracked.type];
+  TensorUsage &by_origin = memory_stats_.by_origin[origin == TensorOrigin::user ? "user" : "output"];
+  for (TensorUsage *usage : {&memory_stats_.total, &by_type, &by_origin}) {
+    usage->count++;
+    usage->bytes += tracked.bytes;
+  }
+  memory_stats_.peak.count = std::max(memory_stats_.peak.count, memory_stats_.total.count);
+  memory_stats_.peak.bytes = std::max(memory_stats_.peak.bytes, memory_stats_.total.bytes);
+
+  if (isEvictable(tracked)) {
+    evictable_[tracked.last_used] = tensor_id;
+  }
+  tracked_[tensor_id] = std::move(tracked);
+
+  if (scope != nullptr) {
+    scope->tensor_ids.push_back(tensor_id);
+  }
+
+  enforceBudget(tensor_id);
+}
+
+void TensorManager::untrackTensor(const std::string &tensor_id) {
+  auto it = tracked_.find(tensor_id);
+  if (it == tracked_.end()) {
+    return;
+  }
+
+  const TrackedTensor &tracked = it->second;
+  evictable_.erase(tracked.last_used);
+  TensorUsage &by_type = memory_stats_.by_type[tracked.type];
+  TensorUsage &by_origin = memory_stats_.by_origin[tracked.origin == TensorOrigin::user ? "user" : "output"];
+  for (TensorUsage *usage : {&memory_stats_.total, &by_type, &by_origin}) {
+    usage->count--;
+    usage->bytes -= tracked.bytes;
+  }
+  tracked_.erase(it);
+}
+
+TensorMemoryStats TensorManager::getMemoryStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return memory_stats_;
+}
+
+void TensorManager::touchTensor(const std::string &tensor_id) {
+  auto it = tracked_.find(tensor_id);
+  if (it == tracked_.end()) {
+    return;
+  }
+
+  TrackedTensor &tracked = it->second;
+  evictable_.erase(tracked.last_used);
+  tracked.last_used = ++use_tick_;
+  if (isEvictable(tracked)) {
+    evictable_[tracked.last_used] = tensor_id;
+  }
+}
+
+void TensorManager::enforceBudget(const std::string &keep_id) {
+  // Keep enough IDs to explain a late access to an evicted output, but not every one ever evicted
+  const size_t max_remembered_evictions = 1024;
+
+  size_t budget = memory_stats_.budget_bytes;
+  auto victim = evictable_.begin();
+  while (budget > 0 && memory_stats_.total.bytes > budget && victim != evictable_.end()) {
+    if (victim->second == keep_id) {
+      ++victim;
+      continue;
+    }
+
+    std::string tensor_id = victim->second;
+    ++victim;
+    untrackTensor(tensor_id);
+    tensors_.erase(tensor_id);
+    tensor_types_.erase(tensor_id);
+    tensor_shapes_.erase(tensor_id);
+    memory_stats_.evictions++;
+
+    evicted_.insert(tensor_id);
+    evicted_order_.push_back(tensor_id);
+    if (evicted_order_.size() > max_remembered_evictions) {
+      evicted_.erase(evicted_order_.front());
+      evicted_order_.pop_front();
+    }
+  }
+
+  size_t bytes = memory_stats_.total.bytes;
+  size_t soft_limit = memory_stats_.soft_limit_bytes;
+  bool over_soft_limit = soft_limit > 0 && bytes > soft_limit;
+  bool over_budget = budget > 0 && bytes > budget;
+  if (on_warning_ && over_soft_limit && !over_soft_limit_) {
+    on_warning_("soft", bytes, soft_limit);
+  }
+  if (on_warning_ && over_budget && !over_budget_) {
+    on_warning_("hard", bytes, budget);
+  }
+  over_soft_limit_ = over_soft_limit;
+  over_budget_ = over_budget;
+}
+
+void TensorManager::configureBudget(size_t budget_bytes, size_t soft_limit_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memory_stats_.budget_bytes = budget_bytes;
+  memory_stats_.soft_limit_bytes = soft_limit_bytes;
+  over_soft_limit_ = false;
+  over_budget_ = false;
+  enforceBudget("");
+}
+
+bool TensorManager::setPinned(const std::string &tensor_id, bool pinned) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = tracked_.find(tensor_id);
+  if (it == tracked_.end()) {
+    return false;
+  }
+
+  TrackedTensor &tracked = it->second;
+  tracked.pinned = pinned;
+  evictable_.erase(tracked.last_used);
+  if (isEvictable(tracked)) {
+    evictable_[tracked.last_used] = tensor_id;
+  }
+  return true;
+}
+
+bool TensorManager::wasEvicted(const std::string &tensor_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return evicted_.find(tensor_id) != evicted_.end();
+}
+
+void TensorManager::setMemoryWarningCallback(MemoryWarningCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  on_warning_ = std::move(callback);
+}
+
+TensorManager::TensorScope *TensorManager::findScope(const std::string &scope_id) {
+  if (scope_id.empty()) {
+    return nullptr;
+  }
+  auto it = scopes_.find(scope_id);
+  if (it == scopes_.end()) {
+    throw std::invalid_argument("Scope not found: " + scope_id);
+  }
+  return &it->second;
+}
+
+std::string TensorManager::beginScope(const std::string &parent_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  findScope(parent_id);
+  std::string scope_id = "scope_" + std::to_string(next_scope_id_++);
+  scopes_[scope_id].parent_id = parent_id;
+  return scope_id;
+}
+
+size_t TensorManager::releaseScope(const std::string &scope_id, const std::set<std::string> &keep_ids) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto scope_it = scopes_.find(scope_id);
+  if (scope_it == scopes_.end()) {
+    throw std::invalid_argument("Scope not found: " + scope_id);
+  }
+  TensorScope &scope = scope_it->second;
+
+  auto parent_it = scopes_.find(scope.parent_id);
+  TensorScope *parent = parent_it != scopes_.end() ? &parent_it->second : nullptr;
+
+  size_t released = 0;
+  for (const auto &tensor_id : scope.tensor_ids) {
+    auto tensor_it = tensors_.find(tensor_id);
+    if (tensor_it == tensors_.end()) {
+      // Released or evicted already
+      continue;
+    }
+
+    if (keep_ids.find(tensor_id) != keep_ids.end()) {
+      // The arena goes away below, so a kept tensor needs its own copy of the data
+      Ort::Value &tensor = *tensor_it->second;
+      if (tensor.IsTensor() && scope.arena.owns(tensor.GetTensorRawData())) {
+        tensor = cloneValue(tensor);
+      }
+      if (parent != nullptr) {
+        parent->tensor_ids.push_back(tensor_id);
+      }
+      continue;
+    }
+
+    untrackTensor(tensor_id);
+    tensors_.erase(tensor_it);
+    tensor_types_.erase(tensor_id);
+    tensor_shapes_.erase(tensor_id);
+    released++;
+  }
+
+  // Every tensor using the arena is gone, so all of its blocks are freed in one go
+  scopes_.erase(scope_it);
+  return released;
+}
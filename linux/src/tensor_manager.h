@@ -7,17 +7,57 @@
 #ifndef TENSOR_MANAGER_H
 #define TENSOR_MANAGER_H
 
+#include "scope_arena.h"
+#include <atomic>
+#include <deque>
 #include <flutter_linux/flutter_linux.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <onnxruntime_cxx_api.h>
+#include <set>
 #include <string>
 #include <vector>
 
 // Forward declare SessionManager
 class SessionManager;
 
+// Where a stored tensor came from
+enum class TensorOrigin {
+  // Created or converted from Dart data
+  user,
+  // Returned by a run
+  output,
+};
+
+// Number and data size of a group of tensors
+struct TensorUsage {
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+// Live tensors held by the TensorManager
+struct TensorMemoryStats {
+  TensorUsage total;
+  // Highest count and highest bytes reached so far (not necessarily at the same time)
+  TensorUsage peak;
+  // Keyed by data type name, e.g. "float32"
+  std::map<std::string, TensorUsage> by_type;
+  // Keyed "user" or "output"
+  std::map<std::string, TensorUsage> by_origin;
+  // Budget set with configureBudget, 0 when unlimited
+  size_t budget_bytes = 0;
+  size_t soft_limit_bytes = 0;
+  // Tensors evicted to stay within the budget
+  uint64_t evictions = 0;
+};
+
+// Called when live tensors cross a limit: level "soft" past the soft limit, "hard" when the budget is still
+// exceeded after evicting every evictable tensor. Runs with the TensorManager locked, so it must not call back
+// into it or block.
+using MemoryWarningCallback = std::function<void(const char *level, size_t bytes, size_t limit_bytes)>;
+
 // Class to manage tensor data
 class TensorManager {
 public:
@@ -29,43 +69,55 @@ public:
   TensorManager &operator=(const TensorManager &) = delete;
 
   // Create a tensor from Float32List data
-  std::string createFloat32Tensor(const std::vector<float> &data, const std::vector<int64_t> &shape);
+  std::string createFloat32Tensor(const std::vector<float> &data, const std::vector<int64_t> &shape,
+                                  const std::string &scope_id = "");
 
   // Create a tensor from Int32List data
-  std::string createInt32Tensor(const std::vector<int32_t> &data, const std::vector<int64_t> &shape);
+  std::string createInt32Tensor(const std::vector<int32_t> &data, const std::vector<int64_t> &shape,
+                                const std::string &scope_id = "");
 
   // Create a tensor from Int64List data
-  std::string createInt64Tensor(const std::vector<int64_t> &data, const std::vector<int64_t> &shape);
+  std::string createInt64Tensor(const std::vector<int64_t> &data, const std::vector<int64_t> &shape,
+                                const std::string &scope_id = "");
 
   // Create a tensor from Uint8List data
-  std::string createUint8Tensor(const std::vector<uint8_t> &data, const std::vector<int64_t> &shape);
+  std::string createUint8Tensor(const std::vector<uint8_t> &data, const std::vector<int64_t> &shape,
+                                const std::string &scope_id = "");
 
   // Create a tensor from Boolean data
-  std::string createBoolTensor(const std::vector<bool> &data, const std::vector<int64_t> &shape);
+  std::string createBoolTensor(const std::vector<bool> &data, const std::vector<int64_t> &shape,
+                               const std::string &scope_id = "");
 
   // Create a tensor from String data
-  std::string createStringTensor(const std::vector<std::string> &data, const std::vector<int64_t> &shape);
+  std::string createStringTensor(const std::vector<std::string> &data, const std::vector<int64_t> &shape,
+                                 const std::string &scope_id = "");
 
   // Convert between tensor formats
-  std::string convertTensor(const std::string &tensor_id, const std::string &target_type);
+  std::string convertTensor(const std::string &tensor_id, const std::string &target_type,
+                            const std::string &scope_id = "");
 
   // Convert float32 tensor to another type
-  std::string convertFloat32To(const std::string &tensor_id, const std::string &target_type);
+  std::string convertFloat32To(const std::string &tensor_id, const std::string &target_type,
+                               const std::string &scope_id = "");
 
   // Convert int32 tensor to another type
-  std::string convertInt32To(const std::string &tensor_id, const std::string &target_type);
+  std::string convertInt32To(const std::string &tensor_id, const std::string &target_type,
+                             const std::string &scope_id = "");
 
   // Convert int64 tensor to another type
-  std::string convertInt64To(const std::string &tensor_id, const std::string &target_type);
+  std::string convertInt64To(const std::string &tensor_id, const std::string &target_type,
+                             const std::string &scope_id = "");
 
   // Convert uint8 tensor to another type
-  std::string convertUint8To(const std::string &tensor_id, const std::string &target_type);
+  std::string convertUint8To(const std::string &tensor_id, const std::string &target_type,
+                             const std::string &scope_id = "");
 
   // Convert bool tensor to another type
-  std::string convertBoolTo(const std::string &tensor_id, const std::string &target_type);
+  std::string convertBoolTo(const std::string &tensor_id, const std::string &target_type,
+                            const std::string &scope_id = "");
 
   // Store a tensor with a specific ID (used for output tensors)
-  void storeTensor(const std::string &tensor_id, Ort::Value &&tensor);
+  void storeTensor(const std::string &tensor_id, Ort::Value &&tensor, const std::string &scope_id = "");
 
   // Get data from a tensor
   FlValue *getTensorData(const std::string &tensor_id);
@@ -88,7 +140,76 @@ public:
   // Clone a tensor and return a new deep copy of it
   Ort::Value cloneTensor(const std::string &tensor_id);
 
+  // Get the count and bytes of live tensors, per data type and origin
+  TensorMemoryStats getMemoryStats();
+
+  // Cap the bytes of live tensors. Past `budget_bytes`, unpinned run outputs are evicted least recently used
+  // first; tensors created from Dart data are never evicted. Past `soft_limit_bytes` a warning is raised.
+  // 0 turns either limit off.
+  void configureBudget(size_t budget_bytes, size_t soft_limit_bytes);
+
+  // Exempt a run output from eviction, or make it evictable again. Returns false if the tensor does not exist.
+  bool setPinned(const std::string &tensor_id, bool pinned);
+
+  // Whether a tensor ID was recently evicted by the budget, to tell it apart from an unknown ID
+  bool wasEvicted(const std::string &tensor_id);
+
+  // Set the callback receiving limit warnings
+  void setMemoryWarningCallback(MemoryWarningCallback callback);
+
+  // Open a scope inside `parent_id`, or at top level when empty. A tensor belongs to a scope only when the call
+  // storing it (create, convert or store above) names the scope; the buffers of tensors created from Dart data
+  // then come from the scope's arena. Throws std::invalid_argument for an unknown parent.
+  std::string beginScope(const std::string &parent_id = "");
+
+  // Release every tensor of a scope except those in `keep_ids`, free its arena and close it. Kept tensors move
+  // to the parent scope, if it is still open, and are copied out of the arena first. Returns the number
+  // released. Throws std::invalid_argument for an unknown scope.
+  size_t releaseScope(const std::string &scope_id, const std::set<std::string> &keep_ids);
+
 private:
+  struct TensorScope;
+
+  // The open scope named by a store call, or nullptr for none. Throws std::invalid_argument for an unknown
+  // scope. Callers hold mutex_.
+  TensorScope *findScope(const std::string &scope_id);
+
+  // Storage for the data of a tensor created from Dart data: from the scope's arena, or the heap without a
+  // scope. Callers hold mutex_.
+  template <typename T> T *allocateData(TensorScope *scope, size_t count) {
+    if (scope != nullptr) {
+      return scope->arena.allocate<T>(count);
+    }
+    return new T[count];
+  }
+
+  // Account a tensor just stored under `tensor_id`, adding it to `scope` if not null. Callers hold mutex_.
+  void trackTensor(const std::string &tensor_id, TensorOrigin origin, TensorScope *scope = nullptr);
+
+  // Remove a tensor from the accounting. Callers hold mutex_.
+  void untrackTensor(const std::string &tensor_id);
+
+  // Mark a tensor as just used, moving it to the back of the eviction order. Callers hold mutex_.
+  void touchTensor(const std::string &tensor_id);
+
+  // Evict unpinned outputs until the budget holds, never `keep_id`, and raise warnings. Callers hold mutex_.
+  void enforceBudget(const std::string &keep_id);
+
+  // Accounting entry of a stored tensor
+  struct TrackedTensor {
+    std::string type;
+    TensorOrigin origin;
+    size_t bytes;
+    bool pinned;
+    // Tick of the last store or read, the key in evictable_
+    uint64_t last_used;
+  };
+
+  // Whether the budget may evict a tensor
+  static bool isEvictable(const TrackedTensor &tracked) {
+    return tracked.origin == TensorOrigin::output && !tracked.pinned;
+  }
+
   // Map of tensor IDs to OrtValue objects
   std::map<std::string, std::unique_ptr<Ort::Value>> tensors_;
 
@@ -98,8 +219,36 @@ private:
   // Map of tensor IDs to their shapes
   std::map<std::string, std::vector<int64_t>> tensor_shapes_;
 
+  // Accounting of the stored tensors, updated as they are stored and released
+  std::map<std::string, TrackedTensor> tracked_;
+  TensorMemoryStats memory_stats_;
+
+  // Evictable tensors by last use, oldest first
+  std::map<uint64_t, std::string> evictable_;
+  uint64_t use_tick_;
+
+  // Recently evicted IDs, oldest first, bounded so a leaking app does not grow them forever
+  std::deque<std::string> evicted_order_;
+  std::set<std::string> evicted_;
+
+  // Tensors of an open scope and the arena holding their buffers
+  struct TensorScope {
+    std::vector<std::string> tensor_ids;
+    ScopeArena arena;
+    // Scope that receives the kept tensors on release, empty at top level
+    std::string parent_id;
+  };
+  std::map<std::string, TensorScope> scopes_;
+  int next_scope_id_;
+
+  // Whether live tensors were past each limit at the last check, so each crossing warns once
+  bool over_soft_limit_;
+  bool over_budget_;
+  MemoryWarningCallback on_warning_;
+
   // Counter for generating unique tensor IDs
-  int next_tensor_id_;
+  // Atomic: IDs are also generated from pipeline worker threads
+  std::atomic<int> next_tensor_id_;
 
   // Mutex for thread safety
   std::mutex mutex_;
@@ -0,0 +1,513 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "tensor_ops.h"
+#include "session_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+Ort::Value allocateTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType type) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  return Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+}
+
+size_t checkedElementSize(ONNXTensorElementDataType type) {
+  size_t element_size = SessionManager::getElementSize(type);
+  if (element_size == 0) {
+    throw Ort::Exception(std::string("Unsupported tensor type: ") + SessionManager::getElementTypeString(type),
+                         ORT_INVALID_ARGUMENT);
+  }
+  return element_size;
+}
+
+// IEEE 754 half precision value, converted through float
+struct Half {
+  uint16_t bits;
+
+  Half() = default;
+  template <typename T> explicit Half(T value) : bits(fromFloat(static_cast<float>(value))) {}
+  template <typename T> explicit operator T() const { return static_cast<T>(toFloat(bits)); }
+
+  // Round to nearest even; out of range values become infinity
+  static uint16_t fromFloat(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    uint16_t sign = static_cast<uint16_t>((f >> 16) & 0x8000);
+    uint32_t abs = f & 0x7fffffff;
+    if (abs >= 0x7f800000) {
+      return sign | (abs > 0x7f800000 ? 0x7e00 : 0x7c00);
+    }
+    if (abs >= 0x477ff000) {
+      return sign | 0x7c00;
+    }
+    if (abs < 0x38800000) {
+      // Subnormal: shift the implicit bit in, then round
+      if (abs < 0x33000000) {
+        return sign;
+      }
+      uint32_t exponent = abs >> 23;
+      uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+      uint32_t shift = 126 - exponent;
+      uint32_t half_mantissa = mantissa >> shift;
+      uint32_t rest = mantissa & ((1u << shift) - 1);
+      uint32_t halfway = 1u << (shift - 1);
+      if (rest > halfway || (rest == halfway && (half_mantissa & 1))) {
+        half_mantissa++;
+      }
+      return sign | static_cast<uint16_t>(half_mantissa);
+    }
+    uint32_t rounded = abs - 0x38000000 + 0xfff + ((abs >> 13) & 1);
+    return sign | static_cast<uint16_t>(rounded >> 13);
+  }
+
+  static float toFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t f;
+    if (exponent == 0x1f) {
+      f = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+      f = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+      f = sign;
+    } else {
+      // Subnormal: normalize the mantissa
+      exponent = 113;
+      while ((mantissa & 0x400) == 0) {
+        mantissa <<= 1;
+        exponent--;
+      }
+      f = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+  }
+};
+
+template <typename Src, typename Dst> void convertElements(const Src *src, Dst *dst, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    dst[i] = static_cast<Dst>(src[i]);
+  }
+}
+
+template <typename T> void fillMask(T *dst, size_t count, int64_t axis_size, int64_t inner, int64_t length) {
+  for (size_t i = 0; i < count; i++) {
+    int64_t position = (static_cast<int64_t>(i) / inner) % axis_size;
+    dst[i] = static_cast<T>(position < length ? 1 : 0);
+  }
+}
+
+// Convert every element of `tensor` into `dst`, dispatching on the source type
+template <typename Dst> void castInto(const Ort::Value &tensor, Dst *dst, size_t count) {
+  switch (tensor.GetTensorTypeAndShapeInfo().GetElementType()) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    return convertElements(tensor.GetTensorData<float>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    return convertElements(tensor.GetTensorData<double>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    return convertElements(tensor.GetTensorData<int8_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    return convertElements(tensor.GetTensorData<int16_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    return convertElements(tensor.GetTensorData<int32_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    return convertElements(tensor.GetTensorData<int64_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    return convertElements(tensor.GetTensorData<uint8_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    return convertElements(tensor.GetTensorData<uint16_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    return convertElements(tensor.GetTensorData<uint32_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    return convertElements(tensor.GetTensorData<uint64_t>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    return convertElements(tensor.GetTensorData<bool>(), dst, count);
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    return convertElements(tensor.GetTensorData<Half>(), dst, count);
+  default:
+    throw Ort::Exception("Unsupported source type for cast", ORT_INVALID_ARGUMENT);
+  }
+}
+
+// Convert every element of `tensor` into `dst`, which holds `count` elements of `target_type`
+void castToBuffer(const Ort::Value &tensor, ONNXTensorElementDataType target_type, void *dst, size_t count) {
+  switch (target_type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    castInto(tensor, static_cast<float *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    castInto(tensor, static_cast<double *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    castInto(tensor, static_cast<int8_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    castInto(tensor, static_cast<int16_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    castInto(tensor, static_cast<int32_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    castInto(tensor, static_cast<int64_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    castInto(tensor, static_cast<uint8_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    castInto(tensor, static_cast<uint16_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    castInto(tensor, static_cast<uint32_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    castInto(tensor, static_cast<uint64_t *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    castInto(tensor, static_cast<bool *>(dst), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    castInto(tensor, static_cast<Half *>(dst), count);
+    break;
+  default:
+    throw Ort::Exception("Unsupported target type for cast", ORT_INVALID_ARGUMENT);
+  }
+}
+
+template <typename T> T roundTo(float value) { return static_cast<T>(value); }
+template <> uint8_t roundTo<uint8_t>(float value) {
+  return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, std::round(value))));
+}
+
+template <typename T>
+void resizeBilinear(const T *src, T *dst, size_t planes, int64_t in_h, int64_t in_w, int64_t out_h, int64_t out_w) {
+  float scale_y = static_cast<float>(in_h) / out_h;
+  float scale_x = static_cast<float>(in_w) / out_w;
+
+  for (size_t plane = 0; plane < planes; plane++) {
+    const T *in = src + plane * in_h * in_w;
+    T *out = dst + plane * out_h * out_w;
+    for (int64_t y = 0; y < out_h; y++) {
+      float fy = std::max(0.0f, (y + 0.5f) * scale_y - 0.5f);
+      int64_t y0 = std::min(static_cast<int64_t>(fy), in_h - 1);
+      int64_t y1 = std::min(y0 + 1, in_h - 1);
+      float wy = fy - y0;
+      for (int64_t x = 0; x < out_w; x++) {
+        float fx = std::max(0.0f, (x + 0.5f) * scale_x - 0.5f);
+        int64_t x0 = std::min(static_cast<int64_t>(fx), in_w - 1);
+        int64_t x1 = std::min(x0 + 1, in_w - 1);
+        float wx = fx - x0;
+        float top = in[y0 * in_w + x0] * (1 - wx) + in[y0 * in_w + x1] * wx;
+        float bottom = in[y1 * in_w + x0] * (1 - wx) + in[y1 * in_w + x1] * wx;
+        out[y * out_w + x] = roundTo<T>(top * (1 - wy) + bottom * wy);
+      }
+    }
+  }
+}
+
+} // namespace
+
+ONNXTensorElementDataType elementTypeFromString(const std::string &type) {
+  static const std::vector<std::pair<std::string, ONNXTensorElementDataType>> types = {
+      {"float32", ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT}, {"float64", ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE},
+      {"int8", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8},     {"int16", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16},
+      {"int32", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32},   {"int64", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64},
+      {"uint8", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8},   {"uint16", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16},
+      {"uint32", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32}, {"uint64", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64},
+      {"float16", ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16}, {"bool", ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL}};
+
+  for (const auto &entry : types) {
+    if (entry.first == type) {
+      return entry.second;
+    }
+  }
+  throw Ort::Exception("Unsupported tensor type: " + type, ORT_INVALID_ARGUMENT);
+}
+
+size_t tensorByteSize(const Ort::Value &tensor) {
+  if (!tensor.IsTensor()) {
+    return 0;
+  }
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  if (info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    return tensor.GetStringTensorDataLength();
+  }
+  return info.GetElementCount() * SessionManager::getElementSize(info.GetElementType());
+}
+
+Ort::Value cloneValue(const Ort::Value &tensor) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  if (info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    std::vector<std::string> strings(info.GetElementCount());
+    std::vector<const char *> string_ptrs(strings.size());
+    for (size_t i = 0; i < strings.size(); i++) {
+      strings[i] = tensor.GetStringTensorElement(i);
+      string_ptrs[i] = strings[i].c_str();
+    }
+    Ort::Value copy = allocateTensor(info.GetShape(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+    Ort::ThrowOnError(Ort::GetApi().FillStringTensor(copy, string_ptrs.data(), string_ptrs.size()));
+    return copy;
+  }
+
+  size_t element_size = checkedElementSize(info.GetElementType());
+
+  Ort::Value copy = allocateTensor(info.GetShape(), info.GetElementType());
+  size_t byte_count = info.GetElementCount() * element_size;
+  if (byte_count > 0) {
+    std::memcpy(copy.GetTensorMutableRawData(), tensor.GetTensorRawData(), byte_count);
+  }
+  return copy;
+}
+
+Ort::Value viewValue(const Ort::Value &tensor) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  // String elements are not one flat buffer that a second tensor could share
+  if (info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    return cloneValue(tensor);
+  }
+  size_t element_size = checkedElementSize(info.GetElementType());
+  std::vector<int64_t> shape = info.GetShape();
+
+  return Ort::Value::CreateTensor(tensor.GetTensorMemoryInfo(), const_cast<void *>(tensor.GetTensorRawData()),
+                                  info.GetElementCount() * element_size, shape.data(), shape.size(),
+                                  info.GetElementType());
+}
+
+Ort::Value cropTensor(const Ort::Value &tensor, const std::vector<int64_t> &starts, const std::vector<int64_t> &ends) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType type = info.GetElementType();
+  size_t element_size = checkedElementSize(type);
+  std::vector<int64_t> shape = info.GetShape();
+
+  if (starts.size() != ends.size() || starts.size() > shape.size()) {
+    throw Ort::Exception("Crop needs matching starts and ends for at most every axis", ORT_INVALID_ARGUMENT);
+  }
+
+  size_t rank = shape.size();
+  if (rank == 0) {
+    return cloneValue(tensor);
+  }
+
+  // Normalise the range of every axis
+  std::vector<int64_t> begin(rank, 0);
+  std::vector<int64_t> out_shape = shape;
+  for (size_t axis = 0; axis < starts.size(); axis++) {
+    int64_t dim = shape[axis];
+    int64_t start = starts[axis] < 0 ? starts[axis] + dim : starts[axis];
+    int64_t end = ends[axis] < 0 ? ends[axis] + dim : ends[axis];
+    start = std::min(std::max<int64_t>(start, 0), dim);
+    end = std::min(std::max<int64_t>(end, start), dim);
+    begin[axis] = start;
+    out_shape[axis] = end - start;
+  }
+
+  Ort::Value result = allocateTensor(out_shape, type);
+  size_t out_count = result.GetTensorTypeAndShapeInfo().GetElementCount();
+  if (out_count == 0) {
+    return result;
+  }
+
+  // Copy contiguous rows of the innermost axis, walking the outer axes like an odometer
+  const uint8_t *src = static_cast<const uint8_t *>(tensor.GetTensorRawData());
+  uint8_t *dst = static_cast<uint8_t *>(result.GetTensorMutableRawData());
+  std::vector<int64_t> strides(rank, 1);
+  for (size_t axis = rank - 1; axis > 0; axis--) {
+    strides[axis - 1] = strides[axis] * shape[axis];
+  }
+
+  size_t row_bytes = out_shape[rank - 1] * element_size;
+  std::vector<int64_t> index(rank, 0);
+  while (true) {
+    int64_t offset = 0;
+    for (size_t axis = 0; axis < rank; axis++) {
+      offset += (begin[axis] + index[axis]) * strides[axis];
+    }
+    std::memcpy(dst, src + offset * element_size, row_bytes);
+    dst += row_bytes;
+
+    size_t axis = rank - 1;
+    while (axis > 0) {
+      if (++index[axis - 1] < out_shape[axis - 1]) {
+        break;
+      }
+      index[axis - 1] = 0;
+      axis--;
+    }
+    if (axis == 0) {
+      break;
+    }
+  }
+
+  return result;
+}
+
+Ort::Value padTensor(const Ort::Value &tensor, size_t axis, int64_t size) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType type = info.GetElementType();
+  size_t element_size = checkedElementSize(type);
+  std::vector<int64_t> shape = info.GetShape();
+
+  if (axis >= shape.size() || size < shape[axis]) {
+    throw Ort::Exception("Pad needs an existing axis and a size no smaller than it", ORT_INVALID_ARGUMENT);
+  }
+
+  std::vector<int64_t> out_shape = shape;
+  out_shape[axis] = size;
+  Ort::Value result = allocateTensor(out_shape, type);
+  size_t out_count = result.GetTensorTypeAndShapeInfo().GetElementCount();
+  if (out_count == 0) {
+    return result;
+  }
+
+  // Every block below `axis` is copied whole and followed by the zeros it grows by
+  int64_t outer = 1;
+  for (size_t i = 0; i < axis; i++) {
+    outer *= shape[i];
+  }
+  size_t in_block = info.GetElementCount() / outer * element_size;
+  size_t out_block = out_count / outer * element_size;
+
+  const uint8_t *src = static_cast<const uint8_t *>(tensor.GetTensorRawData());
+  uint8_t *dst = static_cast<uint8_t *>(result.GetTensorMutableRawData());
+  for (int64_t block = 0; block < outer; block++) {
+    std::memcpy(dst, src, in_block);
+    std::memset(dst + in_block, 0, out_block - in_block);
+    src += in_block;
+    dst += out_block;
+  }
+
+  return result;
+}
+
+Ort::Value maskTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType type, size_t axis, int64_t length) {
+  if (axis >= shape.size()) {
+    throw Ort::Exception("Mask axis is out of range", ORT_INVALID_ARGUMENT);
+  }
+
+  Ort::Value result = allocateTensor(shape, type);
+  size_t count = result.GetTensorTypeAndShapeInfo().GetElementCount();
+  int64_t inner = 1;
+  for (size_t i = axis + 1; i < shape.size(); i++) {
+    inner *= shape[i];
+  }
+  if (count == 0) {
+    return result;
+  }
+
+  switch (type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    fillMask(result.GetTensorMutableData<float>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    fillMask(result.GetTensorMutableData<double>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    fillMask(result.GetTensorMutableData<int8_t>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    fillMask(result.GetTensorMutableData<int32_t>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    fillMask(result.GetTensorMutableData<int64_t>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    fillMask(result.GetTensorMutableData<uint8_t>(), count, shape[axis], inner, length);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    fillMask(result.GetTensorMutableData<bool>(), count, shape[axis], inner, length);
+    break;
+  default:
+    throw Ort::Exception(std::string("Unsupported mask type: ") + SessionManager::getElementTypeString(type),
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  return result;
+}
+
+Ort::Value resizeTensor(const Ort::Value &tensor, int64_t height, int64_t width) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType type = info.GetElementType();
+  std::vector<int64_t> shape = info.GetShape();
+
+  if (shape.size() < 2 || height <= 0 || width <= 0) {
+    throw Ort::Exception("Resize needs a tensor of rank 2 or more and a positive size", ORT_INVALID_ARGUMENT);
+  }
+
+  int64_t in_h = shape[shape.size() - 2];
+  int64_t in_w = shape[shape.size() - 1];
+  std::vector<int64_t> out_shape = shape;
+  out_shape[shape.size() - 2] = height;
+  out_shape[shape.size() - 1] = width;
+
+  Ort::Value result = allocateTensor(out_shape, type);
+  if (in_h == 0 || in_w == 0) {
+    return result;
+  }
+  size_t planes = info.GetElementCount() / (in_h * in_w);
+
+  if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    resizeBilinear(tensor.GetTensorData<float>(), result.GetTensorMutableData<float>(), planes, in_h, in_w, height,
+                   width);
+  } else if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+    resizeBilinear(tensor.GetTensorData<uint8_t>(), result.GetTensorMutableData<uint8_t>(), planes, in_h, in_w,
+                   height, width);
+  } else {
+    throw Ort::Exception("Resize supports float32 and uint8 tensors only", ORT_INVALID_ARGUMENT);
+  }
+
+  return result;
+}
+
+bool isCastableType(ONNXTensorElementDataType type) {
+  switch (type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    return true;
+  default:
+    return false;
+  }
+}
+
+Ort::Value castTensor(const Ort::Value &tensor, ONNXTensorElementDataType target_type) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  if (info.GetElementType() == target_type) {
+    return cloneValue(tensor);
+  }
+
+  Ort::Value result = allocateTensor(info.GetShape(), target_type);
+  castToBuffer(tensor, target_type, result.GetTensorMutableRawData(), info.GetElementCount());
+  return result;
+}
+
+Ort::Value castTensorInto(const Ort::Value &tensor, ONNXTensorElementDataType target_type,
+                          std::vector<uint8_t> &buffer) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  size_t count = info.GetElementCount();
+  size_t byte_size = count * checkedElementSize(target_type);
+  // Never shrinks, so a buffer reused for inputs of one size stops allocating after the first call
+  if (buffer.size() < byte_size) {
+    buffer.resize(byte_size);
+  }
+  castToBuffer(tensor, target_type, buffer.data(), count);
+
+  std::vector<int64_t> shape = info.GetShape();
+  Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  return Ort::Value::CreateTensor(memory_info, buffer.data(), byte_size, shape.data(), shape.size(), target_type);
+}
@@ -0,0 +1,59 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef TENSOR_OPS_H
+#define TENSOR_OPS_H
+
+#include <cstdint>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+// Native tensor operations applied between models without a round trip to Dart.
+// Unless noted, they work on numeric tensors only and allocate the result with the default CPU allocator.
+
+// Parse a type name as used by the Dart API (e.g. "float32") to an element type.
+// Throws Ort::Exception for unknown or non-numeric names.
+ONNXTensorElementDataType elementTypeFromString(const std::string &type);
+
+// Bytes held by the data of a tensor; string tensors count their characters
+size_t tensorByteSize(const Ort::Value &tensor);
+
+// Deep copy of a tensor, string tensors included
+Ort::Value cloneValue(const Ort::Value &tensor);
+
+// Tensor sharing the buffer of `tensor` without copying it, for handing one input to several runs.
+// The view must not outlive `tensor` and must only be read. String tensors have no shareable buffer and
+// are copied instead.
+Ort::Value viewValue(const Ort::Value &tensor);
+
+// Slice a tensor to [starts[i], ends[i]) along each leading axis i; axes beyond the given ranges are kept
+// whole. Negative indices count from the end of the axis and out of range indices are clamped.
+Ort::Value cropTensor(const Ort::Value &tensor, const std::vector<int64_t> &starts, const std::vector<int64_t> &ends);
+
+// Grow `axis` of a tensor to `size` by appending zeros
+Ort::Value padTensor(const Ort::Value &tensor, size_t axis, int64_t size);
+
+// Tensor of the given shape holding 1 at positions below `length` along `axis` and 0 elsewhere, e.g. the
+// attention mask of a padded sequence
+Ort::Value maskTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType type, size_t axis, int64_t length);
+
+// Bilinearly resize the last two axes (height, width) of a float32 or uint8 tensor, sampling pixel centres
+Ort::Value resizeTensor(const Ort::Value &tensor, int64_t height, int64_t width);
+
+// Whether castTensor and castTensorInto convert from and to `type`: the numeric types and float16, but not
+// bfloat16 or the complex types
+bool isCastableType(ONNXTensorElementDataType type);
+
+// Convert a tensor to another numeric element type (float16 included)
+Ort::Value castTensor(const Ort::Value &tensor, ONNXTensorElementDataType target_type);
+
+// Convert a tensor like castTensor, but into `buffer`, which grows as needed and is never shrunk, so it can be
+// reused across calls. The result views the buffer: it must not outlive it or be used once the buffer is reused.
+Ort::Value castTensorInto(const Ort::Value &tensor, ONNXTensorElementDataType target_type,
+                          std::vector<uint8_t> &buffer);
+
+#endif // TENSOR_OPS_H
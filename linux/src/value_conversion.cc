@@ -5,6 +5,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "value_conversion.h"
+#include "session_manager.h"
+#include "tensor_ops.h"
+#include <algorithm>
 
 // Implementation of the vector_to_fl_value specialization for strings
 template <> FlValue *vector_to_fl_value<std::string>(const std::vector<std::string> &vec) {
@@ -93,4 +96,245 @@ std::map<std::string, FlValue *> fl_value_to_map(FlValue *map_value) {
   }
 
   return result;
-}
\ No newline at end of file
+}
+
+// Implementation of fl_value_to_int64_vector
+bool fl_value_to_int64_vector(FlValue *list_value, std::vector<int64_t> &out) {
+  out.clear();
+
+  if (list_value == nullptr) {
+    return false;
+  }
+
+  switch (fl_value_get_type(list_value)) {
+  case FL_VALUE_TYPE_INT64_LIST: {
+    const int64_t *data = fl_value_get_int64_list(list_value);
+    out.assign(data, data + fl_value_get_length(list_value));
+    return true;
+  }
+  case FL_VALUE_TYPE_INT32_LIST: {
+    const int32_t *data = fl_value_get_int32_list(list_value);
+    out.assign(data, data + fl_value_get_length(list_value));
+    return true;
+  }
+  case FL_VALUE_TYPE_LIST: {
+    size_t length = fl_value_get_length(list_value);
+    out.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+      FlValue *item = fl_value_get_list_value(list_value, i);
+      if (fl_value_get_type(item) != FL_VALUE_TYPE_INT) {
+        out.clear();
+        return false;
+      }
+      out.push_back(fl_value_get_int(item));
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// Implementation of fl_value_to_canonical_string
+std::string fl_value_to_canonical_string(FlValue *value) {
+  if (value == nullptr) {
+    return "null";
+  }
+
+  switch (fl_value_get_type(value)) {
+  case FL_VALUE_TYPE_MAP: {
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (size_t i = 0; i < fl_value_get_length(value); i++) {
+      entries.emplace_back(fl_value_to_canonical_string(fl_value_get_map_key(value, i)),
+                           fl_value_to_canonical_string(fl_value_get_map_value(value, i)));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::string result = "{";
+    for (const auto &entry : entries) {
+      result += entry.first + ":" + entry.second + ",";
+    }
+    return result + "}";
+  }
+  case FL_VALUE_TYPE_LIST: {
+    std::string result = "[";
+    for (size_t i = 0; i < fl_value_get_length(value); i++) {
+      result += fl_value_to_canonical_string(fl_value_get_list_value(value, i)) + ",";
+    }
+    return result + "]";
+  }
+  case FL_VALUE_TYPE_STRING:
+    // Quote strings so "1" and 1 differ
+    return std::string("\"") + fl_value_get_string(value) + "\"";
+  default: {
+    gchar *text = fl_value_to_string(value);
+    std::string result(text);
+    g_free(text);
+    return result;
+  }
+  }
+}
+
+namespace {
+
+// Tensor over the buffer of a typed list, or over a copy of a plain list of numbers
+template <typename T>
+Ort::Value numeric_tensor(FlValue *data, FlValueType typed_list_type, const T *typed_data,
+                          const std::vector<int64_t> &shape, size_t element_count) {
+  Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+  if (fl_value_get_type(data) == typed_list_type) {
+    if (fl_value_get_length(data) != element_count) {
+      throw Ort::Exception("Data length does not match the shape", ORT_INVALID_ARGUMENT);
+    }
+    return Ort::Value::CreateTensor<T>(memory_info, const_cast<T *>(typed_data), element_count, shape.data(),
+                                       shape.size());
+  }
+
+  if (fl_value_get_type(data) != FL_VALUE_TYPE_LIST || fl_value_get_length(data) != element_count) {
+    throw Ort::Exception("Data must be a list of numbers matching the shape", ORT_INVALID_ARGUMENT);
+  }
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value tensor = Ort::Value::CreateTensor<T>(allocator, shape.data(), shape.size());
+  T *out = tensor.GetTensorMutableData<T>();
+  for (size_t i = 0; i < element_count; i++) {
+    FlValue *item = fl_value_get_list_value(data, i);
+    if (fl_value_get_type(item) == FL_VALUE_TYPE_INT) {
+      out[i] = static_cast<T>(fl_value_get_int(item));
+    } else if (fl_value_get_type(item) == FL_VALUE_TYPE_FLOAT) {
+      out[i] = static_cast<T>(fl_value_get_float(item));
+    } else {
+      throw Ort::Exception("Data must be a list of numbers matching the shape", ORT_INVALID_ARGUMENT);
+    }
+  }
+  return tensor;
+}
+
+} // namespace
+
+// Implementation of fl_value_to_tensor
+Ort::Value fl_value_to_tensor(FlValue *data, const std::string &type, const std::vector<int64_t> &shape) {
+  if (data == nullptr) {
+    throw Ort::Exception("Tensor data cannot be null", ORT_INVALID_ARGUMENT);
+  }
+
+  size_t element_count = 1;
+  for (int64_t dim : shape) {
+    if (dim < 0) {
+      throw Ort::Exception("Shape must not contain negative dimensions", ORT_INVALID_ARGUMENT);
+    }
+    element_count *= static_cast<size_t>(dim);
+  }
+
+  FlValueType data_type = fl_value_get_type(data);
+  if (type == "float32") {
+    const float *typed = data_type == FL_VALUE_TYPE_FLOAT32_LIST ? fl_value_get_float32_list(data) : nullptr;
+    return numeric_tensor<float>(data, FL_VALUE_TYPE_FLOAT32_LIST, typed, shape, element_count);
+  }
+  if (type == "int32") {
+    const int32_t *typed = data_type == FL_VALUE_TYPE_INT32_LIST ? fl_value_get_int32_list(data) : nullptr;
+    return numeric_tensor<int32_t>(data, FL_VALUE_TYPE_INT32_LIST, typed, shape, element_count);
+  }
+  if (type == "int64") {
+    const int64_t *typed = data_type == FL_VALUE_TYPE_INT64_LIST ? fl_value_get_int64_list(data) : nullptr;
+    return numeric_tensor<int64_t>(data, FL_VALUE_TYPE_INT64_LIST, typed, shape, element_count);
+  }
+  if (type == "uint8") {
+    const uint8_t *typed = data_type == FL_VALUE_TYPE_UINT8_LIST ? fl_value_get_uint8_list(data) : nullptr;
+    return numeric_tensor<uint8_t>(data, FL_VALUE_TYPE_UINT8_LIST, typed, shape, element_count);
+  }
+
+  if (data_type != FL_VALUE_TYPE_LIST || fl_value_get_length(data) != element_count) {
+    throw Ort::Exception("Data must be a list matching the shape", ORT_INVALID_ARGUMENT);
+  }
+  Ort::AllocatorWithDefaultOptions allocator;
+
+  if (type == "bool") {
+    Ort::Value tensor = Ort::Value::CreateTensor<bool>(allocator, shape.data(), shape.size());
+    bool *out = tensor.GetTensorMutableData<bool>();
+    for (size_t i = 0; i < element_count; i++) {
+      FlValue *item = fl_value_get_list_value(data, i);
+      if (fl_value_get_type(item) != FL_VALUE_TYPE_BOOL) {
+        throw Ort::Exception("Data must be a list of booleans for bool type", ORT_INVALID_ARGUMENT);
+      }
+      out[i] = fl_value_get_bool(item);
+    }
+    return tensor;
+  }
+  if (type == "string") {
+    std::vector<const char *> strings;
+    strings.reserve(element_count);
+    for (size_t i = 0; i < element_count; i++) {
+      FlValue *item = fl_value_get_list_value(data, i);
+      if (fl_value_get_type(item) != FL_VALUE_TYPE_STRING) {
+        throw Ort::Exception("Data must be a list of strings for string type", ORT_INVALID_ARGUMENT);
+      }
+      strings.push_back(fl_value_get_string(item));
+    }
+    Ort::Value tensor =
+        Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+    Ort::ThrowOnError(Ort::GetApi().FillStringTensor(tensor, strings.data(), strings.size()));
+    return tensor;
+  }
+
+  throw Ort::Exception("Unsupported source data type: " + type, ORT_INVALID_ARGUMENT);
+}
+
+// Implementation of tensor_to_fl_value
+FlValue *tensor_to_fl_value(const Ort::Value &tensor) {
+  auto info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType element_type = info.GetElementType();
+  std::vector<int64_t> shape = info.GetShape();
+  size_t count = info.GetElementCount();
+
+  FlValue *data = nullptr;
+  switch (element_type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    data = fl_value_new_float32_list(tensor.GetTensorData<float>(), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    data = fl_value_new_int32_list(tensor.GetTensorData<int32_t>(), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    data = fl_value_new_int64_list(tensor.GetTensorData<int64_t>(), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    data = fl_value_new_uint8_list(tensor.GetTensorData<uint8_t>(), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    data = fl_value_new_float_list(tensor.GetTensorData<double>(), count);
+    break;
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: {
+    Ort::Value widened = castTensor(tensor, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+    data = fl_value_new_int64_list(widened.GetTensorData<int64_t>(), count);
+    break;
+  }
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: {
+    const bool *values = tensor.GetTensorData<bool>();
+    data = fl_value_new_list();
+    for (size_t i = 0; i < count; i++) {
+      fl_value_append_take(data, fl_value_new_bool(values[i]));
+    }
+    break;
+  }
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING:
+    data = fl_value_new_list();
+    for (size_t i = 0; i < count; i++) {
+      fl_value_append_take(data, fl_value_new_string(tensor.GetStringTensorElement(i).c_str()));
+    }
+    break;
+  default:
+    throw Ort::Exception(std::string("Unsupported output type: ") + SessionManager::getElementTypeString(element_type),
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "dataType", fl_value_new_string(SessionManager::getElementTypeString(element_type)));
+  fl_value_set_string_take(result, "shape", vector_to_fl_value(shape));
+  fl_value_set_string_take(result, "data", data);
+  return result;
+}
@@ -9,6 +9,7 @@
 
 #include <flutter_linux/flutter_linux.h>
 #include <map>
+#include <onnxruntime_cxx_api.h>
 #include <string>
 #include <vector>
 
@@ -39,4 +40,21 @@ template <> FlValue *vector_to_fl_value<bool>(const std::vector<bool> &vec);
 // Convert a FlValue map to a C++ map
 std::map<std::string, FlValue *> fl_value_to_map(FlValue *map_value);
 
+// Convert a FlValue list of integers (or an Int32List/Int64List) to a C++ vector of int64_t.
+// Returns false if the value is not a list of integers.
+bool fl_value_to_int64_vector(FlValue *list_value, std::vector<int64_t> &out);
+
+// Serialize a FlValue with map entries sorted by key, so equal values give equal strings
+// regardless of the order Dart inserted the keys in
+std::string fl_value_to_canonical_string(FlValue *value);
+
+// Wrap Dart data in a tensor of `type` ("float32", "int32", "int64", "uint8", "bool" or "string").
+// A typed list of the matching type is used in place without a copy, so the tensor must only be read and
+// must not outlive `data`; any other list is copied. Throws Ort::Exception if the data does not fit.
+Ort::Value fl_value_to_tensor(FlValue *data, const std::string &type, const std::vector<int64_t> &shape);
+
+// Serialize a tensor to a map with "dataType", "shape" and "data". Numeric data is copied once into a typed
+// list; smaller integer types widen to int64 and float64 stays a float list.
+FlValue *tensor_to_fl_value(const Ort::Value &tensor);
+
 #endif // VALUE_CONVERSION_H
\ No newline at end of file
@@ -0,0 +1,81 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "worker_pool.h"
+#include <algorithm>
+#include <atomic>
+
+WorkerPool::WorkerPool(size_t num_threads) : stopping_(false) {
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&WorkerPool::workerLoop, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)> &fn) {
+  if (count == 0) {
+    return;
+  }
+
+  // Pool threads and the caller pull indices from a shared counter until none are left
+  std::atomic<size_t> next_index{0};
+  auto drain = [&next_index, count, &fn]() {
+    size_t index;
+    while ((index = next_index++) < count) {
+      fn(index);
+    }
+  };
+
+  size_t helpers = std::min(count - 1, threads_.size());
+  size_t finished_helpers = 0;
+  std::mutex done_mutex;
+  std::condition_variable done;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < helpers; i++) {
+      tasks_.push_back([&drain, &finished_helpers, &done_mutex, &done]() {
+        drain();
+        std::lock_guard<std::mutex> done_lock(done_mutex);
+        finished_helpers++;
+        done.notify_one();
+      });
+    }
+  }
+  task_available_.notify_all();
+
+  drain();
+
+  // The helpers reference this frame, so wait for every one of them, even those that found no work
+  std::unique_lock<std::mutex> done_lock(done_mutex);
+  done.wait(done_lock, [&finished_helpers, helpers] { return finished_helpers == helpers; });
+}
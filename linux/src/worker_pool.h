@@ -0,0 +1,38 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads for running independent jobs side by side (e.g. several sessions on one input)
+class WorkerPool {
+public:
+  explicit WorkerPool(size_t num_threads);
+  ~WorkerPool();
+
+  // Call fn(0) .. fn(count - 1) spread over the pool and the calling thread, and return once all calls
+  // have finished. fn must not throw; callers record failures per index instead.
+  void parallelFor(size_t count, const std::function<void(size_t)> &fn);
+
+private:
+  void workerLoop();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  bool stopping_;
+};
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,121 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include "src/session_manager.h"
+#include "src/tensor_ops.h"
+
+namespace {
+
+// Model with input_ids and attention_mask of shape [batch, seq] and a hidden output of [batch, seq, hidden].
+// Only the introspection bucketing reads is filled in; there is no ONNX Runtime session.
+ModelEntry makeModel() {
+  ModelEntry model;
+  model.input_names = {"input_ids", "attention_mask"};
+  model.output_names = {"hidden"};
+  model.input_index = {{"input_ids", 0}, {"attention_mask", 1}};
+  model.output_index = {{"hidden", 0}};
+  model.input_info = {{"input_ids", "int64", {-1, -1}}, {"attention_mask", "int64", {-1, -1}}};
+  model.input_dim_names = {{"batch", "seq"}, {"batch", "seq"}};
+  model.output_dim_names = {{"batch", "seq", "hidden"}};
+  return model;
+}
+
+BucketingConfig makeConfig(const std::string &mask_input) {
+  BucketingConfig config;
+  config.dim = "seq";
+  config.buckets = {4, 8};
+  config.mask_input = mask_input;
+  config.mask_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64;
+  config.mask_axis = 1;
+  return config;
+}
+
+Ort::Value makeTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType type) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  return Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+}
+
+// Tensor of `shape` holding 1, 2, 3, ... in row-major order
+template <typename T> Ort::Value makeSequence(const std::vector<int64_t> &shape, ONNXTensorElementDataType type) {
+  Ort::Value tensor = makeTensor(shape, type);
+  T *data = tensor.GetTensorMutableData<T>();
+  for (size_t i = 0; i < tensor.GetTensorTypeAndShapeInfo().GetElementCount(); i++) {
+    data[i] = static_cast<T>(i + 1);
+  }
+  return tensor;
+}
+
+template <typename T> std::vector<T> values(const Ort::Value &tensor) {
+  const T *data = tensor.GetTensorData<T>();
+  return std::vector<T>(data, data + tensor.GetTensorTypeAndShapeInfo().GetElementCount());
+}
+
+} // namespace
+
+// Inputs are padded with zeros along the bucketed axis, which is not the leading one, and outputs cropped
+// back give exactly the unpadded data.
+TEST(Bucketing, PadThenCropRestoresNonLeadingAxis) {
+  ModelEntry model = makeModel();
+  BucketingConfig config = makeConfig("");
+  std::vector<std::string> names = {"input_ids"};
+  std::vector<Ort::Value> tensors;
+  tensors.push_back(makeSequence<int64_t>({2, 3}, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64));
+
+  ASSERT_EQ(applyBucketing(config, model, names, tensors), 3);
+  ASSERT_EQ(names.size(), 1u);
+  EXPECT_EQ(tensors[0].GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{2, 4}));
+  EXPECT_EQ(values<int64_t>(tensors[0]), (std::vector<int64_t>{1, 2, 3, 0, 4, 5, 6, 0}));
+
+  // Stand in for the run: an output with the padded axis in the middle, as a model would return it
+  Ort::Value original = makeSequence<float>({2, 3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  NamedTensors outputs;
+  outputs.emplace_back("hidden", padTensor(original, 1, 4));
+  EXPECT_EQ(outputs[0].second.GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{2, 4, 2}));
+
+  cropBucketedOutputs(config, model, outputs, 3);
+  EXPECT_EQ(outputs[0].second.GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{2, 3, 2}));
+  EXPECT_EQ(values<float>(outputs[0].second), values<float>(original));
+}
+
+// The generated mask has the model's mask type, the bucket size on the mask axis, and ones exactly below the
+// unpadded length.
+TEST(Bucketing, GeneratedMaskHasOnesBelowLength) {
+  ModelEntry model = makeModel();
+  BucketingConfig config = makeConfig("attention_mask");
+  std::vector<std::string> names = {"input_ids"};
+  std::vector<Ort::Value> tensors;
+  tensors.push_back(makeSequence<int64_t>({2, 5}, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64));
+
+  ASSERT_EQ(applyBucketing(config, model, names, tensors), 5);
+  ASSERT_EQ(names, (std::vector<std::string>{"input_ids", "attention_mask"}));
+  auto mask_info = tensors[1].GetTensorTypeAndShapeInfo();
+  EXPECT_EQ(mask_info.GetElementType(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+  EXPECT_EQ(mask_info.GetShape(), (std::vector<int64_t>{2, 8}));
+  EXPECT_EQ(values<int64_t>(tensors[1]), (std::vector<int64_t>{1, 1, 1, 1, 1, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0}));
+}
+
+// maskTensor marks positions along a middle axis, whatever the axes around it hold.
+TEST(Bucketing, MaskTensorOnMiddleAxis) {
+  Ort::Value mask = maskTensor({2, 3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, 1, 2);
+  EXPECT_EQ(values<float>(mask), (std::vector<float>{1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0}));
+}
+
+// Inputs longer than the largest bucket run as they are, without a generated mask.
+TEST(Bucketing, LongerThanLargestBucketStaysUnpadded) {
+  ModelEntry model = makeModel();
+  BucketingConfig config = makeConfig("attention_mask");
+  std::vector<std::string> names = {"input_ids"};
+  std::vector<Ort::Value> tensors;
+  tensors.push_back(makeSequence<int64_t>({1, 9}, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64));
+
+  EXPECT_EQ(applyBucketing(config, model, names, tensors), -1);
+  EXPECT_EQ(names.size(), 1u);
+  EXPECT_EQ(tensors.size(), 1u);
+  EXPECT_EQ(tensors[0].GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{1, 9}));
+  EXPECT_EQ(values<int64_t>(tensors[0]).back(), 9);
+}
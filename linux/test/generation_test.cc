@@ -0,0 +1,105 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <set>
+
+#include "src/generation.h"
+
+namespace {
+
+GenerationConfig makeConfig(float temperature, int64_t top_k, float top_p, uint64_t seed = 7) {
+  GenerationConfig config;
+  config.temperature = temperature;
+  config.top_k = top_k;
+  config.top_p = top_p;
+  config.seed = seed;
+  return config;
+}
+
+// Logits whose softmax is `probabilities`
+std::vector<float> logitsOf(const std::vector<float> &probabilities) {
+  std::vector<float> logits;
+  for (float probability : probabilities) {
+    logits.push_back(std::log(probability));
+  }
+  return logits;
+}
+
+// Tokens drawn in `draws` samples
+std::set<int64_t> sampledTokens(TokenSampler &sampler, const std::vector<float> &logits, int draws) {
+  std::set<int64_t> tokens;
+  for (int i = 0; i < draws; i++) {
+    tokens.insert(sampler.sample(logits.data(), logits.size()));
+  }
+  return tokens;
+}
+
+} // namespace
+
+// A temperature of 0 always picks the highest logit, the first one on a tie.
+TEST(TokenSampler, GreedyPicksArgmax) {
+  TokenSampler sampler(makeConfig(0.0f, 0, 1.0f));
+  std::vector<float> logits = {0.1f, 2.5f, -1.0f, 2.4f};
+  EXPECT_EQ(sampler.sample(logits.data(), logits.size()), 1);
+
+  std::vector<float> tied = {1.0f, 3.0f, 3.0f};
+  EXPECT_EQ(sampler.sample(tied.data(), tied.size()), 1);
+
+  std::vector<float> empty;
+  EXPECT_THROW(sampler.sample(empty.data(), 0), Ort::Exception);
+}
+
+// Keeping only the top candidate leaves nothing to sample from, so it matches greedy decoding at any
+// temperature and seed.
+TEST(TokenSampler, TopKOneEqualsGreedy) {
+  std::vector<float> logits = {0.3f, 1.2f, 1.1f, -0.5f, 0.9f};
+  for (uint64_t seed = 0; seed < 8; seed++) {
+    TokenSampler greedy(makeConfig(0.0f, 0, 1.0f, seed));
+    TokenSampler top_one(makeConfig(1.5f, 1, 1.0f, seed));
+    for (int i = 0; i < 50; i++) {
+      EXPECT_EQ(top_one.sample(logits.data(), logits.size()), greedy.sample(logits.data(), logits.size()));
+    }
+  }
+}
+
+// Top-k samples only among the k highest logits, and all of them come up.
+TEST(TokenSampler, TopKSamplesAmongHighest) {
+  TokenSampler sampler(makeConfig(1.0f, 2, 1.0f));
+  std::vector<float> logits = logitsOf({0.1f, 0.4f, 0.2f, 0.3f});
+  EXPECT_EQ(sampledTokens(sampler, logits, 2000), (std::set<int64_t>{1, 3}));
+}
+
+// Top-p keeps the most likely tokens up to the smallest set whose mass reaches p, and nothing beyond it.
+TEST(TokenSampler, TopPKeepsSmallestSetReachingMass) {
+  std::vector<float> logits = logitsOf({0.05f, 0.5f, 0.15f, 0.3f});
+
+  TokenSampler one(makeConfig(1.0f, 0, 0.4f));
+  EXPECT_EQ(sampledTokens(one, logits, 2000), (std::set<int64_t>{1}));
+
+  TokenSampler two(makeConfig(1.0f, 0, 0.75f));
+  EXPECT_EQ(sampledTokens(two, logits, 2000), (std::set<int64_t>{1, 3}));
+
+  TokenSampler three(makeConfig(1.0f, 0, 0.9f));
+  EXPECT_EQ(sampledTokens(three, logits, 4000), (std::set<int64_t>{1, 2, 3}));
+}
+
+// The same seed draws the same tokens, and a low temperature concentrates on the highest logit.
+TEST(TokenSampler, SeededAndTemperatureScaled) {
+  std::vector<float> logits = logitsOf({0.25f, 0.25f, 0.3f, 0.2f});
+  TokenSampler first(makeConfig(1.0f, 0, 1.0f, 42));
+  TokenSampler second(makeConfig(1.0f, 0, 1.0f, 42));
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(first.sample(logits.data(), logits.size()), second.sample(logits.data(), logits.size()));
+  }
+
+  TokenSampler cold(makeConfig(0.01f, 0, 1.0f));
+  EXPECT_EQ(sampledTokens(cold, logits, 500), (std::set<int64_t>{2}));
+  TokenSampler warm(makeConfig(1.0f, 0, 1.0f));
+  EXPECT_EQ(sampledTokens(warm, logits, 2000), (std::set<int64_t>{0, 1, 2, 3}));
+}
@@ -0,0 +1,115 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include "src/result_cache.h"
+
+namespace {
+
+// Run outputs holding a single float32 tensor of `values` under the name "y"
+NamedTensors makeOutputs(const std::vector<float> &values) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<int64_t> shape = {static_cast<int64_t>(values.size())};
+  Ort::Value tensor = Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  std::copy(values.begin(), values.end(), tensor.GetTensorMutableData<float>());
+  NamedTensors outputs;
+  outputs.emplace_back("y", std::move(tensor));
+  return outputs;
+}
+
+// First element of the output a lookup of `key` served, or -1 on a miss
+float lookupFirst(ResultCache &cache, const std::string &key) {
+  NamedTensors outputs;
+  if (!cache.lookup(key, outputs)) {
+    return -1;
+  }
+  return outputs.at(0).second.GetTensorData<float>()[0];
+}
+
+uint64_t collidingHash(const std::string &) { return 42; }
+
+} // namespace
+
+// Keys sharing a hash are told apart by the full key, so neither serves the other's outputs.
+TEST(ResultCache, HashCollisionDoesNotCrossServe) {
+  ResultCache cache(8, 0, collidingHash);
+  cache.insert("first", makeOutputs({1}));
+  cache.insert("second", makeOutputs({2}));
+
+  EXPECT_EQ(lookupFirst(cache, "first"), 1);
+  EXPECT_EQ(lookupFirst(cache, "second"), 2);
+  EXPECT_EQ(lookupFirst(cache, "third"), -1);
+  EXPECT_EQ(cache.getStats().entries, 2u);
+}
+
+// Once max_entries is reached, the least recently used entry goes first; a lookup counts as a use.
+TEST(ResultCache, EvictsLeastRecentlyUsedAtMaxEntries) {
+  ResultCache cache(2, 0);
+  cache.insert("a", makeOutputs({1}));
+  cache.insert("b", makeOutputs({2}));
+  EXPECT_EQ(lookupFirst(cache, "a"), 1);
+  cache.insert("c", makeOutputs({3}));
+
+  EXPECT_EQ(lookupFirst(cache, "b"), -1);
+  EXPECT_EQ(lookupFirst(cache, "a"), 1);
+  EXPECT_EQ(lookupFirst(cache, "c"), 3);
+  EXPECT_EQ(cache.getStats().evictions, 1u);
+}
+
+// The byte limit counts keys and outputs; entries are evicted oldest first until a new one fits, and an
+// entry larger than the limit on its own is not stored.
+TEST(ResultCache, EvictsLeastRecentlyUsedAtMaxBytes) {
+  // Every entry below is a 1-byte key plus four floats: 17 bytes
+  ResultCache cache(16, 40);
+  cache.insert("a", makeOutputs({1, 0, 0, 0}));
+  cache.insert("b", makeOutputs({2, 0, 0, 0}));
+  EXPECT_EQ(lookupFirst(cache, "a"), 1);
+  cache.insert("c", makeOutputs({3, 0, 0, 0}));
+
+  EXPECT_EQ(lookupFirst(cache, "b"), -1);
+  EXPECT_EQ(lookupFirst(cache, "a"), 1);
+  EXPECT_EQ(lookupFirst(cache, "c"), 3);
+  EXPECT_EQ(cache.getStats().bytes, 34u);
+
+  cache.insert("d", makeOutputs(std::vector<float>(16, 4)));
+  EXPECT_EQ(lookupFirst(cache, "d"), -1);
+  EXPECT_EQ(cache.getStats().entries, 2u);
+}
+
+// Output names and adapter IDs are appended under different tags, so the same strings in either list, or
+// the same characters split differently, give different keys.
+TEST(ResultCache, OutputNamesAndAdapterIdsKeyApart) {
+  std::string outputs_key;
+  ResultCache::appendOutputNames(outputs_key, {"x"});
+  std::string adapters_key;
+  ResultCache::appendAdapterIds(adapters_key, {"x"});
+  EXPECT_NE(outputs_key, adapters_key);
+
+  std::string empty_outputs_key;
+  ResultCache::appendOutputNames(empty_outputs_key, {});
+  std::string empty_adapters_key;
+  ResultCache::appendAdapterIds(empty_adapters_key, {});
+  EXPECT_NE(empty_outputs_key, empty_adapters_key);
+
+  std::string joined_key;
+  ResultCache::appendOutputNames(joined_key, {"ab"});
+  std::string split_key;
+  ResultCache::appendOutputNames(split_key, {"a", "b"});
+  EXPECT_NE(joined_key, split_key);
+
+  // Outputs then adapters must not match adapters then outputs
+  std::string ordered_key = outputs_key;
+  ResultCache::appendAdapterIds(ordered_key, {"y"});
+  std::string swapped_key;
+  ResultCache::appendAdapterIds(swapped_key, {"y"});
+  ResultCache::appendOutputNames(swapped_key, {"x"});
+  EXPECT_NE(ordered_key, swapped_key);
+
+  ResultCache cache(8, 0);
+  cache.insert(outputs_key, makeOutputs({1}));
+  EXPECT_EQ(lookupFirst(cache, adapters_key), -1);
+}
@@ -0,0 +1,26 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include "src/scope_arena.h"
+
+// Every allocation is 64-byte aligned, not just the first one in a block, whatever sizes came before it
+// and across block boundaries.
+TEST(ScopeArena, EveryAllocationIsAligned) {
+  ScopeArena arena;
+  for (size_t count = 1; count < 3000; count += 37) {
+    uint8_t *bytes = arena.allocate<uint8_t>(count);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(bytes) % 64, 0u) << "allocation of " << count << " bytes";
+    EXPECT_TRUE(arena.owns(bytes));
+    EXPECT_TRUE(arena.owns(bytes + count - 1));
+  }
+
+  float *large = arena.allocate<float>(100000);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0u);
+  int stack_value = 0;
+  EXPECT_FALSE(arena.owns(&stack_value));
+}
@@ -0,0 +1,162 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "src/tensor_ops.h"
+
+namespace {
+
+Ort::Value makeTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType type) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  return Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+}
+
+Ort::Value makeFloatTensor(const std::vector<int64_t> &shape, const std::vector<float> &values) {
+  Ort::Value tensor = makeTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  std::copy(values.begin(), values.end(), tensor.GetTensorMutableData<float>());
+  return tensor;
+}
+
+// Bits of `value` converted to float16
+uint16_t toHalfBits(float value) {
+  Ort::Value half = castTensor(makeFloatTensor({1}, {value}), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+  uint16_t bits;
+  std::memcpy(&bits, half.GetTensorRawData(), sizeof(bits));
+  return bits;
+}
+
+// Float value of the float16 with `bits`
+float fromHalfBits(uint16_t bits) {
+  Ort::Value half = makeTensor({1}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+  std::memcpy(half.GetTensorMutableRawData(), &bits, sizeof(bits));
+  return castTensor(half, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT).GetTensorData<float>()[0];
+}
+
+} // namespace
+
+// A numeric view shares the buffer; a string tensor has none to share and is copied element by element.
+TEST(TensorOps, ViewValueSharesNumericAndCopiesStrings) {
+  Ort::Value numeric = makeFloatTensor({2}, {1, 2});
+  Ort::Value view = viewValue(numeric);
+  EXPECT_EQ(view.GetTensorRawData(), numeric.GetTensorRawData());
+
+  std::vector<int64_t> shape = {2};
+  Ort::Value strings = makeTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  const char *elements[] = {"first", "second"};
+  Ort::ThrowOnError(Ort::GetApi().FillStringTensor(strings, elements, 2));
+
+  Ort::Value copy = viewValue(strings);
+  auto info = copy.GetTensorTypeAndShapeInfo();
+  EXPECT_EQ(info.GetElementType(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  EXPECT_EQ(info.GetShape(), shape);
+  EXPECT_EQ(copy.GetStringTensorElement(0), "first");
+  EXPECT_EQ(copy.GetStringTensorElement(1), "second");
+}
+
+// Values halfway between two float16 values round to the one with an even mantissa.
+TEST(TensorOps, Float16RoundsTiesToEven) {
+  EXPECT_EQ(toHalfBits(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+  EXPECT_EQ(toHalfBits(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+  EXPECT_EQ(toHalfBits(-(1.0f + std::ldexp(1.0f, -11))), 0xbc00);
+  // Just above a tie rounds up
+  EXPECT_EQ(toHalfBits(std::nextafter(1.0f + std::ldexp(1.0f, -11), 2.0f)), 0x3c01);
+}
+
+// Values below the smallest normal become subnormals, rounded to nearest even, and convert back exactly.
+TEST(TensorOps, Float16Subnormals) {
+  EXPECT_EQ(toHalfBits(std::ldexp(1.0f, -24)), 0x0001);
+  EXPECT_EQ(toHalfBits(1023 * std::ldexp(1.0f, -24)), 0x03ff);
+  EXPECT_EQ(toHalfBits(std::ldexp(1.0f, -25)), 0x0000);
+  EXPECT_EQ(toHalfBits(3 * std::ldexp(1.0f, -25)), 0x0002);
+  EXPECT_EQ(toHalfBits(std::ldexp(1.0f, -26)), 0x0000);
+  EXPECT_EQ(toHalfBits(-std::ldexp(1.0f, -24)), 0x8001);
+  // The largest subnormal rounds up into the smallest normal
+  EXPECT_EQ(toHalfBits(std::nextafter(std::ldexp(1.0f, -14), 0.0f)), 0x0400);
+
+  EXPECT_EQ(fromHalfBits(0x0001), std::ldexp(1.0f, -24));
+  EXPECT_EQ(fromHalfBits(0x03ff), 1023 * std::ldexp(1.0f, -24));
+}
+
+// Values beyond the float16 range become infinity; the largest finite value and its rounding band do not.
+TEST(TensorOps, Float16OverflowsToInfinity) {
+  EXPECT_EQ(toHalfBits(65504.0f), 0x7bff);
+  EXPECT_EQ(toHalfBits(65519.0f), 0x7bff);
+  EXPECT_EQ(toHalfBits(65520.0f), 0x7c00);
+  EXPECT_EQ(toHalfBits(1e6f), 0x7c00);
+  EXPECT_EQ(toHalfBits(-1e6f), 0xfc00);
+  EXPECT_EQ(toHalfBits(std::numeric_limits<float>::infinity()), 0x7c00);
+  EXPECT_EQ(fromHalfBits(0xfc00), -std::numeric_limits<float>::infinity());
+}
+
+// NaN stays NaN both ways.
+TEST(TensorOps, Float16KeepsNaN) {
+  uint16_t bits = toHalfBits(std::numeric_limits<float>::quiet_NaN());
+  EXPECT_EQ(bits & 0x7c00, 0x7c00);
+  EXPECT_NE(bits & 0x03ff, 0);
+  EXPECT_TRUE(std::isnan(fromHalfBits(0x7e00)));
+  EXPECT_TRUE(std::isnan(fromHalfBits(0xfc01)));
+}
+
+// Every float16 value other than NaN survives a round trip through float32 bit for bit.
+TEST(TensorOps, Float16RoundTripsEveryValue) {
+  Ort::Value half = makeTensor({65536}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+  uint16_t *bits = static_cast<uint16_t *>(half.GetTensorMutableRawData());
+  for (uint32_t i = 0; i < 65536; i++) {
+    bits[i] = static_cast<uint16_t>(i);
+  }
+
+  Ort::Value round_trip =
+      castTensor(castTensor(half, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+  const uint16_t *result = static_cast<const uint16_t *>(round_trip.GetTensorRawData());
+  for (uint32_t i = 0; i < 65536; i++) {
+    bool nan = (i & 0x7c00) == 0x7c00 && (i & 0x03ff) != 0;
+    if (!nan) {
+      ASSERT_EQ(result[i], i) << "float16 bits " << i;
+    }
+  }
+}
+
+// Only types the cast converts count as castable, so callers leave bfloat16 and complex tensors alone.
+TEST(TensorOps, CastableTypes) {
+  EXPECT_TRUE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16));
+  EXPECT_TRUE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL));
+  EXPECT_FALSE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16));
+  EXPECT_FALSE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64));
+  EXPECT_FALSE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128));
+  EXPECT_FALSE(isCastableType(ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING));
+
+  Ort::Value bfloat16 = makeTensor({1}, ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16);
+  EXPECT_THROW(castTensor(bfloat16, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT), Ort::Exception);
+}
+
+// castTensorInto writes into the caller's buffer and only grows it when a larger tensor comes in.
+TEST(TensorOps, CastTensorIntoReusesBuffer) {
+  std::vector<uint8_t> buffer;
+  Ort::Value first = castTensorInto(makeFloatTensor({4}, {1, 2, 3, 4}), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, buffer);
+  ASSERT_EQ(buffer.size(), 4 * sizeof(int64_t));
+  const uint8_t *data = buffer.data();
+  EXPECT_EQ(first.GetTensorRawData(), data);
+  EXPECT_EQ(first.GetTensorData<int64_t>()[3], 4);
+
+  Ort::Value same = castTensorInto(makeFloatTensor({2, 2}, {5, 6, 7, 8}), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, buffer);
+  EXPECT_EQ(buffer.data(), data);
+  EXPECT_EQ(same.GetTensorRawData(), data);
+  EXPECT_EQ(same.GetTensorData<int64_t>()[0], 5);
+
+  Ort::Value smaller = castTensorInto(makeFloatTensor({1}, {9}), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, buffer);
+  EXPECT_EQ(buffer.data(), data);
+  EXPECT_EQ(buffer.size(), 4 * sizeof(int64_t));
+  EXPECT_EQ(smaller.GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>{1});
+  EXPECT_EQ(smaller.GetTensorData<int64_t>()[0], 9);
+
+  castTensorInto(makeFloatTensor({8}, std::vector<float>(8, 1)), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, buffer);
+  EXPECT_EQ(buffer.size(), 8 * sizeof(int64_t));
+}
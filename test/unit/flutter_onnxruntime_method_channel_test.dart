@@ -14,6 +14,7 @@ void main() {
 
   late MethodChannelFlutterOnnxruntime platform;
   const MethodChannel channel = MethodChannel('flutter_onnxruntime');
+  const EventChannel eventChannel = EventChannel('flutter_onnxruntime/events');
 
   setUp(() {
     platform = MethodChannelFlutterOnnxruntime();
@@ -89,6 +90,7 @@ void main() {
 
   tearDown(() {
     TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, null);
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockStreamHandler(eventChannel, null);
   });
 
   group('Method channel tests', () {
@@ -294,5 +296,100 @@ void main() {
       expect(providers.length, 3);
       expect(providers, containsAll(['CPU', 'CUDA', 'CoreML']));
     });
+
+    test('setStateBindings sends session ID and bindings', () async {
+      Map<Object?, Object?>? capturedArgs;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        if (methodCall.method == 'setStateBindings') {
+          capturedArgs = methodCall.arguments as Map<Object?, Object?>;
+        }
+        return null;
+      });
+
+      await platform.setStateBindings('test_session_id', {'present': 'past'});
+
+      expect(capturedArgs, isNotNull);
+      expect(capturedArgs!['sessionId'], 'test_session_id');
+      expect(capturedArgs!['bindings'], {'present': 'past'});
+    });
+
+    test('runMany sends session IDs and shared inputs and returns one map per session', () async {
+      Map<Object?, Object?>? capturedArgs;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        if (methodCall.method == 'runMany') {
+          capturedArgs = methodCall.arguments as Map<Object?, Object?>;
+          return [
+            {
+              'age': [
+                'output_value_1',
+                'float32',
+                [1],
+              ],
+            },
+            {
+              'emotion': [
+                'output_value_2',
+                'float32',
+                [1, 7],
+              ],
+            },
+          ];
+        }
+        return null;
+      });
+
+      final input = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+      final results = await platform.runMany(['age_session', 'emotion_session'], {'image': input});
+
+      expect(capturedArgs!['sessionIds'], ['age_session', 'emotion_session']);
+      expect(capturedArgs!['inputs'], {
+        'image': {'valueId': 'test_value_1'},
+      });
+      expect(results.length, 2);
+      expect(results[0]['age'][0], 'output_value_1');
+      expect(results[1]['emotion'][2], [1, 7]);
+    });
+
+    test('generate streams tokens from the event channel without duplicates', () async {
+      MockStreamHandlerEventSink? eventSink;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockStreamHandler(
+        eventChannel,
+        MockStreamHandler.inline(onListen: (arguments, events) => eventSink = events),
+      );
+
+      Map<Object?, Object?>? capturedArgs;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        if (methodCall.method == 'generate') {
+          capturedArgs = methodCall.arguments as Map<Object?, Object?>;
+          final generationId = capturedArgs!['generationId'];
+          eventSink!.success({'event': 'generatedToken', 'generationId': generationId, 'token': 5, 'index': 0});
+          eventSink!.success({'event': 'generatedToken', 'generationId': 'other', 'token': 99, 'index': 0});
+          eventSink!.success({'event': 'generatedToken', 'generationId': generationId, 'token': 6, 'index': 1});
+          return {
+            'generationId': generationId,
+            'tokens': [5, 6, 2],
+            'stopReason': 'stopToken',
+          };
+        }
+        return null;
+      });
+
+      final tokens = await platform.generate('test_session_id', [1, 4], config: {'maxLength': 8}).toList();
+
+      expect(tokens, [5, 6, 2]);
+      expect(capturedArgs!['sessionId'], 'test_session_id');
+      expect(capturedArgs!['promptIds'], [1, 4]);
+      expect(capturedArgs!['config'], {'maxLength': 8});
+    });
   });
 }
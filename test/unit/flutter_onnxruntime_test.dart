@@ -4,13 +4,16 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_method_channel.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
-class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements FlutterOnnxruntimePlatform {
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
   @override
   Future<String?> getPlatformVersion() => Future.value('42');
 
@@ -23,12 +26,17 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     });
   }
 
+  String? lastRunScopeId;
+
   @override
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
+    lastRunScopeId = scopeId;
     // Return mock output with the same structure as expected from the real implementation
     return Future.value({
       'output1': [
@@ -92,10 +100,12 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) => Future.value({});
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) =>
+      Future.value({});
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) => Future.value({});
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) =>
+      Future.value({});
 
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) => Future.value({
@@ -106,8 +116,162 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<void> releaseOrtValue(String valueId) => Future.value();
 
+  final List<List<Object>> pinCalls = [];
+
+  @override
+  Future<void> pinOrtValue(String valueId, bool pinned) {
+    pinCalls.add([valueId, pinned]);
+    return Future.value();
+  }
+
+  int scopeCount = 0;
+  String? lastScopeParentId;
+  final List<List<Object>> releasedScopes = [];
+
+  @override
+  Future<Map<String, dynamic>> beginScope({String? parentId}) {
+    scopeCount++;
+    lastScopeParentId = parentId;
+    return Future.value({'scopeId': 'scope_$scopeCount'});
+  }
+
+  @override
+  Future<Map<String, dynamic>> releaseScope(String scopeId, {List<String> keep = const []}) {
+    releasedScopes.add([scopeId, keep]);
+    return Future.value({'released': 4});
+  }
+
+  int adapterCount = 0;
+  String? lastAdapterPath;
+  Uint8List? lastAdapterBytes;
+  final List<String> releasedAdapters = [];
+
+  @override
+  Future<Map<String, dynamic>> loadLoraAdapter({String? path, Uint8List? bytes}) {
+    adapterCount++;
+    lastAdapterPath = path;
+    lastAdapterBytes = bytes;
+    return Future.value({'adapterId': 'lora_adapter_$adapterCount'});
+  }
+
+  @override
+  Future<void> releaseLoraAdapter(String adapterId) {
+    releasedAdapters.add(adapterId);
+    return Future.value();
+  }
+
+  List<int>? lastTensorBudget;
+
+  @override
+  Future<void> configureTensorBudget(int budgetBytes, int softLimitBytes) {
+    lastTensorBudget = [budgetBytes, softLimitBytes];
+    return Future.value();
+  }
+
+  final StreamController<Map<String, dynamic>> eventController = StreamController<Map<String, dynamic>>.broadcast();
+
+  @override
+  Stream<Map<String, dynamic>> get events => eventController.stream;
+
   @override
   Future<List<String>> getAvailableProviders() => Future.value(['CPU']);
+
+  List<Map<String, dynamic>>? lastPreloadModels;
+
+  @override
+  Future<List<Map<String, dynamic>>> preloadSessions(List<Map<String, dynamic>> models) {
+    lastPreloadModels = models;
+    return Future.value([
+      for (var i = 0; i < models.length; i++)
+        {
+          'sessionId': 'session_$i',
+          'inputNames': ['input1'],
+          'outputNames': ['output1'],
+        },
+    ]);
+  }
+
+  List<Object?>? lastAutotune;
+
+  @override
+  Future<Map<String, dynamic>> autotuneSession(
+    String modelPath,
+    Map<String, OrtValue> inputs, {
+    required int budgetMs,
+    String objective = 'latency',
+    Map<String, dynamic>? sessionOptions,
+  }) {
+    lastAutotune = [modelPath, inputs.keys.toList(), budgetMs, objective, sessionOptions];
+    final sequential = {
+      'intraOpNumThreads': 4,
+      'interOpNumThreads': 1,
+      'parallelExecution': false,
+      'latencyMs': 2.5,
+      'runsPerSecond': 400.0,
+      'concurrency': 1,
+      'runs': 800,
+    };
+    return Future.value({
+      ...sequential,
+      'candidates': [
+        {
+          'intraOpNumThreads': 1,
+          'interOpNumThreads': 1,
+          'parallelExecution': false,
+          'latencyMs': 8.0,
+          'runsPerSecond': 125.0,
+          'concurrency': 1,
+          'runs': 250,
+        },
+        sequential,
+      ],
+    });
+  }
+
+  int? lastModelCacheBudget;
+
+  @override
+  Future<void> configureModelCache(int budgetBytes) {
+    lastModelCacheBudget = budgetBytes;
+    return Future.value();
+  }
+
+  @override
+  Future<Map<String, dynamic>> getModelCacheStats() {
+    return Future.value({'models': 2, 'idleModels': 1, 'bytes': 3000, 'budgetBytes': 4096, 'sharedLoads': 5});
+  }
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() {
+    return Future.value({
+      'tensors': {
+        'count': 3,
+        'bytes': 1200,
+        'peakCount': 5,
+        'peakBytes': 2000,
+        'byType': {
+          'float32': {'count': 2, 'bytes': 1192},
+          'int64': {'count': 1, 'bytes': 8},
+        },
+        'byOrigin': {
+          'user': {'count': 1, 'bytes': 8},
+          'output': {'count': 2, 'bytes': 1192},
+        },
+        'budgetBytes': 4096,
+        'softLimitBytes': 1024,
+        'evictions': 7,
+      },
+      'sessions': {
+        'session_1': {
+          'modelBytes': 3000,
+          'stateBytes': 64,
+          'resultCacheBytes': 0,
+          'allocator': {'InUse': 4096, 'MaxInUse': 8192},
+        },
+        'session_2': {'modelBytes': 3000, 'stateBytes': 0, 'resultCacheBytes': 0, 'allocator': null},
+      },
+    });
+  }
 }
 
 void main() {
@@ -165,6 +329,192 @@ void main() {
       expect(providers, isA<List<OrtProvider>>());
       expect(providers, contains(OrtProvider.CPU));
     });
+
+    test('preloadSessions loads all models with the shared options and keeps their order', () async {
+      final options = OrtSessionOptions(intraOpNumThreads: 2);
+
+      final sessions = await onnxRuntime.preloadSessions(['a.onnx', 'b.onnx'], options: options);
+
+      expect(mockPlatform.lastPreloadModels, [
+        {'modelPath': 'a.onnx', 'sessionOptions': options.toMap()},
+        {'modelPath': 'b.onnx', 'sessionOptions': options.toMap()},
+      ]);
+      expect(sessions.map((session) => session.id), ['session_0', 'session_1']);
+      expect(sessions[1].inputNames, ['input1']);
+    });
+
+    test('autotuneSession sends the budget and objective and parses the measurements', () async {
+      final input = OrtValue.fromMap({'valueId': 'value_1', 'dataType': 'float32', 'shape': [1, 3]});
+
+      final result = await onnxRuntime.autotuneSession(
+        'model.onnx',
+        {'images': input},
+        budget: const Duration(seconds: 4),
+        objective: OrtTuningObjective.throughput,
+        options: OrtSessionOptions(providers: [OrtProvider.CPU]),
+      );
+
+      expect(mockPlatform.lastAutotune, [
+        'model.onnx',
+        ['images'],
+        4000,
+        'throughput',
+        {
+          'providers': ['CPU'],
+        },
+      ]);
+      expect(result.best.intraOpNumThreads, 4);
+      expect(result.best.parallelExecution, false);
+      expect(result.best.latencyMs, 2.5);
+      expect(result.candidates.length, 2);
+      expect(result.candidates[0].intraOpNumThreads, 1);
+      expect(result.candidates[0].runsPerSecond, 125.0);
+    });
+
+    test('configureModelCache passes the budget and getModelCacheStats parses the counters', () async {
+      await onnxRuntime.configureModelCache(budgetBytes: 4096);
+      final stats = await onnxRuntime.getModelCacheStats();
+
+      expect(mockPlatform.lastModelCacheBudget, 4096);
+      expect(stats.models, 2);
+      expect(stats.idleModels, 1);
+      expect(stats.bytes, 3000);
+      expect(stats.budgetBytes, 4096);
+      expect(stats.sharedLoads, 5);
+    });
+  });
+
+  group('Memory stats', () {
+    test('getMemoryStats parses tensor and session figures', () async {
+      final stats = await onnxRuntime.getMemoryStats();
+
+      expect(stats.tensors.count, 3);
+      expect(stats.tensors.bytes, 1200);
+      expect(stats.peakTensors.count, 5);
+      expect(stats.peakTensors.bytes, 2000);
+      expect(stats.tensorsByType['float32']!.bytes, 1192);
+      expect(stats.tensorsByOrigin['output']!.count, 2);
+      expect(stats.sessions['session_1']!.modelBytes, 3000);
+      expect(stats.sessions['session_1']!.stateBytes, 64);
+      expect(stats.sessions['session_1']!.allocator, {'InUse': 4096, 'MaxInUse': 8192});
+      expect(stats.sessions['session_2']!.allocator, isNull);
+      expect(stats.tensorBudgetBytes, 4096);
+      expect(stats.tensorSoftLimitBytes, 1024);
+      expect(stats.evictions, 7);
+    });
+
+    test('configureTensorBudget passes both limits, soft limit off by default', () async {
+      await onnxRuntime.configureTensorBudget(budgetBytes: 4096, softLimitBytes: 1024);
+      expect(mockPlatform.lastTensorBudget, [4096, 1024]);
+
+      await onnxRuntime.configureTensorBudget(budgetBytes: 8192);
+      expect(mockPlatform.lastTensorBudget, [8192, 0]);
+    });
+
+    test('memoryWarnings only carries memory warning events', () async {
+      final warnings = onnxRuntime.memoryWarnings.take(1).toList();
+
+      mockPlatform.eventController.add({'event': 'generatedToken', 'token': 1});
+      mockPlatform.eventController.add({'event': 'memoryWarning', 'level': 'soft', 'bytes': 2048, 'limitBytes': 1024});
+
+      final received = await warnings;
+      expect(received.single.level, 'soft');
+      expect(received.single.bytes, 2048);
+      expect(received.single.limitBytes, 1024);
+    });
+
+    test('pin and unpin an OrtValue', () async {
+      final value = OrtValue.fromMap({
+        'valueId': 'tensor_001',
+        'dataType': 'float32',
+        'shape': [3],
+      });
+
+      await value.pin();
+      await value.unpin();
+
+      expect(mockPlatform.pinCalls, [
+        ['tensor_001', true],
+        ['tensor_001', false],
+      ]);
+    });
+  });
+
+  group('OrtScope', () {
+    test('release passes the values to keep and returns the released count', () async {
+      final scope = await OrtScope.begin();
+      final kept = OrtValue.fromMap({
+        'valueId': 'tensor_007',
+        'dataType': 'float32',
+        'shape': [3],
+      });
+
+      final released = await scope.release(keep: [kept]);
+
+      expect(scope.id, 'scope_1');
+      expect(released, 4);
+      expect(mockPlatform.releasedScopes, [
+        [
+          'scope_1',
+          ['tensor_007'],
+        ],
+      ]);
+    });
+
+    test('use releases the scope even when the body throws', () async {
+      expect(await OrtScope.use((scope) async => scope.id), 'scope_1');
+      await expectLater(OrtScope.use((scope) async => throw StateError('failed')), throwsStateError);
+
+      expect(mockPlatform.releasedScopes.map((call) => call[0]), ['scope_1', 'scope_2']);
+    });
+
+    test('only calls naming the scope pass its ID', () async {
+      final session = await onnxRuntime.createSession('test_model.onnx');
+      final input = OrtValue.fromMap({
+        'valueId': 'tensor_007',
+        'dataType': 'float32',
+        'shape': [3],
+      });
+
+      await OrtScope.use((scope) async {
+        await session.run({'input1': input});
+        expect(mockPlatform.lastRunScopeId, isNull);
+
+        await session.run({'input1': input}, scope: scope);
+        expect(mockPlatform.lastRunScopeId, scope.id);
+      });
+    });
+
+    test('begin passes the parent scope', () async {
+      final outer = await OrtScope.begin();
+      expect(mockPlatform.lastScopeParentId, isNull);
+
+      await OrtScope.begin(parent: outer);
+      expect(mockPlatform.lastScopeParentId, outer.id);
+    });
+  });
+
+  group('OrtLoraAdapter', () {
+    test('loads from a file or bytes and releases by ID', () async {
+      final legal = await OrtLoraAdapter.fromFile('adapters/legal.onnx_adapter');
+      expect(legal.id, 'lora_adapter_1');
+      expect(mockPlatform.lastAdapterPath, 'adapters/legal.onnx_adapter');
+      expect(mockPlatform.lastAdapterBytes, isNull);
+
+      final medical = await OrtLoraAdapter.fromBytes(Uint8List.fromList([1, 2, 3]));
+      expect(medical.id, 'lora_adapter_2');
+      expect(mockPlatform.lastAdapterPath, isNull);
+      expect(mockPlatform.lastAdapterBytes, [1, 2, 3]);
+
+      await legal.release();
+      expect(mockPlatform.releasedAdapters, ['lora_adapter_1']);
+    });
+
+    test('run options pass adapters by ID', () async {
+      final legal = await OrtLoraAdapter.fromFile('adapters/legal.onnx_adapter');
+      expect(OrtRunOptions(loraAdapters: [legal]).toMap()['loraAdapters'], ['lora_adapter_1']);
+      expect(OrtRunOptions().toMap().containsKey('loraAdapters'), false);
+    });
   });
 
   group('OrtSession', () {
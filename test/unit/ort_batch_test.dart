@@ -0,0 +1,142 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:plugin_platform_interface/plugin_platform_interface.dart';
+
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
+  @override
+  Future<Map<String, dynamic>> createSession(String modelPath, {Map<String, dynamic>? sessionOptions}) {
+    return Future.value({
+      'sessionId': 'session_1',
+      'inputNames': ['images'],
+      'outputNames': ['scores', 'labels'],
+    });
+  }
+
+  // Track method calls for verification
+  List<Map<String, dynamic>>? lastOperations;
+  List<dynamic> batchResults = [];
+
+  @override
+  Future<List<dynamic>> executeBatch(List<Map<String, dynamic>> operations) {
+    lastOperations = operations;
+    return Future.value(batchResults);
+  }
+}
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  late MockFlutterOnnxruntimePlatform mockPlatform;
+  late OrtSession session;
+  final FlutterOnnxruntimePlatform initialPlatform = FlutterOnnxruntimePlatform.instance;
+
+  setUp(() async {
+    mockPlatform = MockFlutterOnnxruntimePlatform();
+    FlutterOnnxruntimePlatform.instance = mockPlatform;
+    session = await OnnxRuntime().createSession('model.onnx');
+  });
+
+  tearDown(() {
+    FlutterOnnxruntimePlatform.instance = initialPlatform;
+  });
+
+  group('OrtBatch', () {
+    test('a frame is sent as one list of operations with references', () async {
+      final batch = OrtBatch();
+      final input = batch.createOrtValue([1.5, 2.5], [1, 2]);
+      final outputs = batch.run(session, {'images': input});
+      final scores = batch.getData(outputs['scores']!);
+      batch.release(input);
+      batch.release(outputs['scores']!);
+      await batch.execute();
+
+      expect(batch.length, 5);
+      expect(scores.index, 2);
+      final operations = mockPlatform.lastOperations!;
+      expect(operations.map((operation) => operation['method']), [
+        'createOrtValue',
+        'runInference',
+        'getOrtValueData',
+        'releaseOrtValue',
+        'releaseOrtValue',
+      ]);
+      expect(operations[0]['args']['sourceType'], 'float32');
+      expect(operations[0]['args']['data'], isA<Float32List>());
+      expect(operations[1]['args'], {
+        'sessionId': 'session_1',
+        'inputs': {
+          'images': {
+            'valueId': {
+              '\$ref': 0,
+              'path': ['valueId'],
+            },
+          },
+        },
+        'runOptions': {},
+      });
+      expect(operations[2]['args'], {
+        'valueId': {
+          '\$ref': 1,
+          'path': ['scores', 0],
+        },
+      });
+      expect(operations[3]['args']['valueId'], {
+        '\$ref': 0,
+        'path': ['valueId'],
+      });
+    });
+
+    test('existing OrtValues are passed by ID', () async {
+      final value = OrtValue.fromMap({'valueId': 'value_7', 'dataType': 'float32', 'shape': [2]});
+      final batch = OrtBatch();
+      batch.run(session, {'images': value});
+      batch.add('pinOrtValue', {'valueId': value.id, 'pinned': true});
+      await batch.execute();
+
+      expect(mockPlatform.lastOperations![0]['args']['inputs'], {
+        'images': {'valueId': 'value_7'},
+      });
+      expect(mockPlatform.lastOperations![1], {
+        'method': 'pinOrtValue',
+        'args': {'valueId': 'value_7', 'pinned': true},
+      });
+    });
+
+    test('results resolve references', () async {
+      mockPlatform.batchResults = [
+        {'valueId': 'value_1', 'dataType': 'float32', 'shape': [1, 2]},
+        {
+          'scores': ['value_2', 'float32', [1, 3]],
+        },
+        {
+          'data': [0.1, 0.7, 0.2],
+          'shape': [1, 3],
+        },
+      ];
+      final batch = OrtBatch();
+      final input = batch.createOrtValue([1.0, 2.0], [1, 2]);
+      final outputs = batch.run(session, {'images': input});
+      final scores = batch.getData(outputs['scores']!);
+      final results = await batch.execute();
+
+      expect(results[input], 'value_1');
+      expect(results[outputs['scores']!], 'value_2');
+      expect(results[scores['data']], [0.1, 0.7, 0.2]);
+    });
+
+    test('createOrtValue validates data like OrtValue.fromList', () {
+      final batch = OrtBatch();
+      expect(() => batch.createOrtValue([1.0, 2.0, 3.0], [1, 2]), throwsArgumentError);
+      expect(batch.length, 0);
+    });
+  });
+}
@@ -0,0 +1,233 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:plugin_platform_interface/plugin_platform_interface.dart';
+
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
+  @override
+  Future<Map<String, dynamic>> createSession(String modelPath, {Map<String, dynamic>? sessionOptions}) {
+    return Future.value({
+      'sessionId': modelPath == 'detector.onnx' ? 'detector_session' : 'classifier_session',
+      'inputNames': ['images'],
+      'outputNames': ['boxes'],
+    });
+  }
+
+  // Track method calls for verification
+  List<Map<String, dynamic>>? lastStages;
+  List<Map<String, dynamic>>? lastEdges;
+  String? lastRunPipelineId;
+  Map<String, OrtValue>? lastPipelineInputs;
+  String? lastClosedPipelineId;
+  int? lastQueueCapacity;
+  final List<int> pushedFrameIds = [];
+  String? lastStoppedStreamId;
+  bool acceptFrames = true;
+
+  final StreamController<Map<String, dynamic>> eventController = StreamController<Map<String, dynamic>>.broadcast();
+
+  @override
+  Stream<Map<String, dynamic>> get events => eventController.stream;
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, List<Map<String, dynamic>> edges) {
+    lastStages = stages;
+    lastEdges = edges;
+    return Future.value({'pipelineId': 'pipeline_1'});
+  }
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(String pipelineId, Map<String, OrtValue> inputs, {String? scopeId}) {
+    lastRunPipelineId = pipelineId;
+    lastPipelineInputs = inputs;
+    return Future.value({
+      'classifier.scores': [
+        'output_value_1',
+        'float32',
+        [1, 10],
+      ],
+    });
+  }
+
+  @override
+  Future<void> closePipeline(String pipelineId) {
+    lastClosedPipelineId = pipelineId;
+    return Future.value();
+  }
+
+  @override
+  Future<Map<String, dynamic>> startPipelineStream(String pipelineId, {int queueCapacity = 2}) {
+    lastQueueCapacity = queueCapacity;
+    return Future.value({'streamId': 'stream_1'});
+  }
+
+  @override
+  Future<bool> pushPipelineFrame(String streamId, int frameId, Map<String, OrtValue> inputs) {
+    pushedFrameIds.add(frameId);
+    return Future.value(acceptFrames);
+  }
+
+  @override
+  Future<void> stopPipelineStream(String streamId) {
+    lastStoppedStreamId = streamId;
+    return Future.value();
+  }
+
+  @override
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) {
+    return Future.value({'valueId': 'input_value', 'dataType': sourceType, 'shape': shape});
+  }
+}
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  late MockFlutterOnnxruntimePlatform mockPlatform;
+  late OrtSession detector;
+  late OrtSession classifier;
+  final FlutterOnnxruntimePlatform initialPlatform = FlutterOnnxruntimePlatform.instance;
+
+  setUp(() async {
+    mockPlatform = MockFlutterOnnxruntimePlatform();
+    FlutterOnnxruntimePlatform.instance = mockPlatform;
+
+    final onnxRuntime = OnnxRuntime();
+    detector = await onnxRuntime.createSession('detector.onnx');
+    classifier = await onnxRuntime.createSession('classifier.onnx');
+  });
+
+  tearDown(() {
+    FlutterOnnxruntimePlatform.instance = initialPlatform;
+  });
+
+  group('OrtPipeline', () {
+    test('create sends stages in order and edges with glue ops', () async {
+      final pipeline = await OrtPipeline.create(
+        stages: {'detector': detector, 'classifier': classifier},
+        edges: [
+          OrtPipelineEdge(
+            from: 'detector.boxes',
+            to: 'classifier.images',
+            ops: [
+              OrtGlueOp.crop(starts: [0, 0, 10, 10], ends: [1, 3, 110, 110]),
+              OrtGlueOp.resize(height: 224, width: 224),
+              OrtGlueOp.cast(OrtDataType.float32),
+            ],
+          ),
+        ],
+      );
+
+      expect(pipeline.id, 'pipeline_1');
+      expect(mockPlatform.lastStages, [
+        {'name': 'detector', 'sessionId': 'detector_session'},
+        {'name': 'classifier', 'sessionId': 'classifier_session'},
+      ]);
+      expect(mockPlatform.lastEdges, [
+        {
+          'from': 'detector.boxes',
+          'to': 'classifier.images',
+          'ops': [
+            {
+              'op': 'crop',
+              'starts': [0, 0, 10, 10],
+              'ends': [1, 3, 110, 110],
+            },
+            {'op': 'resize', 'height': 224, 'width': 224},
+            {'op': 'cast', 'to': 'float32'},
+          ],
+        },
+      ]);
+    });
+
+    test('run returns the terminal outputs as OrtValues', () async {
+      final pipeline = await OrtPipeline.create(stages: {'detector': detector, 'classifier': classifier});
+      final input = await OrtValue.fromList([0.0, 1.0], [1, 2]);
+
+      final outputs = await pipeline.run({'detector.images': input});
+
+      expect(mockPlatform.lastRunPipelineId, 'pipeline_1');
+      expect(mockPlatform.lastPipelineInputs!['detector.images']!.id, 'input_value');
+      expect(outputs.keys, ['classifier.scores']);
+      expect(outputs['classifier.scores']!.dataType, OrtDataType.float32);
+      expect(outputs['classifier.scores']!.shape, [1, 10]);
+    });
+
+    test('close releases the pipeline', () async {
+      final pipeline = await OrtPipeline.create(stages: {'detector': detector});
+      await pipeline.close();
+
+      expect(mockPlatform.lastClosedPipelineId, 'pipeline_1');
+    });
+  });
+
+  group('OrtPipelineStream', () {
+    test('startStream double-buffers by default', () async {
+      final pipeline = await OrtPipeline.create(stages: {'detector': detector});
+      final stream = await pipeline.startStream();
+
+      expect(stream.id, 'stream_1');
+      expect(mockPlatform.lastQueueCapacity, 2);
+    });
+
+    test('push numbers frames and reports dropped ones', () async {
+      final pipeline = await OrtPipeline.create(stages: {'detector': detector});
+      final stream = await pipeline.startStream(queueCapacity: 4);
+      final input = await OrtValue.fromList([0.0, 1.0], [1, 2]);
+
+      expect(await stream.push({'detector.images': input}), isTrue);
+      expect(await stream.push({'detector.images': input}, frameId: 42), isTrue);
+      mockPlatform.acceptFrames = false;
+      expect(await stream.push({'detector.images': input}), isFalse);
+
+      expect(mockPlatform.lastQueueCapacity, 4);
+      expect(mockPlatform.pushedFrameIds, [0, 42, 1]);
+    });
+
+    test('results carry outputs of this stream and close after stop', () async {
+      final pipeline = await OrtPipeline.create(stages: {'detector': detector, 'classifier': classifier});
+      final stream = await pipeline.startStream();
+      final results = stream.results.toList();
+
+      mockPlatform.eventController.add({
+        'event': 'pipelineResult',
+        'streamId': 'stream_1',
+        'frameId': 0,
+        'outputs': {
+          'classifier.scores': [
+            'output_value_1',
+            'float32',
+            [1, 10],
+          ],
+        },
+      });
+      // Events of other streams are ignored
+      mockPlatform.eventController.add({'event': 'pipelineResult', 'streamId': 'stream_2', 'frameId': 7});
+      mockPlatform.eventController.add({
+        'event': 'pipelineResult',
+        'streamId': 'stream_1',
+        'frameId': 1,
+        'error': 'stage failed',
+      });
+
+      await stream.stop();
+      mockPlatform.eventController.add({'event': 'pipelineStreamClosed', 'streamId': 'stream_1'});
+
+      final received = await results;
+      expect(mockPlatform.lastStoppedStreamId, 'stream_1');
+      expect(received.map((result) => result.frameId), [0, 1]);
+      expect(received[0].outputs['classifier.scores']!.id, 'output_value_1');
+      expect(received[0].outputs['classifier.scores']!.shape, [1, 10]);
+      expect(received[0].error, isNull);
+      expect(received[1].outputs, isEmpty);
+      expect(received[1].error, 'stage failed');
+    });
+  });
+}
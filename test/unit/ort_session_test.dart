@@ -4,12 +4,14 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
-class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements FlutterOnnxruntimePlatform {
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
   @override
   Future<String?> getPlatformVersion() => Future.value('42');
 
@@ -26,12 +28,15 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   String? lastSessionIdForRun;
   Map<String, dynamic>? lastInputsForRun;
   Map<String, dynamic>? lastRunOptions;
+  List<String>? lastOutputNames;
 
   @override
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     // Track the invocation for verification
     lastSessionIdForRun = sessionId;
@@ -39,6 +44,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
       for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id},
     };
     lastRunOptions = runOptions;
+    lastOutputNames = outputNames;
 
     // Return mock output - simulate the new output format with OrtValue properties
     return Future.value({
@@ -55,6 +61,112 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     });
   }
 
+  // Track runMany calls
+  List<String>? lastRunManySessionIds;
+  Map<String, OrtValue>? lastRunManyInputs;
+
+  @override
+  Future<List<Map<String, dynamic>>> runMany(
+    List<String> sessionIds,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+    String? scopeId,
+  }) {
+    lastRunManySessionIds = sessionIds;
+    lastRunManyInputs = inputs;
+    lastRunOptions = runOptions;
+    return Future.value([
+      for (final sessionId in sessionIds)
+        {
+          'output1': [
+            '${sessionId}_output',
+            'float32',
+            [1, 2],
+          ],
+        },
+    ]);
+  }
+
+  // Track runWithData calls
+  Map<String, Map<String, dynamic>>? lastRunWithDataInputs;
+  List<String>? lastRunWithDataOutputNames;
+
+  @override
+  Future<Map<String, Map<String, dynamic>>> runWithData(
+    String sessionId,
+    Map<String, Map<String, dynamic>> inputs, {
+    List<String>? outputNames,
+    Map<String, dynamic>? runOptions,
+  }) {
+    lastSessionIdForRun = sessionId;
+    lastRunWithDataInputs = inputs;
+    lastRunWithDataOutputNames = outputNames;
+    lastRunOptions = runOptions;
+    return Future.value({
+      'output1': {
+        'dataType': 'float32',
+        'shape': [1, 2],
+        'data': Float32List.fromList([0.25, 0.75]),
+      },
+    });
+  }
+
+  // Track result cache calls
+  List<Object>? lastResultCacheConfig;
+  List<Object?>? lastReload;
+
+  @override
+  Future<Map<String, dynamic>> reloadSession(
+    String sessionId,
+    String modelPath, {
+    Map<String, dynamic>? sessionOptions,
+    bool warmUp = true,
+  }) {
+    lastReload = [sessionId, modelPath, sessionOptions, warmUp];
+    return Future.value({
+      'sessionId': sessionId,
+      'inputNames': ['input1', 'input2'],
+      'outputNames': ['output1', 'output2'],
+    });
+  }
+
+  @override
+  Future<void> configureResultCache(String sessionId, int maxEntries, int maxBytes) {
+    lastResultCacheConfig = [sessionId, maxEntries, maxBytes];
+    return Future.value();
+  }
+
+  // Track bucketing calls
+  List<Object?>? lastBucketing;
+
+  @override
+  Future<void> configureBucketing(String sessionId, String dimension, List<int> buckets, {String? maskInput}) {
+    lastBucketing = [sessionId, dimension, buckets, maskInput];
+    return Future.value();
+  }
+
+  // Track input casting calls
+  List<Object?>? lastInputCasting;
+
+  @override
+  Future<void> setInputCasting(String sessionId, bool enabled) {
+    lastInputCasting = [sessionId, enabled];
+    return Future.value();
+  }
+
+  @override
+  Future<Map<String, dynamic>> getResultCacheStats(String sessionId) {
+    return Future.value({
+      'hits': 3,
+      'misses': 1,
+      'evictions': 0,
+      'entries': 1,
+      'bytes': 40,
+      'maxEntries': 16,
+      'maxBytes': 1024,
+    });
+  }
+
   // Track session close calls
   String? lastClosedSessionId;
 
@@ -64,6 +176,44 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     return Future.value();
   }
 
+  // Track state binding calls
+  String? lastStateSessionId;
+  Map<String, String>? lastStateBindings;
+  String? lastResetStateSessionId;
+
+  @override
+  Future<void> setStateBindings(String sessionId, Map<String, String> bindings) {
+    lastStateSessionId = sessionId;
+    lastStateBindings = bindings;
+    return Future.value();
+  }
+
+  @override
+  Future<void> resetState(String sessionId) {
+    lastResetStateSessionId = sessionId;
+    return Future.value();
+  }
+
+  // Track constant input calls
+  final Map<String, String?> constantInputs = {};
+
+  @override
+  Future<void> setConstantInput(String sessionId, String name, String? valueId) {
+    constantInputs[name] = valueId;
+    return Future.value();
+  }
+
+  // Track generate calls
+  List<int>? lastPromptIds;
+  Map<String, dynamic>? lastGenerationConfig;
+
+  @override
+  Stream<int> generate(String sessionId, List<int> promptIds, {Map<String, dynamic>? config}) {
+    lastPromptIds = promptIds;
+    lastGenerationConfig = config;
+    return Stream.fromIterable([7, 8, 9]);
+  }
+
   @override
   Future<List<Map<String, dynamic>>> getInputInfo(String sessionId) {
     return Future.value([
@@ -109,12 +259,13 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) {
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) {
     return Future.value({'valueId': 'test_value_id', 'dataType': sourceType, 'shape': shape});
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) => Future.value({});
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) =>
+      Future.value({});
 
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) => Future.value({
@@ -163,6 +314,8 @@ class CustomDataMockFlutterOnnxruntimePlatform extends MockFlutterOnnxruntimePla
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     return Future.value({
       'output1': [
@@ -180,6 +333,86 @@ class CustomDataMockFlutterOnnxruntimePlatform extends MockFlutterOnnxruntimePla
 }
 
 // Add this class outside the test function, at the top level or before the test group
+// Sends the introspection along with the session, as Linux does
+class IntrospectionMock extends MockFlutterOnnxruntimePlatform {
+  @override
+  Future<Map<String, dynamic>> createSession(String modelPath, {Map<String, dynamic>? sessionOptions}) {
+    return Future.value({
+      'sessionId': 'test_session_id',
+      'inputNames': ['input1'],
+      'outputNames': ['output1'],
+      'inputInfo': [
+        {
+          'name': 'input1',
+          'type': 'FLOAT',
+          'shape': [1, -1],
+        },
+      ],
+      'outputInfo': [
+        {
+          'name': 'output1',
+          'type': 'INT64',
+          'shape': [1],
+        },
+      ],
+      'metadata': {
+        'producerName': 'exporter',
+        'graphName': 'graph',
+        'domain': '',
+        'description': '',
+        'version': 3,
+        'customMetadataMap': {'labels': 'cat,dog'},
+      },
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> reloadSession(
+    String sessionId,
+    String modelPath, {
+    Map<String, dynamic>? sessionOptions,
+    bool warmUp = true,
+  }) {
+    return Future.value({
+      'sessionId': sessionId,
+      'inputNames': ['tokens'],
+      'outputNames': ['logits'],
+      'inputInfo': [
+        {
+          'name': 'tokens',
+          'type': 'INT64',
+          'shape': [1, -1],
+        },
+      ],
+      'outputInfo': [
+        {
+          'name': 'logits',
+          'type': 'FLOAT',
+          'shape': [1, -1, 8],
+        },
+      ],
+      'metadata': {
+        'producerName': 'exporter',
+        'graphName': 'graph',
+        'domain': '',
+        'description': '',
+        'version': 4,
+        'customMetadataMap': <String, String>{},
+      },
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> getMetadata(String sessionId) => throw StateError('metadata was not cached');
+
+  @override
+  Future<List<Map<String, dynamic>>> getInputInfo(String sessionId) => throw StateError('input info was not cached');
+
+  @override
+  Future<List<Map<String, dynamic>>> getOutputInfo(String sessionId) =>
+      throw StateError('output info was not cached');
+}
+
 class SessionOptionsMock extends MockFlutterOnnxruntimePlatform {
   Map<String, dynamic>? capturedOptions;
 
@@ -201,6 +434,8 @@ class InferenceOutputsMock extends MockFlutterOnnxruntimePlatform {
     String sessionId,
     Map<String, dynamic> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     // Track the call
     lastInputsForRun = {};
@@ -312,6 +547,20 @@ void main() {
       expect(mockPlatform.lastRunOptions, runOptions.toMap());
     });
 
+    test('run fetches all outputs unless outputNames is given', () async {
+      final input = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+
+      await session.run({'input1': input});
+      expect(mockPlatform.lastOutputNames, isNull);
+
+      await session.run({'input1': input}, outputNames: ['output2']);
+      expect(mockPlatform.lastOutputNames, ['output2']);
+    });
+
     test('run returns OrtValue outputs in new format', () async {
       // Create a mock OrtValue
       final ortValue = OrtValue.fromMap({
@@ -479,6 +728,126 @@ void main() {
     });
   });
 
+  group('OrtSession runMany method', () {
+    test('runMany sends all sessions with the shared inputs and returns outputs in session order', () async {
+      final other = OrtSession.fromMap({
+        'sessionId': 'other_session_id',
+        'inputNames': ['input1'],
+        'outputNames': ['output1'],
+      });
+      final input = OrtValue.fromMap({
+        'valueId': 'shared_value',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+      final runOptions = OrtRunOptions(logSeverityLevel: 2);
+
+      final results = await OrtSession.runMany([session, other], {'input1': input}, options: runOptions);
+
+      expect(mockPlatform.lastRunManySessionIds, ['test_session_id', 'other_session_id']);
+      expect(mockPlatform.lastRunManyInputs!['input1']!.id, 'shared_value');
+      expect(mockPlatform.lastRunOptions, runOptions.toMap());
+      expect(results.length, 2);
+      expect(results[0]['output1']!.id, 'test_session_id_output');
+      expect(results[1]['output1']!.id, 'other_session_id_output');
+      expect(results[1]['output1']!.shape, [1, 2]);
+    });
+  });
+
+  group('OrtSession runWithData method', () {
+    test('runWithData sends raw inputs and returns output data', () async {
+      final outputs = await session.runWithData(
+        {
+          'input1': OrtTensorData([1.0, 2.0, 3.0], [1, 3]),
+          'input2': OrtTensorData(Int64List.fromList([7]), [1]),
+        },
+        outputNames: ['output1'],
+      );
+
+      expect(mockPlatform.lastSessionIdForRun, 'test_session_id');
+      expect(mockPlatform.lastRunWithDataOutputNames, ['output1']);
+      final inputs = mockPlatform.lastRunWithDataInputs!;
+      expect(inputs['input1']!['dataType'], 'float32');
+      expect(inputs['input1']!['shape'], [1, 3]);
+      expect(inputs['input1']!['data'], isA<Float32List>());
+      expect(inputs['input2']!['dataType'], 'int64');
+      expect(inputs['input2']!['data'], [7]);
+
+      expect(outputs.keys, ['output1']);
+      expect(outputs['output1']!.dataType, OrtDataType.float32);
+      expect(outputs['output1']!.shape, [1, 2]);
+      expect(outputs['output1']!.data, [0.25, 0.75]);
+    });
+
+    test('OrtTensorData rejects data that does not match the shape', () {
+      expect(() => OrtTensorData([1.0, 2.0], [3]), throwsArgumentError);
+    });
+  });
+
+  group('OrtSession result cache', () {
+    test('enableResultCache and disableResultCache configure the native cache', () async {
+      await session.enableResultCache(maxEntries: 8, maxBytes: 1024);
+      expect(mockPlatform.lastResultCacheConfig, ['test_session_id', 8, 1024]);
+
+      await session.disableResultCache();
+      expect(mockPlatform.lastResultCacheConfig, ['test_session_id', 0, 0]);
+    });
+
+    test('getResultCacheStats parses the counters', () async {
+      final stats = await session.getResultCacheStats();
+
+      expect(stats.hits, 3);
+      expect(stats.misses, 1);
+      expect(stats.entries, 1);
+      expect(stats.bytes, 40);
+      expect(stats.maxEntries, 16);
+      expect(stats.hitRate, 0.75);
+    });
+  });
+
+  group('OrtSession bucketing', () {
+    test('enableBucketing and disableBucketing configure native padding', () async {
+      await session.enableBucketing(dimension: 'seq_len', buckets: [32, 64, 128], maskInput: 'attention_mask');
+      expect(mockPlatform.lastBucketing, [
+        'test_session_id',
+        'seq_len',
+        [32, 64, 128],
+        'attention_mask',
+      ]);
+
+      await session.disableBucketing();
+      expect(mockPlatform.lastBucketing, ['test_session_id', '', [], null]);
+    });
+  });
+
+  group('OrtSession input casting', () {
+    test('setInputCasting toggles native conversion of inputs', () async {
+      await session.setInputCasting(true);
+      expect(mockPlatform.lastInputCasting, ['test_session_id', true]);
+
+      await session.setInputCasting(false);
+      expect(mockPlatform.lastInputCasting, ['test_session_id', false]);
+    });
+  });
+
+  group('OrtSession reload', () {
+    test('reload keeps the session ID and picks up the new model names', () async {
+      final reloaded = await session.reload('model_v2.onnx');
+
+      expect(mockPlatform.lastReload, ['test_session_id', 'model_v2.onnx', <String, dynamic>{}, true]);
+      expect(reloaded.id, 'test_session_id');
+      expect(reloaded.inputNames, ['input1', 'input2']);
+      expect(reloaded.outputNames, ['output1', 'output2']);
+    });
+
+    test('reload passes options and can skip the warm-up', () async {
+      final options = OrtSessionOptions(intraOpNumThreads: 2);
+      await session.reload('model_v2.onnx', options: options, warmUp: false);
+
+      expect(mockPlatform.lastReload, ['test_session_id', 'model_v2.onnx', options.toMap(), false]);
+    });
+  });
+
   group('OrtSession close method', () {
     test('close calls platform implementation with correct session ID', () async {
       await session.close();
@@ -487,6 +856,46 @@ void main() {
     });
   });
 
+  group('OrtSession state methods', () {
+    test('setStateBindings passes the output to input mapping to platform', () async {
+      await session.setStateBindings({'output1': 'input2'});
+
+      expect(mockPlatform.lastStateSessionId, 'test_session_id');
+      expect(mockPlatform.lastStateBindings, {'output1': 'input2'});
+    });
+
+    test('resetState calls platform implementation with correct session ID', () async {
+      await session.resetState();
+
+      expect(mockPlatform.lastResetStateSessionId, 'test_session_id');
+    });
+
+    test('setConstantInput passes the value ID and null to remove', () async {
+      final mask = OrtValue.fromMap({'valueId': 'mask_value', 'dataType': 'int64', 'shape': [1, 8]});
+      await session.setConstantInput('attention_mask', mask);
+      expect(mockPlatform.constantInputs, {'attention_mask': 'mask_value'});
+
+      await session.setConstantInput('attention_mask', null);
+      expect(mockPlatform.constantInputs, {'attention_mask': null});
+    });
+  });
+
+  group('OrtSession generate method', () {
+    test('generate passes prompt and config to platform and streams tokens', () async {
+      final config = OrtGenerationConfig(maxLength: 16, stopTokens: [2], temperature: 0.7, topK: 40);
+      final tokens = await session.generate([1, 2, 3], config: config).toList();
+
+      expect(tokens, [7, 8, 9]);
+      expect(mockPlatform.lastPromptIds, [1, 2, 3]);
+      expect(mockPlatform.lastGenerationConfig, {
+        'maxLength': 16,
+        'stopTokens': [2],
+        'temperature': 0.7,
+        'topK': 40,
+      });
+    });
+  });
+
   group('OrtSession metadata methods', () {
     test('getMetadata returns properly structured metadata', () async {
       final metadata = await session.getMetadata();
@@ -519,6 +928,35 @@ void main() {
       expect(outputInfo[0]['type'], 'FLOAT');
       expect(outputInfo[0]['shape'], [1, 1000]);
     });
+
+    test('introspection sent with the session is used without platform calls', () async {
+      FlutterOnnxruntimePlatform.instance = IntrospectionMock();
+      final session = await OnnxRuntime().createSession('model.onnx');
+
+      final metadata = await session.getMetadata();
+      expect(metadata.version, 3);
+      expect(metadata.customMetadataMap, {'labels': 'cat,dog'});
+      expect((await session.getInputInfo()).single, {
+        'name': 'input1',
+        'type': 'FLOAT',
+        'shape': [1, -1],
+      });
+      expect((await session.getOutputInfo()).single['type'], 'INT64');
+    });
+
+    test('reload updates the introspection of the same session object', () async {
+      FlutterOnnxruntimePlatform.instance = IntrospectionMock();
+      final session = await OnnxRuntime().createSession('model.onnx');
+
+      final reloaded = await session.reload('model_v2.onnx');
+
+      expect(identical(reloaded, session), isTrue);
+      expect(session.inputNames, ['tokens']);
+      expect(session.outputNames, ['logits']);
+      expect((await session.getInputInfo()).single['type'], 'INT64');
+      expect((await session.getOutputInfo()).single['shape'], [1, -1, 8]);
+      expect((await session.getMetadata()).version, 4);
+    });
   });
 
   group('OrtSessionOptions', () {
@@ -561,6 +999,47 @@ void main() {
       expect(map.containsKey('providers'), false);
     });
 
+    test('free dimension overrides and shape variants are included in map', () {
+      final options = OrtSessionOptions(
+        freeDimensionOverrides: {'batch': 1},
+        freeDimensionOverridesByDenotation: {'DATA_BATCH': 1},
+        shapeVariants: [
+          {'seq_len': 128},
+          {'seq_len': 512},
+        ],
+      );
+
+      final map = options.toMap();
+
+      expect(map['freeDimensionOverrides'], {'batch': 1});
+      expect(map['freeDimensionOverridesByDenotation'], {'DATA_BATCH': 1});
+      expect(map['shapeVariants'], [
+        {'seq_len': 128},
+        {'seq_len': 512},
+      ]);
+      expect(OrtSessionOptions().toMap().containsKey('shapeVariants'), false);
+    });
+
+    test('useTunedOptions is included in map when set', () {
+      expect(OrtSessionOptions(useTunedOptions: true).toMap()['useTunedOptions'], true);
+      expect(OrtSessionOptions().toMap().containsKey('useTunedOptions'), false);
+    });
+
+    test('providerOptions are keyed by provider name', () {
+      final options = OrtSessionOptions(
+        providers: [OrtProvider.XNNPACK, OrtProvider.CPU],
+        providerOptions: {
+          OrtProvider.XNNPACK: {'intra_op_num_threads': '4'},
+          OrtProvider.DNNL: {'use_arena': true},
+        },
+      );
+      expect(options.toMap()['providerOptions'], {
+        'XNNPACK': {'intra_op_num_threads': '4'},
+        'DNNL': {'use_arena': true},
+      });
+      expect(OrtSessionOptions().toMap().containsKey('providerOptions'), false);
+    });
+
     test('options affect session creation', () async {
       // Create a specialized tracking mock platform
       final optionsMock = SessionOptionsMock();
@@ -11,7 +11,7 @@ import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
-class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements FlutterOnnxruntimePlatform {
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
   // Store values for assertions
   Map<String, dynamic>? lastRunInputs;
 
@@ -32,6 +32,8 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     // Store the inputs for later assertions
     lastRunInputs = {
@@ -54,7 +56,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) {
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) {
     // Return a mock OrtValue map
     return Future.value({
       'valueId': 'test_value_id_${DateTime.now().millisecondsSinceEpoch}',
@@ -106,7 +108,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) {
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) {
     return Future.value({
       'valueId': valueId,
       'dataType': targetType,
@@ -134,7 +136,7 @@ class ConversionTrackingMock extends MockFlutterOnnxruntimePlatform {
   String? lastConvertedTargetType;
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) {
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) {
     // Track the conversion operation for assertion
     lastConvertedValueId = valueId;
     lastConvertedTargetType = targetType;
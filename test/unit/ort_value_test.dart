@@ -11,7 +11,7 @@ import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
-class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements FlutterOnnxruntimePlatform {
+class MockFlutterOnnxruntimePlatform extends FlutterOnnxruntimePlatform with MockPlatformInterfaceMixin {
   // Tracks method calls for verification
   String? lastSourceType;
   dynamic lastSourceData;
@@ -37,6 +37,8 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     String sessionId,
     Map<String, dynamic> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+    String? scopeId,
   }) {
     return Future.value({
       'outputs': {
@@ -47,7 +49,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) {
+  Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape, {String? scopeId}) {
     // Track the call parameters
     lastSourceType = sourceType;
     lastSourceData = data;
@@ -64,7 +66,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   }
 
   @override
-  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) {
+  Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType, {String? scopeId}) {
     // Track the call
     lastValueIdForConversion = valueId;
 